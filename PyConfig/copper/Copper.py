@@ -39,11 +39,191 @@ class Logger(openwns.logger.Logger):
 class Wire(Sealed):
     name = None
     logger = None
+    channels = None # number of independent channels
+    slotDuration = None # in s, 0.0 means not slotted
+    tdma = None # TDMASchedule or None
+    probePrefix = None # e.g. 'copper.wire', probes are written at shutdown
+    trace = None # WireTrace or None
+    chromeTrace = None # ChromeTrace or None
+    pcap = None # PcapCapture or None
+    busyHistory = None # busy periods kept per channel for carrier state queries
 
-    def __init__(self, name):
+    def __init__(self, name, channels = 1, slotDuration = 0.0, tdma = None, probePrefix = None, trace = None, chromeTrace = None, pcap = None, busyHistory = 16):
         super(Wire, self).__init__()
         self.name = name
         self.logger = Logger(name, True)
+        self.channels = channels
+        self.slotDuration = slotDuration
+        self.tdma = tdma
+        self.probePrefix = probePrefix
+        self.trace = trace
+        self.chromeTrace = chromeTrace
+        self.pcap = pcap
+        self.busyHistory = busyHistory
+        if self.tdma is not None:
+            self.tdma.logger = Logger("TDMA", True, self.logger)
+
+        assert(self.slotDuration >= 0.0)
+        assert(self.busyHistory > 0)
+
+
+class WireTrace(Sealed):
+    """Binary trace of the wire activity (see copper/WireTraceDecoder.py)
+
+    Records of 32 Bytes are written to a memory mapped file which holds
+    capacity records. In ring mode the oldest records are overwritten,
+    otherwise further segments fileName.1, fileName.2, ... are written.
+    flushInterval > 0 triggers an asynchronous write back every
+    flushInterval records.
+    """
+    fileName = None
+    capacity = None # records per file
+    ring = None
+    enabled = None # may be switched at runtime
+    flushInterval = None
+
+    def __init__(self, fileName, capacity = 1048576, ring = False, enabled = True, flushInterval = 0):
+        super(WireTrace, self).__init__()
+        self.fileName = fileName
+        self.capacity = capacity
+        self.ring = ring
+        self.enabled = enabled
+        self.flushInterval = flushInterval
+
+        assert(self.capacity > 0)
+        assert(self.flushInterval >= 0)
+
+
+class ChromeTrace(Sealed):
+    """Wire activity as Chrome trace event JSON (open in Perfetto)
+
+    Busy periods per channel, transmissions per sender, collisions and
+    deliveries per receiver are streamed to fileName through a buffer of
+    bufferSize Bytes. Each wire needs its own file. Broadcast deliveries
+    produce one event per receiver and may be switched off.
+    """
+    fileName = None
+    deliveries = None
+    bufferSize = None # in Bytes
+
+    def __init__(self, fileName, deliveries = True, bufferSize = 65536):
+        super(ChromeTrace, self).__init__()
+        self.fileName = fileName
+        self.deliveries = deliveries
+        self.bufferSize = bufferSize
+
+        assert(self.bufferSize >= 0)
+
+
+class PcapCapture(Sealed):
+    """Completed transmissions of the wire as pcap file (LINKTYPE_USER0)
+
+    Each packet starts with a 24 Byte pseudo header (host byte order):
+    wire, sender, target (MAC address, group or -1 for broadcast), length
+    in Bit (uint32), channel (uint16), collision flag, number of PDUs and
+    type (0 unicast, 1 broadcast, 2 multicast) (uint8), 3 reserved Bytes.
+    If payload is True the content of PDUs implementing
+    copper::PcapSerializable follows, truncated to the length of the
+    transmission and to snapLength. Packets
+    are written through a buffer of bufferSize Bytes. Each wire needs its
+    own file.
+    """
+    fileName = None
+    payload = None
+    snapLength = None # in Bytes, including the pseudo header
+    bufferSize = None # in Bytes
+
+    def __init__(self, fileName, payload = False, snapLength = 65535, bufferSize = 1048576):
+        super(PcapCapture, self).__init__()
+        self.fileName = fileName
+        self.payload = payload
+        self.snapLength = snapLength
+        self.bufferSize = bufferSize
+
+        assert(self.snapLength >= 24)
+        assert(self.bufferSize >= 0)
+
+
+class TDMASchedule(Sealed):
+    """Precomputed TDMA schedule executed by the Wire
+
+    slots holds the station id (see Transmitter.tdmaStation) of each slot
+    of the TDMA frame. The frame is repeated periodically. Unused slots
+    are marked with -1.
+    """
+    logger = None
+    slotDuration = None # in s
+    slots = None
+
+    def __init__(self, slotDuration, slots):
+        super(TDMASchedule, self).__init__()
+        self.logger = Logger("TDMA", True)
+        self.slotDuration = slotDuration
+        self.slots = list(slots)
+
+        assert(self.slotDuration > 0.0)
+        assert(len(self.slots) > 0)
+
+
+class CSMACD(Sealed):
+    """CSMA/CD with binary exponential backoff
+
+    After the n-th collision of a PDU the transmitter waits a random number
+    of slots drawn uniformly from [0, 2^min(n, maxBackoffExponent) - 1]. The
+    PDU is dropped after maxAttempts attempts.
+    """
+    slotTime = None # in s
+    maxAttempts = None
+    maxBackoffExponent = None
+
+    def __init__(self, slotTime, maxAttempts = 16, maxBackoffExponent = 10):
+        super(CSMACD, self).__init__()
+        self.slotTime = slotTime
+        self.maxAttempts = maxAttempts
+        self.maxBackoffExponent = maxBackoffExponent
+
+        assert(self.slotTime > 0.0)
+        assert(self.maxAttempts > 0)
+        assert(0 <= self.maxBackoffExponent < 32)
+
+
+class LatencyHistogram(Sealed):
+    """Log-linear histogram of delays with fixed memory
+
+    Values up to maxValue are recorded with a relative error of at most
+    2^(1 - precisionBits), values below 2^precisionBits * resolution are
+    recorded exactly (in units of the resolution).
+    """
+    resolution = None # in s
+    maxValue = None # in s
+    precisionBits = None
+
+    def __init__(self, resolution = 1E-9, maxValue = 1E3, precisionBits = 7):
+        super(LatencyHistogram, self).__init__()
+        self.resolution = resolution
+        self.maxValue = maxValue
+        self.precisionBits = precisionBits
+
+        assert(0.0 < self.resolution <= self.maxValue)
+        assert(1 <= self.precisionBits <= 16)
+
+
+class TransmitQueue(Sealed):
+    """Bounded transmit queue of the Transmitter
+
+    Each of the priority classes (0 is the highest priority) holds at most
+    capacity PDUs, further PDUs are dropped.
+    """
+    priorities = None
+    capacity = None
+
+    def __init__(self, priorities = 1, capacity = 100):
+        super(TransmitQueue, self).__init__()
+        self.priorities = priorities
+        self.capacity = capacity
+
+        assert(self.priorities > 0)
+        assert(self.capacity > 0)
 
 
 class Transceiver(openwns.node.Component):
@@ -56,17 +236,163 @@ class Transceiver(openwns.node.Component):
     dataTransmissionFeedback = None
     notification = None
 
-    def __init__(self, node, name, wire, ber, dataRate, sensingTime = 0.0):
+    def __init__(self, node, name, wire, ber, dataRate, sensingTime = 0.0, channel = 0, tdmaStation = None, csma = None, queue = None, delayHistogram = None, broadcast = True, groups = []):
         super(Transceiver, self).__init__(node, name)
         self.wire = wire
-        self.transmitter = Transmitter(dataRate, sensingTime, self.logger)
-        self.receiver = Receiver(ber, sensingTime, self.logger)
+        self.transmitter = Transmitter(dataRate, sensingTime, self.logger, channel, tdmaStation, csma, queue, delayHistogram)
+        self.receiver = Receiver(ber, sensingTime, self.logger, channel, broadcast, groups)
         self.dataTransmission = name + '.dataTransmission'
         self.dataTransmissionFeedback = name + '.dataTransmissionFeedback'
         self.notification = name + '.notification'
 
 
+class CBR(Sealed):
+    """One PDU every interArrivalTime"""
+    type = 'CBR'
+    interArrivalTime = None # in s
+
+    def __init__(self, interArrivalTime):
+        super(CBR, self).__init__()
+        self.interArrivalTime = interArrivalTime
+
+        assert(self.interArrivalTime > 0.0)
+
+
+class Poisson(Sealed):
+    """Exponentially distributed inter arrival times"""
+    type = 'Poisson'
+    interArrivalTime = None # mean, in s
+
+    def __init__(self, interArrivalTime):
+        super(Poisson, self).__init__()
+        self.interArrivalTime = interArrivalTime
+
+        assert(self.interArrivalTime > 0.0)
+
+
+class OnOff(Sealed):
+    """One PDU every interArrivalTime during on periods
+
+    The durations of the on and off periods are exponentially distributed.
+    Each on period begins with a PDU.
+    """
+    type = 'OnOff'
+    interArrivalTime = None # in s
+    meanOnTime = None # in s
+    meanOffTime = None # in s
+
+    def __init__(self, interArrivalTime, meanOnTime, meanOffTime):
+        super(OnOff, self).__init__()
+        self.interArrivalTime = interArrivalTime
+        self.meanOnTime = meanOnTime
+        self.meanOffTime = meanOffTime
+
+        assert(self.interArrivalTime > 0.0)
+        assert(self.meanOnTime > 0.0)
+        assert(self.meanOffTime >= 0.0)
+
+
+class TrafficSource(openwns.node.Component):
+    """Load generator on top of the DataTransmission service of a Transceiver
+
+    Sends PDUs of pduSize Bit to target (broadcast if None) according to
+    traffic (CBR, Poisson or OnOff), beginning at startTime. With poolSize >
+    0 the PDUs are preallocated and reused, the pool should be larger than
+    the number of PDUs the Transceiver may hold (queue capacity + 1). A PDU
+    of the pool that is still in use is not reused, a new one is allocated.
+    """
+    nameInComponentFactory = 'copper.TrafficSource'
+
+    dataTransmission = None
+    target = None # MAC address or None for broadcast
+    pduSize = None # in Bit
+    traffic = None # CBR, Poisson or OnOff
+    startTime = None # in s
+    poolSize = None # preallocated PDUs, 0 allocates a PDU per sendData
+
+    def __init__(self, node, name, transceiver, pduSize, traffic, target = None, startTime = 0.0, poolSize = 128):
+        super(TrafficSource, self).__init__(node, name)
+        self.dataTransmission = transceiver.dataTransmission
+        self.target = target
+        self.pduSize = pduSize
+        self.traffic = traffic
+        self.startTime = startTime
+        self.poolSize = poolSize
+
+        queue = transceiver.transmitter.queue
+        assert(self.pduSize > 0)
+        assert(self.startTime >= 0.0)
+        assert(self.poolSize >= 0)
+        assert(self.poolSize == 0 or queue is None or self.poolSize > queue.priorities * queue.capacity + 1)
+
+
+class TrafficSink(openwns.node.Component):
+    """Counts the PDUs delivered by a Transceiver
+
+    Sets the MAC address of the Transceiver. The latency of PDUs of a
+    TrafficSource is recorded if latencyHistogram is set. Lost and reordered
+    PDUs are counted per TrafficSource by their sequence numbers.
+    """
+    nameInComponentFactory = 'copper.TrafficSink'
+
+    notification = None
+    address = None
+    latencyHistogram = None # LatencyHistogram or None
+
+    def __init__(self, node, name, transceiver, address, latencyHistogram = None):
+        super(TrafficSink, self).__init__(node, name)
+        self.notification = transceiver.notification
+        self.address = address
+        self.latencyHistogram = latencyHistogram
+
+        assert(self.address > 0)
+
+
+class ScalingReport(Sealed):
+    """Wall time, startup time, events and peak RSS of a run
+
+    Written at shutdown as log message and (if fileName is not None) as
+    JSON file. See copper/ScalingScenario.py.
+    """
+    logger = None
+    fileName = None
+
+    def __init__(self, fileName = None):
+        super(ScalingReport, self).__init__()
+        self.logger = Logger("ScalingReport", True)
+        self.fileName = fileName
+
+
+class AsyncLog(Sealed):
+    """Writes the per-frame copper messages from a background thread
+
+    The messages are recorded as compact entries into a ring buffer of
+    'capacity' entries. If the ring is full the simulation either waits
+    for the writer ('block') or drops the message ('drop'), the number of
+    dropped messages is written at the end of the file. If configured the
+    per-frame messages are written independent of the logger settings.
+
+    The compile time level of the copper messages still applies: Release
+    builds (NDEBUG) strip all per-frame messages unless the library is built
+    with -DCOPPER_LOG_LEVEL=2 (frame) or 3 (detail).
+    """
+    fileName = None
+    capacity = None
+    policy = None
+
+    def __init__(self, fileName = 'copper.log', capacity = 65536, policy = 'block'):
+        super(AsyncLog, self).__init__()
+        self.fileName = fileName
+        self.capacity = capacity
+        self.policy = policy
+
+        assert(self.capacity > 0)
+        assert(self.policy in ['block', 'drop'])
+
+
 class Copper(Module):
+    scalingReport = None # ScalingReport or None
+    asyncLog = None # AsyncLog or None
 
     def __init__(self):
         super(Copper, self).__init__("copper", "copper")
@@ -76,24 +402,48 @@ class Transmitter(Sealed):
     logger = None
     dataRate = None # in Bit/s
     sensingTime = None # in s
+    channel = None
+    tdmaStation = None # station id in the wire's TDMASchedule or None
+    csma = None # CSMACD or None
+    queue = None # TransmitQueue or None (required by TDMA and CSMA/CD)
+    delayHistogram = None # LatencyHistogram or None, access delay (until the successful attempt starts) and latency are recorded
 
-    def __init__(self, dataRate, sensingTime, parentLogger):
+    def __init__(self, dataRate, sensingTime, parentLogger, channel = 0, tdmaStation = None, csma = None, queue = None, delayHistogram = None):
         super(Transmitter, self).__init__()
         self.logger = Logger("Transmitter", True, parentLogger)
         self.dataRate = dataRate
         self.sensingTime = sensingTime
+        self.channel = channel
+        self.tdmaStation = tdmaStation
+        self.csma = csma
+        self.queue = queue
+        self.delayHistogram = delayHistogram
+        if self.queue is None and (self.tdmaStation is not None or self.csma is not None):
+            self.queue = TransmitQueue()
 
         assert(self.dataRate >= 0.0)
         assert(self.sensingTime >= 0.0)
+        assert(self.channel >= 0)
+        assert(self.tdmaStation is None or self.csma is None)
 
 
 class Receiver(Sealed):
     logger = None
     ber = None
     sensingTime = None
+    channel = None
+    broadcast = None # False: broadcasts are not delivered by the wire
+    groups = None # multicast groups (see copper::MulticastTransmission)
 
-    def __init__(self, ber, sensingTime, parentLogger):
+    def __init__(self, ber, sensingTime, parentLogger, channel = 0, broadcast = True, groups = []):
         super(Receiver, self).__init__()
         self.logger = Logger("Receiver", True, parentLogger)
         self.ber = ber
         self.sensingTime = sensingTime
+        self.channel = channel
+        self.broadcast = broadcast
+        self.groups = list(groups)
+
+        assert(min(self.groups + [0]) >= 0)
+
+        assert(self.channel >= 0)
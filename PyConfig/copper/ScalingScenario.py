@@ -0,0 +1,106 @@
+###############################################################################
+# This file is part of openWNS (open Wireless Network Simulator)
+# _____________________________________________________________________________
+#
+# Copyright (C) 2004-2009
+# Chair of Communication Networks (ComNets)
+# Kopernikusstr. 5, D-52074 Aachen, Germany
+# phone: ++49-241-80-27910,
+# fax: ++49-241-80-22242
+# email: info@openwns.org
+# www: http://www.openwns.org
+# _____________________________________________________________________________
+#
+# openWNS is free software; you can redistribute it and/or modify it under the
+# terms of the GNU Lesser General Public License version 2 as published by the
+# Free Software Foundation;
+#
+# openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+# A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+# details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+
+"""Scaling benchmark of copper
+
+Builds numberOfNodes nodes, each with a copper.Transceiver, a
+copper.TrafficSource and a copper.TrafficSink, distributed round robin on numberOfWires wires. Each
+source sends unicast PDUs of pduSize Bit to the next node on its wire with
+constant bit rate, the offered load of each wire is load * dataRate. The
+sources start staggered over one inter arrival time, so the run is fully
+deterministic. At shutdown the copper.ScalingReport (startup time, wall
+time, model events, peak RSS) is written to reportFile.
+
+Usage in a simulation config (e.g. for 10k nodes on 10 wires):
+
+    import copper.ScalingScenario
+    copper.ScalingScenario.create(10000, numberOfWires = 10)
+
+or with one of the presets:
+
+    copper.ScalingScenario.create(*copper.ScalingScenario.presets['50k'])
+"""
+
+import openwns
+import openwns.node
+import openwns.distribution
+from copper.Copper import Wire, Transceiver, TrafficSource, TrafficSink, CBR, ScalingReport
+
+# (numberOfNodes, numberOfWires)
+presets = {
+    '1k' : (1000, 1),
+    '10k' : (10000, 10),
+    '50k' : (50000, 50),
+    '10k-single-wire' : (10000, 1),
+    '50k-single-wire' : (50000, 1),
+    }
+
+def create(numberOfNodes,
+           numberOfWires = 1,
+           dataRate = 1E9,
+           pduSize = 12000,
+           load = 0.5,
+           simTime = 1.0,
+           reportFile = 'copperScaling.json',
+           logging = False):
+    assert(numberOfNodes >= 2 * numberOfWires)
+    assert(0.0 < load)
+
+    sim = openwns.Simulator(simulationModel = openwns.node.NodeSimulationModel())
+    sim.maxSimTime = simTime
+    sim.modules.copper.scalingReport = ScalingReport(reportFile)
+
+    wires = [Wire('wire%d' % ii) for ii in xrange(numberOfWires)]
+    for wire in wires:
+        wire.logger.enabled = logging
+
+    for ii in xrange(numberOfNodes):
+        wireIndex = ii % numberOfWires
+        nodesOnWire = len(xrange(wireIndex, numberOfNodes, numberOfWires))
+        # each wire gets load * dataRate
+        interArrivalTime = nodesOnWire * pduSize / (load * dataRate)
+
+        # next node on the same wire (wraps around)
+        target = ii + numberOfWires
+        if target >= numberOfNodes:
+            target = wireIndex
+
+        node = openwns.node.Node('node%d' % ii)
+        transceiver = Transceiver(node, 'copper', wires[wireIndex], openwns.distribution.Fixed(0.0), dataRate)
+        source = TrafficSource(
+            node, 'traffic', transceiver,
+            pduSize = pduSize,
+            traffic = CBR(interArrivalTime),
+            target = target + 1,
+            startTime = interArrivalTime * (ii // numberOfWires) / nodesOnWire)
+        sink = TrafficSink(node, 'sink', transceiver, address = ii + 1)
+        for logger in [transceiver.logger, transceiver.transmitter.logger, transceiver.receiver.logger, source.logger, sink.logger]:
+            logger.enabled = logging
+        sim.simulationModel.nodes.append(node)
+
+    openwns.setSimulator(sim)
+    return sim
@@ -0,0 +1,81 @@
+###############################################################################
+# This file is part of openWNS (open Wireless Network Simulator)
+# _____________________________________________________________________________
+#
+# Copyright (C) 2004-2009
+# Chair of Communication Networks (ComNets)
+# Kopernikusstr. 5, D-52074 Aachen, Germany
+# phone: ++49-241-80-27910,
+# fax: ++49-241-80-22242
+# email: info@openwns.org
+# www: http://www.openwns.org
+# _____________________________________________________________________________
+#
+# openWNS is free software; you can redistribute it and/or modify it under the
+# terms of the GNU Lesser General Public License version 2 as published by the
+# Free Software Foundation;
+#
+# openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+# A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+# details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+###############################################################################
+
+"""Decoder of the binary wire trace written by copper::WireTrace
+
+Usage: python WireTraceDecoder.py trace.bin [trace.bin.1 ...]
+"""
+
+import struct
+import sys
+
+headerFormat = '<4sIIIQII'
+recordFormat = '<dIIIiIHBB'
+version = 1
+
+typeNames = ['unicast', 'broadcast', 'end', 'cancel', 'collision', 'multicast']
+
+
+def readRecords(fileName):
+    """Yields (time, wire, frame, sender, target, length, channel, type,
+    collision) tuples in chronological order"""
+    f = open(fileName, 'rb')
+    try:
+        headerSize = struct.calcsize(headerFormat)
+        recordSize = struct.calcsize(recordFormat)
+        (magic, fileVersion, fileRecordSize, capacity, written, segment, ring) = \
+            struct.unpack(headerFormat, f.read(headerSize))
+
+        if magic != b'CWTR' or fileVersion != version or fileRecordSize != recordSize:
+            raise ValueError("%s is not a wire trace (version %d)" % (fileName, version))
+
+        first = 0
+        count = written
+        if written > capacity:
+            first = written % capacity
+            count = capacity
+
+        for ii in range(count):
+            f.seek(headerSize + ((first + ii) % capacity) * recordSize)
+            yield struct.unpack(recordFormat, f.read(recordSize))
+    finally:
+        f.close()
+
+
+def decode(fileName, out = sys.stdout):
+    for (time, wire, frame, sender, target, length, channel, type, collision) in readRecords(fileName):
+        if type < len(typeNames):
+            typeName = typeNames[type]
+        else:
+            typeName = 'unknown'
+        out.write("%.9f wire=%d frame=%d %s sender=%d target=%d length=%d channel=%d collision=%d\n" %
+                  (time, wire, frame, typeName, sender, target, length, channel, collision))
+
+
+if __name__ == '__main__':
+    for fileName in sys.argv[1:]:
+        decode(fileName)
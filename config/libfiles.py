@@ -35,10 +35,39 @@ srcFiles = [
     'src/Receiver.cpp',
     'src/Wire.cpp',
     'src/Transmission.cpp',
+    'src/TDMAExecutor.cpp',
+    'src/TransmitQueue.cpp',
+    'src/LatencyHistogram.cpp',
+    'src/WireTrace.cpp',
+    'src/ChromeTrace.cpp',
+    'src/WireReplay.cpp',
+    'src/TrafficModel.cpp',
+    'src/TrafficSource.cpp',
+    'src/TrafficSink.cpp',
+    'src/ScalingReport.cpp',
+    'src/Profiling.cpp',
+    'src/AsyncLog.cpp',
+    'src/PcapCapture.cpp',
+    'src/BusyHistory.cpp',
 
     'src/tests/WireTest.cpp',
     'src/tests/ReceiverTest.cpp',
     'src/tests/TransmitterTest.cpp',
+    'src/tests/TDMAExecutorTest.cpp',
+    'src/tests/TransmitQueueTest.cpp',
+    'src/tests/LatencyHistogramTest.cpp',
+    'src/tests/WireTraceTest.cpp',
+    'src/tests/ChromeTraceTest.cpp',
+    'src/tests/WireReplayTest.cpp',
+    'src/tests/TrafficModelTest.cpp',
+    'src/tests/TrafficSourceTest.cpp',
+    'src/tests/ProfilingTest.cpp',
+    'src/tests/AsyncLogTest.cpp',
+    'src/tests/PcapCaptureTest.cpp',
+    'src/tests/BusyHistoryTest.cpp',
+    'src/tests/WirePerformanceTest.cpp',
+    'src/tests/ReceiverPerformanceTest.cpp',
+    'src/tests/LoggingPerformanceTest.cpp',
     ]
 
 hppFiles = [
@@ -46,18 +75,40 @@ hppFiles = [
     'src/ReceiverInterface.hpp',
     'src/tests/TransmitterDataSentMock.hpp',
     'src/tests/ReceiverMock.hpp',
+    'src/tests/BenchmarkReport.hpp',
     'src/Transceiver.hpp',
     'src/Transmitter.hpp',
     'src/Transmission.hpp',
     'src/Copper.hpp',
     'src/Wire.hpp',
+    'src/TDMAExecutor.hpp',
+    'src/TransmitQueue.hpp',
+    'src/LatencyHistogram.hpp',
+    'src/WireTrace.hpp',
+    'src/ChromeTrace.hpp',
+    'src/WireReplay.hpp',
+    'src/TrafficModel.hpp',
+    'src/TrafficPDU.hpp',
+    'src/TrafficSource.hpp',
+    'src/TrafficSink.hpp',
+    'src/ScalingReport.hpp',
+    'src/Profiling.hpp',
+    'src/Logging.hpp',
+    'src/AsyncLog.hpp',
+    'src/PcapCapture.hpp',
+    'src/WireTap.hpp',
+    'src/BusyHistory.hpp',
+    'src/BerPolicy.hpp',
 
     ]
 
 pyconfigs = [
 'copper/TimeDependentDistBER.py',
 'copper/Copper.py',
+'copper/WireTraceDecoder.py',
+'copper/ScalingScenario.py',
 'copper/__init__.py',
 ]
-dependencies = []
+# AsyncLog runs its writer in a POSIX thread
+dependencies = ['pthread']
 Return('libname srcFiles hppFiles pyconfigs dependencies')
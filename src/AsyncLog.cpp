@@ -0,0 +1,399 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#include <COPPER/AsyncLog.hpp>
+
+#include <WNS/events/scheduler/Interface.hpp>
+#include <WNS/Exception.hpp>
+
+#include <iomanip>
+#include <sstream>
+
+using namespace copper;
+
+AsyncLog* AsyncLog::active = NULL;
+
+AsyncLog::AsyncLog(const wns::pyconfig::View& config) :
+	file(),
+	policy(Block),
+	entries(NULL),
+	mask(0),
+	head(0),
+	dropped(0),
+	tail(0),
+	written(0),
+	running(false),
+	started(false),
+	writerWaiting(false),
+	producerWaiting(false)
+{
+	std::string p = config.get<std::string>("policy");
+	if (p == "block")
+	{
+		this->policy = Block;
+	}
+	else if (p == "drop")
+	{
+		this->policy = Drop;
+	}
+	else
+	{
+		throw wns::Exception("Unknown AsyncLog policy: " + p);
+	}
+
+	this->init(
+		config.get<std::string>("fileName"),
+		config.get<unsigned long>("capacity"));
+}
+
+AsyncLog::AsyncLog(
+	const std::string& fileName,
+	unsigned long capacity,
+	Policy _policy) :
+	file(),
+	policy(_policy),
+	entries(NULL),
+	mask(0),
+	head(0),
+	dropped(0),
+	tail(0),
+	written(0),
+	running(false),
+	started(false),
+	writerWaiting(false),
+	producerWaiting(false)
+{
+	this->init(fileName, capacity);
+}
+
+AsyncLog::~AsyncLog()
+{
+	this->stop();
+	if (AsyncLog::active == this)
+	{
+		AsyncLog::active = NULL;
+	}
+	delete [] this->entries;
+	pthread_cond_destroy(&this->notFull);
+	pthread_cond_destroy(&this->notEmpty);
+	pthread_mutex_destroy(&this->mutex);
+}
+
+void
+AsyncLog::init(const std::string& fileName, unsigned long capacity)
+{
+	pthread_mutex_init(&this->mutex, NULL);
+	pthread_cond_init(&this->notEmpty, NULL);
+	pthread_cond_init(&this->notFull, NULL);
+
+	if (capacity == 0)
+	{
+		throw wns::Exception("AsyncLog capacity must be > 0");
+	}
+
+	unsigned long size = 1;
+	while (size < capacity)
+	{
+		size <<= 1;
+	}
+	this->entries = new LogEntry[size];
+	this->mask = size - 1;
+
+	this->file.open(fileName.c_str(), std::ios::out | std::ios::trunc);
+	if (!this->file)
+	{
+		throw wns::Exception("Could not open AsyncLog file " + fileName);
+	}
+	this->file << std::setprecision(12);
+}
+
+void
+AsyncLog::start()
+{
+	assure(!this->started, "AsyncLog already started");
+
+	this->running = true;
+	__sync_synchronize();
+	if (pthread_create(&this->thread, NULL, &AsyncLog::run, this) != 0)
+	{
+		this->running = false;
+		throw wns::Exception("Could not start the AsyncLog writer thread");
+	}
+	this->started = true;
+}
+
+void
+AsyncLog::stop()
+{
+	if (!this->file.is_open())
+	{
+		return;
+	}
+
+	if (this->started)
+	{
+		pthread_mutex_lock(&this->mutex);
+		this->running = false;
+		pthread_cond_signal(&this->notEmpty);
+		pthread_mutex_unlock(&this->mutex);
+		pthread_join(this->thread, NULL);
+		this->started = false;
+	}
+	else
+	{
+		// records pushed without writer thread
+		while (this->drain())
+		{
+		}
+	}
+
+	if (this->dropped > 0)
+	{
+		this->file << "# " << this->dropped << " records dropped\n";
+	}
+	this->file.close();
+}
+
+void
+AsyncLog::record(
+	LogEntry::Kind kind,
+	uint32_t source,
+	int32_t a,
+	int32_t b,
+	double value)
+{
+	LogEntry entry;
+	entry.time = wns::simulator::getEventScheduler()->getTime();
+	entry.source = source;
+	entry.kind = kind;
+	entry.a = a;
+	entry.b = b;
+	entry.value = value;
+	this->push(entry);
+}
+
+void
+AsyncLog::push(const LogEntry& entry)
+{
+	unsigned long h = this->head;
+	if (h - this->tail > this->mask)
+	{
+		// the ring is full, waiting needs a running writer
+		if (this->policy == Drop || !this->running)
+		{
+			++this->dropped;
+			return;
+		}
+
+		pthread_mutex_lock(&this->mutex);
+		this->producerWaiting = true;
+		__sync_synchronize();
+		while (h - this->tail > this->mask && this->running)
+		{
+			pthread_cond_wait(&this->notFull, &this->mutex);
+		}
+		this->producerWaiting = false;
+		pthread_mutex_unlock(&this->mutex);
+
+		if (h - this->tail > this->mask)
+		{
+			++this->dropped;
+			return;
+		}
+	}
+
+	this->entries[h & this->mask] = entry;
+	// the record must be complete before the consumer sees the new head
+	__sync_synchronize();
+	this->head = h + 1;
+	// the new head must be visible before the flag is read
+	__sync_synchronize();
+	if (this->writerWaiting)
+	{
+		this->wakeWriter();
+	}
+}
+
+bool
+AsyncLog::drain()
+{
+	unsigned long t = this->tail;
+	unsigned long h = this->head;
+	__sync_synchronize();
+	if (t == h)
+	{
+		return false;
+	}
+
+	unsigned long n = h - t;
+	for (; t != h; ++t)
+	{
+		AsyncLog::format(this->file, this->entries[t & this->mask]);
+		this->file << '\n';
+		// the slot may only be reused after it has been formatted
+		__sync_synchronize();
+		this->tail = t + 1;
+	}
+	this->written += n;
+
+	// the new tail must be visible before the flag is read
+	__sync_synchronize();
+	if (this->producerWaiting)
+	{
+		this->wakeProducer();
+	}
+	return true;
+}
+
+void*
+AsyncLog::run(void* arg)
+{
+	AsyncLog* log = static_cast<AsyncLog*>(arg);
+	while (log->running)
+	{
+		if (log->drain())
+		{
+			continue;
+		}
+
+		pthread_mutex_lock(&log->mutex);
+		log->writerWaiting = true;
+		__sync_synchronize();
+		while (log->running && log->head == log->tail)
+		{
+			pthread_cond_wait(&log->notEmpty, &log->mutex);
+		}
+		log->writerWaiting = false;
+		pthread_mutex_unlock(&log->mutex);
+	}
+
+	// records pushed before stop
+	while (log->drain())
+	{
+	}
+	return NULL;
+}
+
+void
+AsyncLog::wakeWriter()
+{
+	pthread_mutex_lock(&this->mutex);
+	pthread_cond_signal(&this->notEmpty);
+	pthread_mutex_unlock(&this->mutex);
+}
+
+void
+AsyncLog::wakeProducer()
+{
+	pthread_mutex_lock(&this->mutex);
+	pthread_cond_signal(&this->notFull);
+	pthread_mutex_unlock(&this->mutex);
+}
+
+unsigned long
+AsyncLog::getDropped() const
+{
+	return this->dropped;
+}
+
+unsigned long
+AsyncLog::getWritten() const
+{
+	return this->written;
+}
+
+unsigned long
+AsyncLog::getCapacity() const
+{
+	return this->mask + 1;
+}
+
+void
+AsyncLog::setActive(AsyncLog* log)
+{
+	AsyncLog::active = log;
+}
+
+void
+AsyncLog::format(std::ostream& os, const LogEntry& e)
+{
+	os << e.time << " ";
+	switch (e.kind)
+	{
+	case LogEntry::WireUnicastStart:
+		os << "wire " << e.source << ": Sending to MAC address: " << e.a
+		   << " on channel " << e.b << ". Arrival time: " << e.value;
+		break;
+	case LogEntry::WireBroadcastStart:
+		os << "wire " << e.source << ": Sending to: BROADCAST on channel " << e.b
+		   << ". Arrival time: " << e.value;
+		break;
+	case LogEntry::WireMulticastStart:
+		os << "wire " << e.source << ": Sending to: group " << e.a << " on channel " << e.b
+		   << ". Arrival time: " << e.value;
+		break;
+	case LogEntry::WireMulticastEnd:
+		os << "wire " << e.source << ": MulticastTransmission finished";
+		break;
+	case LogEntry::WireUnicastEnd:
+		os << "wire " << e.source << ": UnicastTransmission finished";
+		break;
+	case LogEntry::WireBroadcastEnd:
+		os << "wire " << e.source << ": BroadcastTransmission finished";
+		break;
+	case LogEntry::WireCollision:
+		os << "wire " << e.source << ": Collision occured on channel " << e.b << "!!";
+		break;
+	case LogEntry::WireChannelFree:
+		os << "wire " << e.source << ": Channel " << e.b << " is free again";
+		break;
+	case LogEntry::ReceiverUnicast:
+		os << "receiver " << e.source << ": Received unicast data on channel " << e.b;
+		break;
+	case LogEntry::ReceiverBroadcast:
+		os << "receiver " << e.source << ": Received broadcast data on channel " << e.b;
+		break;
+	case LogEntry::ReceiverMulticast:
+		os << "receiver " << e.source << ": Received multicast data for group " << e.a;
+		break;
+	case LogEntry::ReceiverDeliver:
+		os << "receiver " << e.source << ": Delivering PDU with BER: " << e.value;
+		break;
+	default:
+		os << "unknown record " << e.kind;
+	}
+}
+
+std::string
+AsyncLog::format(const LogEntry& entry)
+{
+	std::ostringstream os;
+	os << std::setprecision(12);
+	AsyncLog::format(os, entry);
+	return os.str();
+}
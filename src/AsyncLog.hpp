@@ -0,0 +1,290 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#ifndef COPPER_ASYNCLOG_HPP
+#define COPPER_ASYNCLOG_HPP
+
+#include <WNS/pyconfig/View.hpp>
+
+#include <pthread.h>
+#include <stdint.h>
+#include <string>
+#include <fstream>
+
+namespace copper
+{
+	/**
+	 * @brief Compact record of a per-frame copper message
+	 *
+	 * The record is formatted by the writer thread of the AsyncLog, the
+	 * meaning of a, b and value depends on the kind (see
+	 * AsyncLog::format).
+	 */
+	struct LogEntry
+	{
+		enum Kind
+		{
+			WireUnicastStart = 0,
+			WireBroadcastStart = 1,
+			WireUnicastEnd = 2,
+			WireBroadcastEnd = 3,
+			WireCollision = 4,
+			WireChannelFree = 5,
+			ReceiverUnicast = 6,
+			ReceiverBroadcast = 7,
+			ReceiverDeliver = 8,
+			WireMulticastStart = 9,
+			WireMulticastEnd = 10,
+			ReceiverMulticast = 11
+		};
+
+		/**
+		 * @brief Simulation time
+		 */
+		double time;
+
+		/**
+		 * @brief Wire id or MAC address of the receiver
+		 */
+		uint32_t source;
+
+		/**
+		 * @brief One of Kind
+		 */
+		uint32_t kind;
+
+		int32_t a;
+
+		int32_t b;
+
+		double value;
+	};
+
+	/**
+	 * @brief Writes the per-frame copper messages from a background
+	 * thread
+	 *
+	 * The simulation thread (single producer) appends LogEntry records
+	 * to a lock-free ring buffer, the writer thread (single consumer)
+	 * formats them and writes them to the file. If the ring is full the
+	 * producer either waits for the writer (Block) or drops the record
+	 * and counts it (Drop). A thread only takes the mutex to sleep on
+	 * its condition variable (empty ring resp. full ring) or to wake up
+	 * the other thread if it sleeps.
+	 *
+	 * If an AsyncLog is active (see Copper::configure) the
+	 * COPPER_FRAME_RECORD / COPPER_DETAIL_RECORD messages are recorded
+	 * here instead of being formatted by the logger, independent of
+	 * whether the logger is enabled. The compile time level
+	 * (COPPER_LOG_LEVEL) still applies: Builds with NDEBUG default to
+	 * COPPER_LOG_SETUP, which strips all records. Build with
+	 * -DCOPPER_LOG_LEVEL=2 (frame) or 3 (detail) to record them.
+	 */
+	class AsyncLog
+	{
+	public:
+		enum Policy
+		{
+			Block,
+			Drop
+		};
+
+		/**
+		 * @brief Constructor (config keys "fileName", "capacity",
+		 * "policy")
+		 */
+		explicit
+		AsyncLog(const wns::pyconfig::View& config);
+
+		/**
+		 * @brief Constructor, capacity is rounded up to a power of two
+		 */
+		AsyncLog(
+			const std::string& fileName,
+			unsigned long capacity,
+			Policy policy);
+
+		/**
+		 * @brief Destructor, stops the writer thread
+		 */
+		~AsyncLog();
+
+		/**
+		 * @brief Starts the writer thread
+		 */
+		void
+		start();
+
+		/**
+		 * @brief Writes the remaining records, stops the writer
+		 * thread and closes the file
+		 */
+		void
+		stop();
+
+		/**
+		 * @brief Appends a record (simulation thread only)
+		 */
+		void
+		record(
+			LogEntry::Kind kind,
+			uint32_t source,
+			int32_t a,
+			int32_t b,
+			double value);
+
+		void
+		push(const LogEntry& entry);
+
+		/**
+		 * @brief Records dropped because the ring was full (Drop
+		 * policy)
+		 */
+		unsigned long
+		getDropped() const;
+
+		/**
+		 * @brief Records written to the file so far
+		 */
+		unsigned long
+		getWritten() const;
+
+		unsigned long
+		getCapacity() const;
+
+		/**
+		 * @brief Writes the record as one line (without newline)
+		 */
+		static void
+		format(std::ostream& os, const LogEntry& entry);
+
+		static std::string
+		format(const LogEntry& entry);
+
+		/**
+		 * @brief The log used by the copper message macros, NULL if
+		 * none is configured
+		 */
+		static AsyncLog*
+		getActive()
+		{
+			return active;
+		}
+
+		static void
+		setActive(AsyncLog* log);
+
+	private:
+		AsyncLog(const AsyncLog&);
+
+		AsyncLog&
+		operator=(const AsyncLog&);
+
+		void
+		init(const std::string& fileName, unsigned long capacity);
+
+		/**
+		 * @brief Writes all available records, returns false if none
+		 * was available
+		 */
+		bool
+		drain();
+
+		static void*
+		run(void* arg);
+
+		/**
+		 * @brief Wakes up the writer if it waits for records
+		 */
+		void
+		wakeWriter();
+
+		/**
+		 * @brief Wakes up the producer if it waits for free slots
+		 */
+		void
+		wakeProducer();
+
+		static AsyncLog* active;
+
+		std::ofstream file;
+
+		Policy policy;
+
+		LogEntry* entries;
+
+		unsigned long mask;
+
+		/**
+		 * @brief Written by the producer only. head and tail count
+		 * the records ever pushed and popped, they are kept on
+		 * separate cache lines.
+		 */
+		volatile unsigned long head;
+
+		unsigned long dropped;
+
+		char padding[64];
+
+		/**
+		 * @brief Written by the consumer only
+		 */
+		volatile unsigned long tail;
+
+		volatile unsigned long written;
+
+		volatile bool running;
+
+		bool started;
+
+		pthread_t thread;
+
+		pthread_mutex_t mutex;
+
+		/**
+		 * @brief Signalled when records are pushed or the writer is
+		 * stopped
+		 */
+		pthread_cond_t notEmpty;
+
+		/**
+		 * @brief Signalled when records have been written
+		 */
+		pthread_cond_t notFull;
+
+		/**
+		 * @brief Set by a thread before it checks the ring a last time
+		 * and sleeps (under the mutex)
+		 */
+		volatile bool writerWaiting;
+
+		volatile bool producerWaiting;
+	};
+}
+
+#endif // NOT defined COPPER_ASYNCLOG_HPP
@@ -0,0 +1,91 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#ifndef COPPER_BERPOLICY_HPP
+#define COPPER_BERPOLICY_HPP
+
+#include <WNS/distribution/Distribution.hpp>
+#include <WNS/distribution/Fixed.hpp>
+
+namespace copper {
+
+	/**
+	 * @brief BER policies of the Receiver
+	 *
+	 * A policy is a functor drawing the BER of one PDU. The Receiver
+	 * delivers the PDUs of a transmission with the policy as template
+	 * parameter, so a constant BER is used without calling the
+	 * distribution (see Receiver::deliver).
+	 */
+	//@{
+	/**
+	 * @brief Constant BER (Fixed distribution, drawn once)
+	 */
+	class ConstantBER
+	{
+	public:
+		explicit
+		ConstantBER(double _value = 0.0) :
+			value(_value)
+		{}
+
+		double
+		operator()() const
+		{
+			return this->value;
+		}
+
+	private:
+		double value;
+	};
+
+	/**
+	 * @brief Any other distribution (e.g. time dependent), drawn
+	 * through the Distribution interface
+	 */
+	class DistributionBER
+	{
+	public:
+		explicit
+		DistributionBER(wns::distribution::Distribution* _dist = NULL) :
+			dist(_dist)
+		{}
+
+		double
+		operator()() const
+		{
+			return (*this->dist)();
+		}
+
+	private:
+		wns::distribution::Distribution* dist;
+	};
+	//@}
+}
+
+#endif // NOT defined COPPER_BERPOLICY_HPP
@@ -0,0 +1,128 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#include <COPPER/BusyHistory.hpp>
+
+#include <WNS/Exception.hpp>
+
+#include <limits>
+
+using namespace copper;
+
+BusyHistory::BusyHistory(unsigned int capacity) :
+	periods(capacity),
+	first(0),
+	count(0),
+	horizon(-std::numeric_limits<simTimeType>::max())
+{
+	if (capacity == 0)
+	{
+		throw wns::Exception("BusyHistory: capacity must be > 0");
+	}
+}
+
+void
+BusyHistory::busy(simTimeType now)
+{
+	assure(
+		this->count == 0 || this->periods[(this->first + this->count - 1) % this->periods.size()].end >= 0.0,
+		"Channel is already busy");
+
+	if (this->count == this->periods.size())
+	{
+		// forget the oldest period
+		this->horizon = this->periods[this->first].end;
+		this->first = (this->first + 1) % this->periods.size();
+		--this->count;
+	}
+
+	Period& p = this->periods[(this->first + this->count) % this->periods.size()];
+	p.start = now;
+	p.end = -1.0;
+	++this->count;
+}
+
+void
+BusyHistory::free(simTimeType now)
+{
+	assure(this->count > 0, "Channel is not busy");
+
+	Period& p = this->periods[(this->first + this->count - 1) % this->periods.size()];
+	assure(p.end < 0.0, "Channel is not busy");
+	p.end = now;
+}
+
+simTimeType
+BusyHistory::blockedSince(simTimeType t) const
+{
+	if (t < this->horizon)
+	{
+		// forgotten, see class documentation
+		return 0.0;
+	}
+
+	// queries are usually close to now, so search from the newest
+	// period backwards
+	for (size_t ii = this->count; ii > 0; --ii)
+	{
+		const Period& p = this->periods[(this->first + ii - 1) % this->periods.size()];
+		if (p.start <= t)
+		{
+			if (p.end < 0.0 || t < p.end)
+			{
+				return t - p.start;
+			}
+			return -1.0;
+		}
+	}
+	return -1.0;
+}
+
+bool
+BusyHistory::isBusyAt(simTimeType t, simTimeType sensingTime) const
+{
+	return this->blockedSince(t - sensingTime) >= 0.0;
+}
+
+simTimeType
+BusyHistory::getHorizon() const
+{
+	return this->horizon;
+}
+
+size_t
+BusyHistory::size() const
+{
+	return this->count;
+}
+
+unsigned int
+BusyHistory::getCapacity() const
+{
+	return this->periods.size();
+}
@@ -0,0 +1,129 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#ifndef COPPER_BUSYHISTORY_HPP
+#define COPPER_BUSYHISTORY_HPP
+
+#include <WNS/events/scheduler/Interface.hpp>
+
+#include <vector>
+
+namespace copper
+{
+	/**
+	 * @brief The most recent busy periods of a channel with fixed memory
+	 *
+	 * Busy periods are stored in a ring of "capacity" entries, the
+	 * oldest period is forgotten when the ring is full. The state at
+	 * times before the end of the last forgotten period is unknown and
+	 * reported as busy, a MAC rather defers than collides.
+	 */
+	class BusyHistory
+	{
+	public:
+		explicit
+		BusyHistory(unsigned int capacity);
+
+		/**
+		 * @brief The channel got busy at time "now"
+		 */
+		void
+		busy(simTimeType now);
+
+		/**
+		 * @brief The channel got free at time "now"
+		 */
+		void
+		free(simTimeType now);
+
+		/**
+		 * @brief Time the channel had been blocked at time t (< 0.0
+		 * if it was free), the historic counterpart of
+		 * WireInterface::blockedSince
+		 *
+		 * A channel blocked in [start, end) was busy at start and free
+		 * at end. Before the horizon 0.0 is returned (busy, duration
+		 * unknown).
+		 */
+		simTimeType
+		blockedSince(simTimeType t) const;
+
+		/**
+		 * @brief Carrier state perceived at time t by a station with
+		 * the given sensing time
+		 *
+		 * Both the start and the end of a busy period are perceived
+		 * sensingTime later (like CarrierSensing::onCarrierBusy and
+		 * onCarrierIdle), i.e. this is the state at t - sensingTime.
+		 */
+		bool
+		isBusyAt(simTimeType t, simTimeType sensingTime) const;
+
+		/**
+		 * @brief Time before which the history is incomplete (the
+		 * lowest simTimeType as long as no busy period has been
+		 * forgotten)
+		 */
+		simTimeType
+		getHorizon() const;
+
+		/**
+		 * @brief Number of stored busy periods (including an ongoing
+		 * one)
+		 */
+		size_t
+		size() const;
+
+		unsigned int
+		getCapacity() const;
+
+	private:
+		struct Period
+		{
+			simTimeType start;
+
+			/**
+			 * @brief < 0.0 while the period is ongoing
+			 */
+			simTimeType end;
+		};
+
+		/**
+		 * @brief Ring of periods, oldest at "first"
+		 */
+		std::vector<Period> periods;
+
+		size_t first;
+
+		size_t count;
+
+		simTimeType horizon;
+	};
+}
+
+#endif // NOT defined COPPER_BUSYHISTORY_HPP
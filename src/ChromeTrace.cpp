@@ -0,0 +1,276 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include <COPPER/ChromeTrace.hpp>
+
+#include <WNS/events/scheduler/Interface.hpp>
+#include <WNS/Exception.hpp>
+
+#include <iomanip>
+#include <sstream>
+
+using namespace copper;
+
+const unsigned int ChromeTrace::firstSenderThread;
+
+const unsigned int ChromeTrace::firstReceiverThread;
+
+ChromeTrace::ChromeTrace(
+	const wns::pyconfig::View& config,
+	unsigned int wireId,
+	const std::string& wireName,
+	ChannelId numberOfChannels) :
+
+	pid(wireId),
+	deliveries(config.get<bool>("deliveries")),
+	buffer(config.get<size_t>("bufferSize")),
+	out(),
+	firstEvent(true),
+	ongoing(),
+	senders(),
+	receivers()
+{
+	std::string fileName = config.get<std::string>("fileName");
+	if (!this->buffer.empty())
+	{
+		this->out.rdbuf()->pubsetbuf(&this->buffer[0], this->buffer.size());
+	}
+	this->out.open(fileName.c_str());
+	if (!this->out)
+	{
+		wns::Exception e;
+		e << "ChromeTrace: cannot open " << fileName;
+		throw e;
+	}
+
+	// simulation time in s, trace time in us (ns resolution)
+	this->out << "[" << std::fixed << std::setprecision(3);
+
+	this->beginEvent("process_name", "__metadata", 'M', 0.0, 0)
+		<< ",\"args\":{\"name\":\"" << escape(wireName) << "\"}}";
+
+	for (ChannelId channel = 0; channel < numberOfChannels; ++channel)
+	{
+		std::stringstream name;
+		name << "channel " << channel;
+		this->nameThread(channel, name.str());
+	}
+}
+
+ChromeTrace::~ChromeTrace()
+{
+	this->out << "\n]\n";
+}
+
+void
+ChromeTrace::addReceiver(
+	const ReceiverInterface* receiver,
+	const wns::service::dll::UnicastAddress& address)
+{
+	unsigned int thread = firstReceiverThread + this->receivers.size();
+	this->receivers[receiver] = thread;
+
+	std::stringstream name;
+	name << "receiver " << address;
+	this->nameThread(thread, name.str());
+}
+
+void
+ChromeTrace::start(const UnicastTransmissionPtr& ut)
+{
+	this->start(ut, ut->target.getInteger());
+}
+
+void
+ChromeTrace::start(const BroadcastTransmissionPtr& bt)
+{
+	this->start(bt, -1);
+}
+
+void
+ChromeTrace::start(const MulticastTransmissionPtr& mt)
+{
+	this->start(mt, -1, mt->group);
+}
+
+void
+ChromeTrace::start(const TransmissionPtr& t, int target, int group)
+{
+	Start& s = this->ongoing[t.getPtr()];
+	s.time = wns::simulator::getEventScheduler()->getTime();
+	s.target = target;
+	s.group = group;
+}
+
+void
+ChromeTrace::end(const TransmissionPtr& t, bool cancelled)
+{
+	std::map<const Transmission*, Start>::iterator itr = this->ongoing.find(t.getPtr());
+	assure(itr != this->ongoing.end(), "Transmission not started");
+	Start s = itr->second;
+	this->ongoing.erase(itr);
+
+	Bit bits = t->pdu->getLengthInBits();
+	for (
+		PDUContainer::const_iterator pdu = t->burst.begin();
+		pdu != t->burst.end();
+		++pdu)
+	{
+		bits += (*pdu)->getLengthInBits();
+	}
+
+	std::stringstream name;
+	if (s.group >= 0)
+	{
+		name << "multicast to group " << s.group;
+	}
+	else if (s.target < 0)
+	{
+		name << "broadcast";
+	}
+	else
+	{
+		name << "unicast to " << s.target;
+	}
+
+	simTimeType now = wns::simulator::getEventScheduler()->getTime();
+	this->beginEvent(name.str(), "transmission", 'X', s.time, this->getSenderThread(t->sender))
+		<< ",\"dur\":" << (now - s.time) * 1E6
+		<< ",\"args\":{\"channel\":" << t->channel
+		<< ",\"bits\":" << bits
+		<< ",\"bursts\":" << t->burst.size()
+		<< ",\"collision\":" << (t->collision ? "true" : "false")
+		<< ",\"cancelled\":" << (cancelled ? "true" : "false")
+		<< "}}";
+}
+
+void
+ChromeTrace::collision(const TransmissionPtr& t)
+{
+	this->beginEvent(
+		"collision", "collision", 'i',
+		wns::simulator::getEventScheduler()->getTime(),
+		this->getSenderThread(t->sender))
+		<< ",\"s\":\"t\",\"args\":{\"channel\":" << t->channel << "}}";
+}
+
+void
+ChromeTrace::delivery(const ReceiverInterface* receiver, const TransmissionPtr& t)
+{
+	if (!this->deliveries)
+	{
+		return;
+	}
+
+	std::map<const ReceiverInterface*, unsigned int>::const_iterator itr =
+		this->receivers.find(receiver);
+	assure(itr != this->receivers.end(), "Receiver not at this wire");
+
+	this->beginEvent(
+		"delivery", "delivery", 'i',
+		wns::simulator::getEventScheduler()->getTime(),
+		itr->second)
+		<< ",\"s\":\"t\",\"args\":{\"sender\":" << this->getSenderThread(t->sender) - firstSenderThread
+		<< ",\"collision\":" << (t->collision ? "true" : "false")
+		<< "}}";
+}
+
+void
+ChromeTrace::busyPeriod(ChannelId channel, simTimeType begin, simTimeType end)
+{
+	this->beginEvent("busy", "channel", 'X', begin, channel)
+		<< ",\"dur\":" << (end - begin) * 1E6 << "}";
+}
+
+unsigned int
+ChromeTrace::getSenderThread(const TransmitterDataSentInterface* sender)
+{
+	std::map<const TransmitterDataSentInterface*, unsigned int>::const_iterator itr =
+		this->senders.find(sender);
+	if (itr != this->senders.end())
+	{
+		return itr->second;
+	}
+
+	unsigned int thread = firstSenderThread + this->senders.size();
+	this->senders[sender] = thread;
+
+	std::stringstream name;
+	name << "sender " << thread - firstSenderThread;
+	this->nameThread(thread, name.str());
+	return thread;
+}
+
+std::ostream&
+ChromeTrace::beginEvent(
+	const std::string& name,
+	const char* category,
+	char phase,
+	simTimeType time,
+	unsigned int thread)
+{
+	this->out << (this->firstEvent ? "\n" : ",\n")
+		  << "{\"name\":\"" << name
+		  << "\",\"cat\":\"" << category
+		  << "\",\"ph\":\"" << phase
+		  << "\",\"ts\":" << time * 1E6
+		  << ",\"pid\":" << this->pid
+		  << ",\"tid\":" << thread;
+	this->firstEvent = false;
+	return this->out;
+}
+
+void
+ChromeTrace::nameThread(unsigned int thread, const std::string& name)
+{
+	this->beginEvent("thread_name", "__metadata", 'M', 0.0, thread)
+		<< ",\"args\":{\"name\":\"" << escape(name) << "\"}}";
+}
+
+std::string
+ChromeTrace::escape(const std::string& text)
+{
+	std::stringstream escaped;
+	for (std::string::const_iterator itr = text.begin(); itr != text.end(); ++itr)
+	{
+		unsigned char c = static_cast<unsigned char>(*itr);
+		if (c == '"' || c == '\\')
+		{
+			escaped << '\\' << *itr;
+		}
+		else if (c < 0x20)
+		{
+			escaped << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+				<< static_cast<unsigned int>(c) << std::dec;
+		}
+		else
+		{
+			escaped << *itr;
+		}
+	}
+	return escaped.str();
+}
@@ -0,0 +1,188 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#ifndef COPPER_CHROMETRACE_HPP
+#define COPPER_CHROMETRACE_HPP
+
+#include <COPPER/Transmission.hpp>
+
+#include <WNS/pyconfig/View.hpp>
+
+#include <string>
+#include <fstream>
+#include <vector>
+#include <map>
+
+namespace copper
+{
+	class ReceiverInterface;
+
+	/**
+	 * @brief Writes the activity of a wire as Chrome trace event JSON
+	 * (viewable in Perfetto or chrome://tracing)
+	 *
+	 * The wire is a process, each channel, sender and receiver a thread:
+	 * busy periods are slices on the channel threads, transmissions are
+	 * slices on the thread of their sender (with channel, length,
+	 * collision and cancel flag as arguments), collisions and
+	 * deliveries are instant events on the sender and receiver threads.
+	 *
+	 * Events are streamed to the file through a buffer of fixed size,
+	 * only the start times of the ongoing transmissions are kept.
+	 * Deliveries of broadcasts produce one event per receiver, they can
+	 * be switched off.
+	 */
+	class ChromeTrace
+	{
+	public:
+		/**
+		 * @brief Constructor (config keys "fileName", "deliveries",
+		 * "bufferSize")
+		 */
+		ChromeTrace(
+			const wns::pyconfig::View& config,
+			unsigned int wireId,
+			const std::string& wireName,
+			ChannelId numberOfChannels);
+
+		/**
+		 * @brief Destructor, terminates the JSON array
+		 */
+		~ChromeTrace();
+
+		/**
+		 * @brief Names the thread of the receiver after its address
+		 */
+		void
+		addReceiver(
+			const ReceiverInterface* receiver,
+			const wns::service::dll::UnicastAddress& address);
+
+		void
+		start(const UnicastTransmissionPtr& ut);
+
+		void
+		start(const BroadcastTransmissionPtr& bt);
+
+		void
+		start(const MulticastTransmissionPtr& mt);
+
+		/**
+		 * @brief Writes the slice of the transmission
+		 */
+		void
+		end(const TransmissionPtr& t, bool cancelled);
+
+		void
+		collision(const TransmissionPtr& t);
+
+		void
+		delivery(const ReceiverInterface* receiver, const TransmissionPtr& t);
+
+		/**
+		 * @brief Writes the slice of a busy period of the channel
+		 */
+		void
+		busyPeriod(ChannelId channel, simTimeType begin, simTimeType end);
+
+	private:
+		struct Start
+		{
+			simTimeType time;
+
+			/**
+			 * @brief MAC address (integer), -1 for broadcast and
+			 * multicast
+			 */
+			int target;
+
+			/**
+			 * @brief Multicast group, -1 otherwise
+			 */
+			int group;
+		};
+
+		void
+		start(const TransmissionPtr& t, int target, int group = -1);
+
+		/**
+		 * @brief Thread id of the sender, names the thread on first use
+		 */
+		unsigned int
+		getSenderThread(const TransmitterDataSentInterface* sender);
+
+		/**
+		 * @brief Begins an event, followed by the event specific fields
+		 * and "}"
+		 */
+		std::ostream&
+		beginEvent(
+			const std::string& name,
+			const char* category,
+			char phase,
+			simTimeType time,
+			unsigned int thread);
+
+		/**
+		 * @brief Names are escaped (see escape)
+		 */
+		void
+		nameThread(unsigned int thread, const std::string& name);
+
+		/**
+		 * @brief The text as content of a JSON string (quotes,
+		 * backslashes and control characters escaped)
+		 */
+		static std::string
+		escape(const std::string& text);
+
+		static const unsigned int firstSenderThread = 1000;
+
+		static const unsigned int firstReceiverThread = 1000000;
+
+		unsigned int pid;
+
+		bool deliveries;
+
+		/**
+		 * @brief Stream buffer (used by out)
+		 */
+		std::vector<char> buffer;
+
+		std::ofstream out;
+
+		bool firstEvent;
+
+		std::map<const Transmission*, Start> ongoing;
+
+		std::map<const TransmitterDataSentInterface*, unsigned int> senders;
+
+		std::map<const ReceiverInterface*, unsigned int> receivers;
+	};
+}
+
+#endif // NOT defined COPPER_CHROMETRACE_HPP
@@ -26,6 +26,11 @@
  ******************************************************************************/
 
 #include <COPPER/Copper.hpp>
+#include <COPPER/Wire.hpp>
+#include <COPPER/ScalingReport.hpp>
+#include <COPPER/Profiling.hpp>
+#include <COPPER/AsyncLog.hpp>
+#include <COPPER/Logging.hpp>
 
 using namespace copper;
 
@@ -36,17 +41,39 @@ STATIC_FACTORY_REGISTER_WITH_CREATOR(
 	wns::PyConfigViewCreator);
 
 Copper::Copper(const wns::pyconfig::View& _pyco) :
-	wns::module::Module<Copper>(_pyco)
+	wns::module::Module<Copper>(_pyco),
+	asyncLog(NULL)
 {
 }
 
 Copper::~Copper()
 {
+	delete this->asyncLog;
 }
 
 void
 Copper::configure()
 {
+	wns::pyconfig::View pyco = this->getPyConfigView();
+	if (!pyco.isNone("scalingReport"))
+	{
+		ScalingReport::getInstance().configure(pyco.get("scalingReport"));
+	}
+
+	if (!pyco.isNone("asyncLog"))
+	{
+		this->asyncLog = new AsyncLog(pyco.get("asyncLog"));
+		this->asyncLog->start();
+		AsyncLog::setActive(this->asyncLog);
+
+		if (COPPER_LOG_LEVEL < COPPER_LOG_FRAME)
+		{
+			MESSAGE_SINGLE(
+				NORMAL, wns::logger::Logger("COPPER", "AsyncLog"),
+				"AsyncLog: per-frame records are stripped (COPPER_LOG_LEVEL " << COPPER_LOG_LEVEL
+				<< "), build with -DCOPPER_LOG_LEVEL=2 to record them");
+		}
+	}
 }
 
 void
@@ -57,6 +84,29 @@ Copper::startUp()
 void
 Copper::shutDown()
 {
+	for (
+		std::list<Wire*>::const_iterator itr = Wire::getWires().begin();
+		itr != Wire::getWires().end();
+		++itr)
+	{
+		(*itr)->writeCounters();
+	}
+
+	ScalingReport::getInstance().write();
+
+	if (this->asyncLog != NULL)
+	{
+		AsyncLog::setActive(NULL);
+		this->asyncLog->stop();
+		MESSAGE_SINGLE(
+			NORMAL, wns::logger::Logger("COPPER", "AsyncLog"),
+			"AsyncLog: " << this->asyncLog->getWritten() << " records written, "
+			<< this->asyncLog->getDropped() << " dropped");
+	}
+
+#ifdef COPPER_PROFILING
+	profiling::Profiler::write(wns::logger::Logger("COPPER", "Profiling"));
+#endif
 }
 
 
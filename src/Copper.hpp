@@ -32,6 +32,8 @@
 
 namespace copper
 {
+	class AsyncLog;
+
 	/**
 	 * @brief Module configurartion, startUp and shutDown are handled here
 	 */
@@ -52,9 +54,8 @@ namespace copper
 		~Copper();
 
 		/**
-		 * @brief Empty
-		 *
-		 * Copper needs no special configuration mechanism
+		 * @brief Enables the ScalingReport and starts the AsyncLog if
+		 * configured
 		 */
 		virtual void
 		configure();
@@ -68,12 +69,19 @@ namespace copper
 		startUp();
 
 		/**
-		 * @brief Empty
-		 *
-		 * Copper needs no special shutdown procedure
+		 * @brief Writes the counters of all wires, the ScalingReport
+		 * and the profile (if built with COPPER_PROFILING), stops the
+		 * AsyncLog
 		 */
 		virtual void
 		shutDown();
+
+	private:
+		/**
+		 * @brief Sink of the per-frame messages (owned, NULL if not
+		 * configured)
+		 */
+		AsyncLog* asyncLog;
 	};
 }
 
@@ -0,0 +1,243 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#include <COPPER/LatencyHistogram.hpp>
+
+#include <WNS/Exception.hpp>
+
+#include <limits>
+#include <algorithm>
+
+using namespace copper;
+
+LatencyHistogram::LatencyHistogram(const wns::pyconfig::View& config) :
+	resolution(config.get<simTimeType>("resolution")),
+	precisionBits(config.get<unsigned int>("precisionBits")),
+	subBuckets(0),
+	buckets(),
+	count(0),
+	sum(0.0),
+	max(0.0)
+{
+	this->init(config.get<simTimeType>("maxValue"));
+}
+
+LatencyHistogram::LatencyHistogram(
+	simTimeType _resolution,
+	simTimeType maxValue,
+	unsigned int _precisionBits) :
+	resolution(_resolution),
+	precisionBits(_precisionBits),
+	subBuckets(0),
+	buckets(),
+	count(0),
+	sum(0.0),
+	max(0.0)
+{
+	this->init(maxValue);
+}
+
+void
+LatencyHistogram::init(simTimeType maxValue)
+{
+	if (this->resolution <= 0.0 || maxValue < this->resolution)
+	{
+		throw wns::Exception("LatencyHistogram: resolution must be > 0.0 and <= maxValue");
+	}
+
+	if (this->precisionBits < 1 || this->precisionBits > 16)
+	{
+		throw wns::Exception("LatencyHistogram: precisionBits must be in [1, 16]");
+	}
+
+	double maxUnits = maxValue / this->resolution;
+	if (maxUnits >= static_cast<double>(std::numeric_limits<unsigned long>::max() / 2))
+	{
+		throw wns::Exception("LatencyHistogram: maxValue / resolution too large");
+	}
+
+	this->subBuckets = 1UL << this->precisionBits;
+	this->buckets.resize(this->getIndex(static_cast<unsigned long>(maxUnits)) + 1, 0);
+}
+
+void
+LatencyHistogram::put(simTimeType value)
+{
+	if (value < 0.0)
+	{
+		value = 0.0;
+	}
+
+	size_t index = this->buckets.size() - 1;
+	// round to the nearest unit, values are often exact multiples of
+	// the resolution
+	double units = value / this->resolution + 0.5;
+	if (units < static_cast<double>(this->getHighestUnits(index)))
+	{
+		index = this->getIndex(static_cast<unsigned long>(units));
+	}
+
+	++this->buckets[index];
+	++this->count;
+	this->sum += value;
+	if (value > this->max)
+	{
+		this->max = value;
+	}
+}
+
+void
+LatencyHistogram::merge(const LatencyHistogram& other)
+{
+	if (this->resolution != other.resolution ||
+	    this->precisionBits != other.precisionBits ||
+	    this->buckets.size() != other.buckets.size())
+	{
+		throw wns::Exception("LatencyHistogram: can not merge histograms with different layout");
+	}
+
+	for (size_t ii = 0; ii < this->buckets.size(); ++ii)
+	{
+		this->buckets[ii] += other.buckets[ii];
+	}
+	this->count += other.count;
+	this->sum += other.sum;
+	if (other.max > this->max)
+	{
+		this->max = other.max;
+	}
+}
+
+void
+LatencyHistogram::reset()
+{
+	std::fill(this->buckets.begin(), this->buckets.end(), 0);
+	this->count = 0;
+	this->sum = 0.0;
+	this->max = 0.0;
+}
+
+unsigned long
+LatencyHistogram::getCount() const
+{
+	return this->count;
+}
+
+simTimeType
+LatencyHistogram::getPercentile(double percentile) const
+{
+	assure(percentile >= 0.0 && percentile <= 100.0, "percentile must be in [0, 100]");
+
+	if (this->count == 0)
+	{
+		return 0.0;
+	}
+
+	double rank = percentile / 100.0 * this->count;
+	unsigned long seen = 0;
+	size_t index = 0;
+	while (index < this->buckets.size() - 1)
+	{
+		seen += this->buckets[index];
+		if (seen > 0 && seen >= rank)
+		{
+			break;
+		}
+		++index;
+	}
+
+	// never report more than has been recorded (the last bucket
+	// also counts the values above maxValue)
+	if (index == this->buckets.size() - 1)
+	{
+		return this->max;
+	}
+	simTimeType value = this->getHighestUnits(index) * this->resolution;
+	return value < this->max ? value : this->max;
+}
+
+simTimeType
+LatencyHistogram::getMean() const
+{
+	return this->count > 0 ? this->sum / this->count : 0.0;
+}
+
+simTimeType
+LatencyHistogram::getMax() const
+{
+	return this->max;
+}
+
+size_t
+LatencyHistogram::getNumberOfBuckets() const
+{
+	return this->buckets.size();
+}
+
+size_t
+LatencyHistogram::getIndex(unsigned long units) const
+{
+	if (units < this->subBuckets)
+	{
+		return units;
+	}
+
+	// shift units into [subBuckets / 2, subBuckets)
+	unsigned int shift = mostSignificantBit(units) - this->precisionBits + 1;
+	unsigned long half = this->subBuckets / 2;
+	return this->subBuckets + (shift - 1) * half + ((units >> shift) - half);
+}
+
+unsigned long
+LatencyHistogram::getHighestUnits(size_t index) const
+{
+	if (index < this->subBuckets)
+	{
+		return index;
+	}
+
+	unsigned long half = this->subBuckets / 2;
+	unsigned int shift = (index - this->subBuckets) / half + 1;
+	unsigned long sub = (index - this->subBuckets) % half + half;
+	return ((sub + 1) << shift) - 1;
+}
+
+unsigned int
+LatencyHistogram::mostSignificantBit(unsigned long units)
+{
+	unsigned int msb = 0;
+	for (unsigned int step = std::numeric_limits<unsigned long>::digits / 2; step > 0; step /= 2)
+	{
+		if (units >> step)
+		{
+			units >>= step;
+			msb += step;
+		}
+	}
+	return msb;
+}
@@ -0,0 +1,149 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#ifndef COPPER_LATENCYHISTOGRAM_HPP
+#define COPPER_LATENCYHISTOGRAM_HPP
+
+#include <WNS/pyconfig/View.hpp>
+
+#include <vector>
+
+namespace copper
+{
+	/**
+	 * @brief Log-linear (HDR style) histogram of time values with fixed
+	 * memory
+	 *
+	 * Values are rounded to units of the resolution. Below
+	 * 2^precisionBits units every unit has its own bucket, above that
+	 * each power of two range is divided into 2^(precisionBits - 1)
+	 * buckets, so the relative error of a recorded value is at most
+	 * 2^(1 - precisionBits). Values above maxValue are counted in the
+	 * last bucket. Histograms with the same layout can be merged.
+	 */
+	class LatencyHistogram
+	{
+	public:
+		/**
+		 * @brief Constructor (config keys "resolution", "maxValue",
+		 * "precisionBits")
+		 */
+		explicit
+		LatencyHistogram(const wns::pyconfig::View& config);
+
+		LatencyHistogram(
+			simTimeType resolution,
+			simTimeType maxValue,
+			unsigned int precisionBits);
+
+		/**
+		 * @brief Records a value (negative values are recorded as 0)
+		 */
+		void
+		put(simTimeType value);
+
+		/**
+		 * @brief Adds the counts of the other histogram, throws if the
+		 * layouts differ
+		 */
+		void
+		merge(const LatencyHistogram& other);
+
+		void
+		reset();
+
+		unsigned long
+		getCount() const;
+
+		/**
+		 * @brief Smallest value such that at least "percentile" percent
+		 * of the recorded values are less or equal (within the
+		 * precision of the histogram)
+		 *
+		 * @param percentile in [0, 100]
+		 */
+		simTimeType
+		getPercentile(double percentile) const;
+
+		/**
+		 * @brief Exact mean of the recorded values
+		 */
+		simTimeType
+		getMean() const;
+
+		/**
+		 * @brief Exact maximum of the recorded values
+		 */
+		simTimeType
+		getMax() const;
+
+		/**
+		 * @brief Number of buckets (fixed on construction)
+		 */
+		size_t
+		getNumberOfBuckets() const;
+
+	private:
+		void
+		init(simTimeType maxValue);
+
+		size_t
+		getIndex(unsigned long units) const;
+
+		/**
+		 * @brief Highest value (in units) counted in the bucket
+		 */
+		unsigned long
+		getHighestUnits(size_t index) const;
+
+		/**
+		 * @brief Position of the most significant bit set
+		 */
+		static unsigned int
+		mostSignificantBit(unsigned long units);
+
+		simTimeType resolution;
+
+		unsigned int precisionBits;
+
+		/**
+		 * @brief Number of buckets of the linear range (2^precisionBits)
+		 */
+		unsigned long subBuckets;
+
+		std::vector<unsigned long> buckets;
+
+		unsigned long count;
+
+		simTimeType sum;
+
+		simTimeType max;
+	};
+}
+
+#endif // NOT defined COPPER_LATENCYHISTOGRAM_HPP
@@ -0,0 +1,105 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#ifndef COPPER_LOGGING_HPP
+#define COPPER_LOGGING_HPP
+
+#include <COPPER/AsyncLog.hpp>
+
+#include <WNS/logger/Logger.hpp>
+
+/**
+ * @brief Compile time verbosity of the copper messages
+ *
+ * COPPER_LOG_SETUP: creation, configuration and shutdown messages only
+ * (MESSAGE_SINGLE / MESSAGE_BEGIN).
+ *
+ * COPPER_LOG_FRAME: in addition one message per transmission, delivery,
+ * collision or channel access step (COPPER_FRAME_MESSAGE).
+ *
+ * COPPER_LOG_DETAIL: in addition messages per receiver or per PDU of a
+ * burst (COPPER_DETAIL_MESSAGE).
+ *
+ * The level defaults to COPPER_LOG_SETUP if NDEBUG is defined and to
+ * COPPER_LOG_DETAIL otherwise, it can be set with -DCOPPER_LOG_LEVEL=n.
+ * Stripped messages are still compiled (in a dead branch) but generate
+ * no code. Enabled messages are only formatted if the logger is
+ * enabled.
+ *
+ * The COPPER_*_RECORD variants additionally describe the message as
+ * LogEntry. If an AsyncLog is active the entry is handed to its writer
+ * thread instead of formatting the message.
+ */
+#define COPPER_LOG_SETUP 1
+#define COPPER_LOG_FRAME 2
+#define COPPER_LOG_DETAIL 3
+
+#ifndef COPPER_LOG_LEVEL
+#ifdef NDEBUG
+#define COPPER_LOG_LEVEL COPPER_LOG_SETUP
+#else
+#define COPPER_LOG_LEVEL COPPER_LOG_DETAIL
+#endif
+#endif
+
+#define COPPER_LEVEL_MESSAGE(enabled, level, logger, expr) \
+	do { \
+		if ((enabled) && (logger).isEnabled()) \
+		{ \
+			MESSAGE_SINGLE(level, logger, expr); \
+		} \
+	} while (false)
+
+#define COPPER_FRAME_MESSAGE(level, logger, expr) \
+	COPPER_LEVEL_MESSAGE(COPPER_LOG_LEVEL >= COPPER_LOG_FRAME, level, logger, expr)
+
+#define COPPER_DETAIL_MESSAGE(level, logger, expr) \
+	COPPER_LEVEL_MESSAGE(COPPER_LOG_LEVEL >= COPPER_LOG_DETAIL, level, logger, expr)
+
+#define COPPER_LEVEL_RECORD(enabled, level, logger, kind, source, a, b, value, expr) \
+	do { \
+		if (enabled) \
+		{ \
+			copper::AsyncLog* asyncLog_ = copper::AsyncLog::getActive(); \
+			if (asyncLog_ != NULL) \
+			{ \
+				asyncLog_->record(copper::LogEntry::kind, source, a, b, value); \
+			} \
+			else if ((logger).isEnabled()) \
+			{ \
+				MESSAGE_SINGLE(level, logger, expr); \
+			} \
+		} \
+	} while (false)
+
+#define COPPER_FRAME_RECORD(level, logger, kind, source, a, b, value, expr) \
+	COPPER_LEVEL_RECORD(COPPER_LOG_LEVEL >= COPPER_LOG_FRAME, level, logger, kind, source, a, b, value, expr)
+
+#define COPPER_DETAIL_RECORD(level, logger, kind, source, a, b, value, expr) \
+	COPPER_LEVEL_RECORD(COPPER_LOG_LEVEL >= COPPER_LOG_DETAIL, level, logger, kind, source, a, b, value, expr)
+
+#endif // NOT defined COPPER_LOGGING_HPP
@@ -0,0 +1,244 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#include <COPPER/PcapCapture.hpp>
+
+#include <WNS/events/scheduler/Interface.hpp>
+#include <WNS/Exception.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace copper;
+
+const uint32_t PcapCapture::magic;
+
+const uint32_t PcapCapture::linkType;
+
+namespace
+{
+	/**
+	 * @brief pcap file header
+	 */
+	struct FileHeader
+	{
+		uint32_t magic;
+		uint16_t versionMajor;
+		uint16_t versionMinor;
+		int32_t thisZone;
+		uint32_t sigFigs;
+		uint32_t snapLength;
+		uint32_t linkType;
+	};
+
+	/**
+	 * @brief pcap record header
+	 */
+	struct RecordHeader
+	{
+		uint32_t seconds;
+		uint32_t nanoseconds;
+		uint32_t capturedLength;
+		uint32_t originalLength;
+	};
+}
+
+PcapCapture::PcapCapture(const wns::pyconfig::View& config, unsigned int _wireId) :
+	wireId(_wireId),
+	payload(config.get<bool>("payload")),
+	snapLength(config.get<uint32_t>("snapLength")),
+	buffer(config.get<size_t>("bufferSize")),
+	out(),
+	bytes(),
+	packets(0),
+	senders()
+{
+	this->open(config.get<std::string>("fileName"));
+}
+
+PcapCapture::PcapCapture(
+	const std::string& fileName,
+	unsigned int _wireId,
+	bool _payload,
+	uint32_t _snapLength,
+	size_t bufferSize) :
+	wireId(_wireId),
+	payload(_payload),
+	snapLength(_snapLength),
+	buffer(bufferSize),
+	out(),
+	bytes(),
+	packets(0),
+	senders()
+{
+	this->open(fileName);
+}
+
+PcapCapture::~PcapCapture()
+{
+	this->out.flush();
+}
+
+void
+PcapCapture::open(const std::string& fileName)
+{
+	if (this->snapLength < sizeof(PcapPacketHeader))
+	{
+		wns::Exception e;
+		e << "PcapCapture: snapLength must be at least "
+		  << sizeof(PcapPacketHeader) << " Bytes";
+		throw e;
+	}
+
+	if (!this->buffer.empty())
+	{
+		this->out.rdbuf()->pubsetbuf(&this->buffer[0], this->buffer.size());
+	}
+	this->out.open(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!this->out)
+	{
+		wns::Exception e;
+		e << "PcapCapture: cannot open " << fileName;
+		throw e;
+	}
+
+	FileHeader h;
+	h.magic = magic;
+	h.versionMajor = 2;
+	h.versionMinor = 4;
+	h.thisZone = 0;
+	h.sigFigs = 0;
+	h.snapLength = this->snapLength;
+	h.linkType = linkType;
+	this->out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+}
+
+void
+PcapCapture::capture(
+	const TransmissionPtr& t,
+	PcapPacketHeader::Type type,
+	int32_t target)
+{
+	PcapPacketHeader p;
+	std::memset(&p, 0, sizeof(p));
+	p.wire = this->wireId;
+	p.sender = this->getSenderId(t->sender);
+	p.target = target;
+	p.channel = t->channel;
+	p.collision = t->collision ? 1 : 0;
+	p.pdus = static_cast<uint8_t>(std::min<size_t>(1 + t->burst.size(), 255));
+	p.type = type;
+
+	Bit bits = t->pdu->getLengthInBits();
+	for (
+		PDUContainer::const_iterator itr = t->burst.begin();
+		itr != t->burst.end();
+		++itr)
+	{
+		bits += (*itr)->getLengthInBits();
+	}
+	p.length = bits;
+
+	this->bytes.clear();
+	if (this->payload)
+	{
+		serialize(t->pdu, this->bytes);
+		for (
+			PDUContainer::const_iterator itr = t->burst.begin();
+			itr != t->burst.end();
+			++itr)
+		{
+			serialize(*itr, this->bytes);
+		}
+	}
+
+	// PDUs may serialize more than their length
+	uint32_t original = (bits + 7) / 8;
+	uint32_t available = this->snapLength - sizeof(PcapPacketHeader);
+	uint32_t captured = std::min<size_t>(this->bytes.size(), std::min(available, original));
+
+	simTimeType now = wns::simulator::getEventScheduler()->getTime();
+	double seconds = std::floor(now);
+
+	RecordHeader r;
+	r.seconds = static_cast<uint32_t>(seconds);
+	r.nanoseconds = static_cast<uint32_t>((now - seconds) * 1E9 + 0.5);
+	if (r.nanoseconds >= 1000000000)
+	{
+		++r.seconds;
+		r.nanoseconds -= 1000000000;
+	}
+	r.capturedLength = sizeof(PcapPacketHeader) + captured;
+	r.originalLength = sizeof(PcapPacketHeader) + original;
+
+	this->out.write(reinterpret_cast<const char*>(&r), sizeof(r));
+	this->out.write(reinterpret_cast<const char*>(&p), sizeof(p));
+	if (captured > 0)
+	{
+		this->out.write(reinterpret_cast<const char*>(&this->bytes[0]), captured);
+	}
+	++this->packets;
+}
+
+void
+PcapCapture::flush()
+{
+	this->out.flush();
+}
+
+unsigned long
+PcapCapture::getNumberOfPackets() const
+{
+	return this->packets;
+}
+
+uint32_t
+PcapCapture::getSenderId(const TransmitterDataSentInterface* sender)
+{
+	std::map<const TransmitterDataSentInterface*, uint32_t>::iterator itr =
+		this->senders.find(sender);
+	if (itr == this->senders.end())
+	{
+		uint32_t id = this->senders.size();
+		this->senders[sender] = id;
+		return id;
+	}
+	return itr->second;
+}
+
+void
+PcapCapture::serialize(const wns::osi::PDUPtr& pdu, std::vector<uint8_t>& bytes)
+{
+	const PcapSerializable* s =
+		dynamic_cast<const PcapSerializable*>(pdu.getPtr());
+	if (s != NULL)
+	{
+		s->serialize(bytes);
+	}
+}
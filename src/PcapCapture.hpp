@@ -0,0 +1,212 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#ifndef COPPER_PCAPCAPTURE_HPP
+#define COPPER_PCAPCAPTURE_HPP
+
+#include <COPPER/Transmission.hpp>
+
+#include <WNS/pyconfig/View.hpp>
+
+#include <stdint.h>
+#include <string>
+#include <fstream>
+#include <vector>
+#include <map>
+
+namespace copper
+{
+	/**
+	 * @brief PDUs implementing this interface are captured with their
+	 * content (see PcapCapture)
+	 */
+	class PcapSerializable
+	{
+	public:
+		virtual
+		~PcapSerializable()
+		{
+		}
+
+		/**
+		 * @brief Appends the Bytes of the PDU
+		 */
+		virtual void
+		serialize(std::vector<uint8_t>& bytes) const = 0;
+	};
+
+	/**
+	 * @brief Pseudo header in front of each captured packet
+	 */
+	struct PcapPacketHeader
+	{
+		enum Type
+		{
+			Unicast = 0,
+			Broadcast = 1,
+			Multicast = 2
+		};
+
+		/**
+		 * @brief Wire::getId of the wire
+		 */
+		uint32_t wire;
+
+		/**
+		 * @brief Sender id, numbered in the order of appearance
+		 */
+		uint32_t sender;
+
+		/**
+		 * @brief MAC address of the target (unicast), the group
+		 * (multicast) or -1 (broadcast)
+		 */
+		int32_t target;
+
+		/**
+		 * @brief Bits of the transmission (including the burst)
+		 */
+		uint32_t length;
+
+		uint16_t channel;
+
+		uint8_t collision;
+
+		/**
+		 * @brief Number of PDUs of the transmission (1 + burst)
+		 */
+		uint8_t pdus;
+
+		/**
+		 * @brief One of Type
+		 */
+		uint8_t type;
+
+		uint8_t reserved[3];
+	};
+
+	/**
+	 * @brief Writes the completed transmissions of a wire to a pcap
+	 * file
+	 *
+	 * Each packet consists of a PcapPacketHeader (host byte order)
+	 * followed by the content of the PDUs implementing PcapSerializable
+	 * if "payload" is set, truncated to the length of the transmission
+	 * and to snapLength Bytes. The original length of the packet is the
+	 * header plus the length of the transmission in Bytes. The time stamp (ns resolution) is the
+	 * completion time. Cancelled transmissions are not captured.
+	 *
+	 * The link type is LINKTYPE_USER0, the packets are written through
+	 * a buffer of bufferSize Bytes.
+	 */
+	class PcapCapture
+	{
+	public:
+		static const uint32_t magic = 0xa1b23c4d;
+
+		static const uint32_t linkType = 147;
+
+		/**
+		 * @brief Constructor (config keys "fileName", "payload",
+		 * "snapLength", "bufferSize")
+		 */
+		PcapCapture(const wns::pyconfig::View& config, unsigned int wireId);
+
+		PcapCapture(
+			const std::string& fileName,
+			unsigned int wireId,
+			bool payload,
+			uint32_t snapLength,
+			size_t bufferSize);
+
+		/**
+		 * @brief Destructor, writes the buffered packets
+		 */
+		~PcapCapture();
+
+		/**
+		 * @brief Writes a packet for the completed transmission
+		 *
+		 * @param target MAC address (integer), group or -1 for
+		 * broadcast (see PcapPacketHeader::target)
+		 */
+		void
+		capture(
+			const TransmissionPtr& t,
+			PcapPacketHeader::Type type,
+			int32_t target);
+
+		/**
+		 * @brief Writes the buffered packets to the file
+		 */
+		void
+		flush();
+
+		unsigned long
+		getNumberOfPackets() const;
+
+	private:
+		PcapCapture(const PcapCapture&);
+
+		PcapCapture&
+		operator=(const PcapCapture&);
+
+		void
+		open(const std::string& fileName);
+
+		uint32_t
+		getSenderId(const TransmitterDataSentInterface* sender);
+
+		static void
+		serialize(const wns::osi::PDUPtr& pdu, std::vector<uint8_t>& bytes);
+
+		unsigned int wireId;
+
+		bool payload;
+
+		uint32_t snapLength;
+
+		/**
+		 * @brief Stream buffer (used by out)
+		 */
+		std::vector<char> buffer;
+
+		std::ofstream out;
+
+		/**
+		 * @brief Reused for the payload of each packet
+		 */
+		std::vector<uint8_t> bytes;
+
+		unsigned long packets;
+
+		std::map<const TransmitterDataSentInterface*, uint32_t> senders;
+	};
+}
+
+#endif // NOT defined COPPER_PCAPCAPTURE_HPP
@@ -0,0 +1,111 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include <COPPER/Profiling.hpp>
+
+#include <iomanip>
+
+using namespace copper::profiling;
+
+const unsigned int Profiler::maxScopes;
+
+__thread ScopeCounter Profiler::counters[Profiler::maxScopes];
+
+std::vector<std::string>&
+Profiler::getNames()
+{
+	static std::vector<std::string> names;
+	return names;
+}
+
+unsigned int
+Profiler::registerScope(const std::string& name)
+{
+	std::vector<std::string>& names = getNames();
+	for (unsigned int ii = 0; ii < names.size(); ++ii)
+	{
+		if (names[ii] == name)
+		{
+			return ii;
+		}
+	}
+
+	assure(names.size() < maxScopes, "Too many profiling scopes");
+	names.push_back(name);
+	return names.size() - 1;
+}
+
+unsigned int
+Profiler::getNumberOfScopes()
+{
+	return getNames().size();
+}
+
+std::string
+Profiler::getName(unsigned int id)
+{
+	assure(id < getNames().size(), "Invalid scope id");
+	return getNames()[id];
+}
+
+void
+Profiler::reset()
+{
+	for (unsigned int ii = 0; ii < maxScopes; ++ii)
+	{
+		counters[ii].calls = 0;
+		counters[ii].cycles = 0;
+	}
+}
+
+void
+Profiler::write(const wns::logger::Logger& logger)
+{
+	uint64_t total = 0;
+	for (unsigned int ii = 0; ii < getNumberOfScopes(); ++ii)
+	{
+		total += counters[ii].cycles;
+	}
+
+	for (unsigned int ii = 0; ii < getNumberOfScopes(); ++ii)
+	{
+		const ScopeCounter& c = counters[ii];
+		if (c.calls == 0)
+		{
+			continue;
+		}
+
+		MESSAGE_BEGIN(NORMAL, logger, m, "Profile ");
+		m << std::left << std::setw(40) << getName(ii) << std::right
+		  << " calls " << std::setw(12) << c.calls
+		  << " cycles " << std::setw(16) << c.cycles
+		  << " cycles/call " << std::setw(10) << c.cycles / c.calls
+		  << " share " << std::fixed << std::setprecision(1)
+		  << (total > 0 ? 100.0 * c.cycles / total : 0.0) << "%";
+		MESSAGE_END();
+	}
+}
@@ -0,0 +1,163 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#ifndef COPPER_PROFILING_HPP
+#define COPPER_PROFILING_HPP
+
+#include <WNS/logger/Logger.hpp>
+
+#include <stdint.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Profiling scopes of the copper hot paths
+ *
+ * COPPER_PROFILE_SCOPE("name") counts the calls and the cycles (TSC,
+ * monotonic clock in ns on other architectures) spent until the end of
+ * the enclosing block. Nested scopes are inclusive. The macro compiles
+ * to nothing unless copper is built with -DCOPPER_PROFILING, the
+ * breakdown is then written at shutdown of the Copper module.
+ */
+#ifdef COPPER_PROFILING
+#define COPPER_PROFILE_CONCAT2(a, b) a##b
+#define COPPER_PROFILE_CONCAT(a, b) COPPER_PROFILE_CONCAT2(a, b)
+#define COPPER_PROFILE_SCOPE(name) \
+	static const unsigned int COPPER_PROFILE_CONCAT(copperProfileId, __LINE__) = \
+		copper::profiling::Profiler::registerScope(name); \
+	copper::profiling::Scope COPPER_PROFILE_CONCAT(copperProfileScope, __LINE__)( \
+		COPPER_PROFILE_CONCAT(copperProfileId, __LINE__))
+#else
+#define COPPER_PROFILE_SCOPE(name)
+#endif
+
+namespace copper { namespace profiling {
+
+	struct ScopeCounter
+	{
+		uint64_t calls;
+
+		uint64_t cycles;
+	};
+
+	/**
+	 * @brief Registry of the scopes and their counters
+	 *
+	 * The counters are thread local, so no synchronization is needed on
+	 * the hot path. getCounter and write see the counters of the
+	 * calling thread (the simulation thread).
+	 */
+	class Profiler
+	{
+	public:
+		static const unsigned int maxScopes = 64;
+
+		/**
+		 * @brief Returns the id of the scope, scopes with equal names
+		 * share the id
+		 */
+		static unsigned int
+		registerScope(const std::string& name);
+
+		static unsigned int
+		getNumberOfScopes();
+
+		static std::string
+		getName(unsigned int id);
+
+		static ScopeCounter&
+		getCounter(unsigned int id)
+		{
+			return counters[id];
+		}
+
+		static uint64_t
+		readCycles()
+		{
+#if defined(__i386__) || defined(__x86_64__)
+			uint32_t lo;
+			uint32_t hi;
+			__asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+			return (static_cast<uint64_t>(hi) << 32) | lo;
+#else
+			timespec ts;
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+			return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#endif
+		}
+
+		/**
+		 * @brief Sets all counters of the calling thread to 0
+		 */
+		static void
+		reset();
+
+		/**
+		 * @brief Writes calls, cycles, cycles per call and share of the
+		 * total of each scope that has been entered (the shares of
+		 * nested scopes overlap)
+		 */
+		static void
+		write(const wns::logger::Logger& logger);
+
+	private:
+		static std::vector<std::string>&
+		getNames();
+
+		static __thread ScopeCounter counters[maxScopes];
+	};
+
+	/**
+	 * @brief Adds the cycles from construction to destruction to the
+	 * counter of the scope
+	 */
+	class Scope
+	{
+	public:
+		explicit
+		Scope(unsigned int id) :
+			counter(Profiler::getCounter(id)),
+			begin(Profiler::readCycles())
+		{}
+
+		~Scope()
+		{
+			this->counter.cycles += Profiler::readCycles() - this->begin;
+			++this->counter.calls;
+		}
+
+	private:
+		ScopeCounter& counter;
+
+		uint64_t begin;
+	};
+
+} // profiling
+} // copper
+
+#endif // NOT defined COPPER_PROFILING_HPP
@@ -28,37 +28,80 @@
 #include <COPPER/Receiver.hpp>
 #include <COPPER/Wire.hpp>
 #include <COPPER/Transmission.hpp>
+#include <COPPER/Profiling.hpp>
+#include <COPPER/Logging.hpp>
 #include <WNS/events/MemberFunction.hpp>
+#include <WNS/Exception.hpp>
+#include <algorithm>
 #include <string>
+#include <typeinfo>
 
 using namespace copper;
 
 Receiver::Receiver(const wns::pyconfig::View& _pyco, WireInterface* _wire) :
 	macAddress(),
 	wire(_wire),
+	channel(_pyco.get<ChannelId>("channel")),
 	berDist(NULL),
+	berPolicy(DistributionPolicy),
+	constantBER(),
+	distributionBER(),
 	sensingTime(_pyco.get<simTimeType>("sensingTime")),
+	broadcastReception(_pyco.get<bool>("broadcast")),
+	groups(),
+	carrierSensingObservers(0),
 	logger(_pyco.get("logger"))
 {
+	// before the distribution is created, nothing to clean up
+	if (this->channel >= this->wire->getNumberOfChannels())
+	{
+		wns::Exception e;
+		e << "Channel " << this->channel << " not available, wire has only "
+		  << this->wire->getNumberOfChannels() << " channel(s)";
+		throw e;
+	}
+
+	for (int ii = 0; ii < _pyco.len("groups"); ++ii)
+	{
+		this->groups.push_back(_pyco.get<GroupId>("groups", ii));
+	}
+
 	wns::pyconfig::View distConfig = _pyco.get("ber");
 	wns::distribution::DistributionCreator* dc =
 		wns::distribution::DistributionFactory::creator(distConfig.get<std::string>("__plugin__"));
 	this->berDist = dc->create(distConfig);
+
+	// a Fixed distribution is drawn once, only if its type is exactly
+	// Fixed (subclasses may override operator())
+	if (typeid(*this->berDist) == typeid(wns::distribution::Fixed))
+	{
+		this->berPolicy = ConstantPolicy;
+		this->constantBER = ConstantBER((*this->berDist)());
+	}
+	else
+	{
+		this->berPolicy = DistributionPolicy;
+		this->distributionBER = DistributionBER(this->berDist);
+	}
 }
 
 Receiver::~Receiver()
 {
+	delete this->berDist;
 }
 
 bool
 Receiver::onData(const UnicastTransmissionPtr& transmission)
 {
-	if (this->macAddress == transmission->target)
+	COPPER_PROFILE_SCOPE("Receiver::onData(unicast)");
+	if (this->macAddress == transmission->target &&
+	    this->channel == transmission->channel)
 	{
-		double ber = (*berDist)();
-		MESSAGE_SINGLE(NORMAL, this->logger, "Received unicast data with BER: " << ber);
-		this->wns::Subject<Handler>::forEachObserver(
-			OnData(transmission->pdu, ber, transmission->collision));
+		COPPER_FRAME_RECORD(
+			NORMAL, this->logger,
+			ReceiverUnicast, this->macAddress.getInteger(), -1, this->channel, 0.0,
+			"Received unicast data");
+		this->deliver(transmission);
 		return true;
 	}
 	else
@@ -70,16 +113,86 @@ Receiver::onData(const UnicastTransmissionPtr& transmission)
 bool
 Receiver::onData(const BroadcastTransmissionPtr& transmission)
 {
-	double ber = (*berDist)();
-	MESSAGE_SINGLE(NORMAL, this->logger, "Received broadcast data with BER: " << ber);
-	this->wns::Subject<Handler>::forEachObserver(
-		OnData(transmission->pdu, ber, transmission->collision));
+	COPPER_PROFILE_SCOPE("Receiver::onData(broadcast)");
+	if (this->channel != transmission->channel)
+	{
+		return false;
+	}
+
+	COPPER_FRAME_RECORD(
+		NORMAL, this->logger,
+		ReceiverBroadcast, this->macAddress.getInteger(), -1, this->channel, 0.0,
+		"Received broadcast data");
+	this->deliver(transmission);
+	return true;
+}
+
+bool
+Receiver::onData(const MulticastTransmissionPtr& transmission)
+{
+	COPPER_PROFILE_SCOPE("Receiver::onData(multicast)");
+	if (this->channel != transmission->channel)
+	{
+		return false;
+	}
+
+	COPPER_FRAME_RECORD(
+		NORMAL, this->logger,
+		ReceiverMulticast, this->macAddress.getInteger(), transmission->group, this->channel, 0.0,
+		"Received multicast data for group " << transmission->group);
+	this->deliver(transmission);
 	return true;
 }
 
 void
-Receiver::onCopperFree()
+Receiver::deliver(const TransmissionPtr& transmission)
 {
+	if (this->berPolicy == ConstantPolicy)
+	{
+		this->deliver(transmission, this->constantBER);
+	}
+	else
+	{
+		this->deliver(transmission, this->distributionBER);
+	}
+}
+
+template <typename BERPOLICY>
+void
+Receiver::deliver(const TransmissionPtr& transmission, const BERPOLICY& berPolicy)
+{
+	this->deliver(transmission->pdu, berPolicy(), transmission->collision);
+
+	// each PDU of a burst gets its own BER
+	for (
+		PDUContainer::const_iterator itr = transmission->burst.begin();
+		itr != transmission->burst.end();
+		++itr)
+	{
+		this->deliver(*itr, berPolicy(), transmission->collision);
+	}
+}
+
+void
+Receiver::deliver(const wns::osi::PDUPtr& pdu, double ber, bool collision)
+{
+	COPPER_DETAIL_RECORD(
+		NORMAL, this->logger,
+		ReceiverDeliver, this->macAddress.getInteger(), -1, this->channel, ber,
+		"Delivering PDU with BER: " << ber);
+	this->wns::Subject<Handler>::forEachObserver(
+		OnData(pdu, ber, collision));
+}
+
+void
+Receiver::onCopperFree(ChannelId _channel)
+{
+	COPPER_PROFILE_SCOPE("Receiver::onCopperFree");
+	if (this->channel != _channel)
+	{
+		return;
+	}
+
 	this->wns::Subject<CarrierSensing>::forEachObserver(
 		wns::events::DelayedMemberFunction<CarrierSensing>(
 			&CarrierSensing::onCarrierIdle,
@@ -87,8 +200,14 @@ Receiver::onCopperFree()
 }
 
 void
-Receiver::onCopperBusy()
+Receiver::onCopperBusy(ChannelId _channel)
 {
+	COPPER_PROFILE_SCOPE("Receiver::onCopperBusy");
+	if (this->channel != _channel)
+	{
+		return;
+	}
+
 	this->wns::Subject<CarrierSensing>::forEachObserver(
 		wns::events::DelayedMemberFunction<CarrierSensing>(
 			&CarrierSensing::onCarrierBusy,
@@ -96,14 +215,31 @@ Receiver::onCopperBusy()
 }
 
 void
-Receiver::onCollision()
+Receiver::onCollision(ChannelId _channel)
 {
+	if (this->channel != _channel)
+	{
+		return;
+	}
+
 	this->wns::Subject<CarrierSensing>::forEachObserver(
 		wns::events::DelayedMemberFunction<CarrierSensing>(
 			&CarrierSensing::onCollision,
 			this->sensingTime));
 }
 
+bool
+Receiver::isCarrierBusyAt(simTimeType t) const
+{
+	return this->wire->isCarrierBusyAt(this->channel, t, this->sensingTime);
+}
+
+Receiver::BerPolicyType
+Receiver::getBerPolicy() const
+{
+	return this->berPolicy;
+}
+
 void
 Receiver::setDLLUnicastAddress(const wns::service::dll::UnicastAddress& _macAddress)
 {
@@ -111,7 +247,79 @@ Receiver::setDLLUnicastAddress(const wns::service::dll::UnicastAddress& _macAddr
 	assure(_macAddress.isValid() == true, "Provided invalid MAC address!");
 
 	this->macAddress = _macAddress;
-	this->wire->addReceiver(this, this->macAddress);
+	this->wire->addReceiver(this, this->macAddress, this->carrierSensingObservers > 0);
+	if (!this->broadcastReception)
+	{
+		this->wire->setBroadcastSubscription(this, false);
+	}
+	for (size_t ii = 0; ii < this->groups.size(); ++ii)
+	{
+		this->wire->setGroupMembership(this->groups[ii], this, true);
+	}
+}
+
+void
+Receiver::addObserver(CarrierSensingSubject::ObserverType* observer)
+{
+	this->CarrierSensingSubject::addObserver(observer);
+
+	++this->carrierSensingObservers;
+	if (this->carrierSensingObservers == 1 && this->macAddress.isValid())
+	{
+		this->wire->setCarrierSenseInterest(this, true);
+	}
+}
+
+void
+Receiver::removeObserver(CarrierSensingSubject::ObserverType* observer)
+{
+	this->CarrierSensingSubject::removeObserver(observer);
+
+	assure(this->carrierSensingObservers > 0, "No CarrierSensing observer attached");
+	--this->carrierSensingObservers;
+	if (this->carrierSensingObservers == 0 && this->macAddress.isValid())
+	{
+		this->wire->setCarrierSenseInterest(this, false);
+	}
+}
+
+void
+Receiver::setGroupMembership(GroupId group, bool member)
+{
+	std::vector<GroupId>::iterator itr =
+		std::find(this->groups.begin(), this->groups.end(), group);
+	if (member && itr == this->groups.end())
+	{
+		this->groups.push_back(group);
+	}
+	else if (!member && itr != this->groups.end())
+	{
+		this->groups.erase(itr);
+	}
+
+	// before the address is set the receiver is not at the wire yet
+	if (this->macAddress.isValid())
+	{
+		this->wire->setGroupMembership(group, this, member);
+	}
+}
+
+void
+Receiver::setBroadcastReception(bool enabled)
+{
+	this->broadcastReception = enabled;
+
+	// before the address is set the receiver is not at the wire yet
+	if (this->macAddress.isValid())
+	{
+		this->wire->setBroadcastSubscription(this, enabled);
+	}
+}
+
+bool
+Receiver::isBroadcastReceptionEnabled() const
+{
+	return this->broadcastReception;
 }
 
 
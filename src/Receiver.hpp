@@ -30,6 +30,7 @@
 
 #include <COPPER/Transmission.hpp>
 #include <COPPER/ReceiverInterface.hpp>
+#include <COPPER/BerPolicy.hpp>
 
 #include <WNS/service/phy/copper/Handler.hpp>
 #include <WNS/service/phy/copper/CarrierSensing.hpp>
@@ -40,6 +41,8 @@
 #include <WNS/pyconfig/View.hpp>
 #include <WNS/Subject.hpp>
 
+#include <vector>
+
 namespace copper {
 
 	class WireInterface;
@@ -48,7 +51,13 @@ namespace copper {
 	 * @brief A simple Receiver with configurable BER patterns
 	 *
 	 * The BER patterns can be any distribution available in WNS (or a
-	 * combination of any distribution).
+	 * combination of any distribution). The BER policy used per PDU is
+	 * selected from the type of the distribution: the value of a Fixed
+	 * distribution is drawn once, all others (including TimeDependent
+	 * and subclasses of Fixed) are drawn per PDU through the
+	 * Distribution interface. The receiver only listens to
+	 * one channel of the wire, transmissions and carrier events on
+	 * other channels are ignored.
 	 */
 	class Receiver :
 		virtual public wns::service::phy::copper::Notification,
@@ -60,6 +69,9 @@ namespace copper {
 		typedef wns::service::phy::copper::CarrierSensing
 		CarrierSensing;
 
+		typedef wns::Subject<CarrierSensing>
+		CarrierSensingSubject;
+
 		/**
 		 * @brief Used as functor to Handler::onDataCalls
 		 */
@@ -85,6 +97,15 @@ namespace copper {
 		};
 
 	public:
+		/**
+		 * @brief See getBerPolicy
+		 */
+		enum BerPolicyType
+		{
+			ConstantPolicy,
+			DistributionPolicy
+		};
+
 		/**
 		 * @brief Constructor
 		 */
@@ -106,14 +127,17 @@ namespace copper {
 		virtual bool
 		onData(const BroadcastTransmissionPtr& transmission);
 
+		virtual bool
+		onData(const MulticastTransmissionPtr& transmission);
+
 		virtual void
-		onCopperFree();
+		onCopperFree(ChannelId channel);
 
 		virtual void
-		onCopperBusy();
+		onCopperBusy(ChannelId channel);
 
 		virtual void
-		onCollision();
+		onCollision(ChannelId channel);
 		//@}
 
 		/**
@@ -124,7 +148,78 @@ namespace copper {
 		setDLLUnicastAddress(const wns::service::dll::UnicastAddress& _macAddress);
 		//@}
 
+		/**
+		 * @brief Subscribe to or unsubscribe from the broadcasts of
+		 * the wire (initially configured by "broadcast")
+		 */
+		void
+		setBroadcastReception(bool enabled);
+
+		bool
+		isBroadcastReceptionEnabled() const;
+
+		/**
+		 * @name wns::Subject<CarrierSensing>
+		 *
+		 * The receiver is only interested in the carrier state of the
+		 * wire (see WireInterface::setCarrierSenseInterest) while
+		 * CarrierSensing observers are attached.
+		 */
+		//@{
+		virtual void
+		addObserver(CarrierSensingSubject::ObserverType* observer);
+
+		virtual void
+		removeObserver(CarrierSensingSubject::ObserverType* observer);
+		//@}
+
+		/**
+		 * @brief True if the carrier was sensed busy at time t (t <=
+		 * now), i.e. onCarrierBusy had been called without a
+		 * following onCarrierIdle
+		 *
+		 * Answered by the wire without observers, MACs that only
+		 * need the carrier state at decision points may query it
+		 * instead of attaching a CarrierSensing observer.
+		 */
+		bool
+		isCarrierBusyAt(simTimeType t) const;
+
+		/**
+		 * @brief The BER policy selected for the configured
+		 * distribution
+		 */
+		BerPolicyType
+		getBerPolicy() const;
+
+		/**
+		 * @brief Join or leave a multicast group of the wire
+		 * (initially the groups configured by "groups")
+		 */
+		void
+		setGroupMembership(GroupId group, bool member);
+
 	private:
+		/**
+		 * @brief Hand all PDUs of the transmission to the Handlers
+		 * (selects the BER policy once per transmission)
+		 */
+		void
+		deliver(const TransmissionPtr& transmission);
+
+		/**
+		 * @brief Draws the BER of each PDU with the policy
+		 */
+		template <typename BERPOLICY>
+		void
+		deliver(const TransmissionPtr& transmission, const BERPOLICY& berPolicy);
+
+		/**
+		 * @brief Hand a single PDU with its BER to the Handlers
+		 */
+		void
+		deliver(const wns::osi::PDUPtr& pdu, double ber, bool collision);
+
 		/**
 		 * @brief MAC Address of the higher layerx
 		 */
@@ -136,10 +231,25 @@ namespace copper {
 		WireInterface* wire;
 
 		/**
-		 * @brief Distribution of BER
+		 * @brief Channel of the wire, this receiver is listening to
+		 */
+		ChannelId channel;
+
+		/**
+		 * @brief Distribution of BER (owned)
 		 */
 		wns::distribution::Distribution* berDist;
 
+		BerPolicyType berPolicy;
+
+		/**
+		 * @brief The policies, only the one selected by berPolicy is
+		 * valid
+		 */
+		ConstantBER constantBER;
+
+		DistributionBER distributionBER;
+
 		/**
 		 * @brief Sensing time
 		 *
@@ -148,6 +258,22 @@ namespace copper {
 		 */
 		simTimeType sensingTime;
 
+		/**
+		 * @brief See setBroadcastReception
+		 */
+		bool broadcastReception;
+
+		/**
+		 * @brief Multicast groups joined when the receiver is added to
+		 * the wire
+		 */
+		std::vector<GroupId> groups;
+
+		/**
+		 * @brief Number of attached CarrierSensing observers
+		 */
+		unsigned int carrierSensingObservers;
+
 		/**
 		 * @brief Logger
 		 */
@@ -28,6 +28,8 @@
 #ifndef COPPER_RECEIVERINTERFACE_HPP
 #define COPPER_RECEIVERINTERFACE_HPP
 
+#include <COPPER/Transmission.hpp>
+
 namespace copper {
 
 	/**
@@ -69,22 +71,29 @@ namespace copper {
 		onData(const BroadcastTransmissionPtr& transmission) = 0;
 
 		/**
-		 * @brief Called, if the wire got free
+		 * @brief Data (multicast) for a group this receiver is member
+		 * of arrived
+		 */
+		virtual bool
+		onData(const MulticastTransmissionPtr& transmission) = 0;
+
+		/**
+		 * @brief Called, if the channel of the wire got free
 		 */
 		virtual void
-		onCopperFree() = 0;
+		onCopperFree(ChannelId channel) = 0;
 
 		/**
-		 * @brief Called, if the wire got busy
+		 * @brief Called, if the channel of the wire got busy
 		 */
 		virtual void
-		onCopperBusy() = 0;
+		onCopperBusy(ChannelId channel) = 0;
 
 		/**
-		 * @brief Called, if a collision occured
+		 * @brief Called, if a collision occured on the channel
 		 */
 		virtual void
-		onCollision() = 0;
+		onCollision(ChannelId channel) = 0;
 	};
 } // copper
 
@@ -0,0 +1,168 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include <COPPER/ScalingReport.hpp>
+#include <COPPER/Wire.hpp>
+
+#include <WNS/events/scheduler/Interface.hpp>
+
+#include <sys/resource.h>
+#include <fstream>
+
+using namespace copper;
+
+ScalingReport&
+ScalingReport::getInstance()
+{
+	static ScalingReport report;
+	return report;
+}
+
+ScalingReport::ScalingReport() :
+	enabled(false),
+	fileName(),
+	trafficSources(0),
+	generated(0),
+	received(0),
+	logger("COPPER", "ScalingReport")
+{
+	gettimeofday(&this->configured, NULL);
+	this->worldCreated = this->configured;
+}
+
+void
+ScalingReport::configure(const wns::pyconfig::View& config)
+{
+	this->enabled = true;
+	if (!config.isNone("fileName"))
+	{
+		this->fileName = config.get<std::string>("fileName");
+	}
+	this->logger = wns::logger::Logger(config.get("logger"));
+	gettimeofday(&this->configured, NULL);
+	this->worldCreated = this->configured;
+}
+
+bool
+ScalingReport::isEnabled() const
+{
+	return this->enabled;
+}
+
+void
+ScalingReport::onWorldCreated()
+{
+	if (this->trafficSources == 0)
+	{
+		gettimeofday(&this->worldCreated, NULL);
+	}
+	++this->trafficSources;
+}
+
+void
+ScalingReport::write() const
+{
+	if (!this->enabled)
+	{
+		return;
+	}
+
+	timeval now;
+	gettimeofday(&now, NULL);
+	double startupTime = getSeconds(this->configured, this->worldCreated);
+	double wallTime = getSeconds(this->worldCreated, now);
+
+	unsigned long frames = 0;
+	unsigned long collisions = 0;
+	for (
+		std::list<Wire*>::const_iterator itr = Wire::getWires().begin();
+		itr != Wire::getWires().end();
+		++itr)
+	{
+		WireCounters c = (*itr)->getCounters();
+		frames += c.framesCompleted;
+		collisions += c.collisions;
+	}
+	// not the number of events processed by the scheduler
+	unsigned long modelEvents = this->generated + frames;
+	double modelEventsPerSecond = wallTime > 0.0 ? modelEvents / wallTime : 0.0;
+	long peakRSS = getPeakRSS();
+
+	MESSAGE_BEGIN(NORMAL, this->logger, m, "Scaling report: ");
+	m << this->trafficSources << " traffic sources on "
+	  << Wire::getWires().size() << " wires"
+	  << ", startup " << startupTime << "s"
+	  << ", wall time " << wallTime << "s"
+	  << ", simulated " << wns::simulator::getEventScheduler()->getTime() << "s"
+	  << ", model events " << modelEvents
+	  << " (" << modelEventsPerSecond << "/s)"
+	  << ", PDUs generated " << this->generated
+	  << ", received " << this->received
+	  << ", frames " << frames
+	  << ", collisions " << collisions
+	  << ", peak RSS " << peakRSS << "kB";
+	MESSAGE_END();
+
+	if (this->fileName.empty())
+	{
+		return;
+	}
+
+	std::ofstream out(this->fileName.c_str());
+	out << "{\n"
+	    << "  \"trafficSources\": " << this->trafficSources << ",\n"
+	    << "  \"wires\": " << Wire::getWires().size() << ",\n"
+	    << "  \"startupTime\": " << startupTime << ",\n"
+	    << "  \"wallTime\": " << wallTime << ",\n"
+	    << "  \"simTime\": " << wns::simulator::getEventScheduler()->getTime() << ",\n"
+	    << "  \"modelEvents\": " << modelEvents << ",\n"
+	    << "  \"modelEventsPerSecond\": " << modelEventsPerSecond << ",\n"
+	    << "  \"pdusGenerated\": " << this->generated << ",\n"
+	    << "  \"pdusReceived\": " << this->received << ",\n"
+	    << "  \"frames\": " << frames << ",\n"
+	    << "  \"collisions\": " << collisions << ",\n"
+	    << "  \"peakRSS\": " << peakRSS << "\n"
+	    << "}\n";
+}
+
+long
+ScalingReport::getPeakRSS()
+{
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+	{
+		return -1;
+	}
+	// kB on Linux
+	return usage.ru_maxrss;
+}
+
+double
+ScalingReport::getSeconds(const timeval& begin, const timeval& end)
+{
+	return (end.tv_sec - begin.tv_sec) + (end.tv_usec - begin.tv_usec) * 1E-6;
+}
@@ -0,0 +1,123 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#ifndef COPPER_SCALINGREPORT_HPP
+#define COPPER_SCALINGREPORT_HPP
+
+#include <WNS/pyconfig/View.hpp>
+#include <WNS/logger/Logger.hpp>
+
+#include <sys/time.h>
+#include <string>
+
+namespace copper
+{
+	/**
+	 * @brief Collects the figures of the scaling benchmark (see
+	 * copper/ScalingScenario.py)
+	 *
+	 * The startup time is measured from the configuration of the Copper
+	 * module until the first TrafficSource sees the world created, the
+	 * run time from there until shutdown. The model events are the PDUs
+	 * generated by the traffic sources plus the completed frames of all
+	 * wires. They are not the events processed by the scheduler, which
+	 * also include the events of other modules, cancelled frames and
+	 * TDMA slots.
+	 */
+	class ScalingReport
+	{
+	public:
+		static ScalingReport&
+		getInstance();
+
+		/**
+		 * @brief Enables the report (config keys "fileName",
+		 * "logger"), starts the startup clock
+		 */
+		void
+		configure(const wns::pyconfig::View& config);
+
+		bool
+		isEnabled() const;
+
+		/**
+		 * @brief Called by each TrafficSource, the first call ends the
+		 * startup phase
+		 */
+		void
+		onWorldCreated();
+
+		void
+		onPDUGenerated()
+		{
+			++this->generated;
+		}
+
+		void
+		onPDUReceived()
+		{
+			++this->received;
+		}
+
+		/**
+		 * @brief Logs the report and writes it as JSON (if a file name
+		 * is configured)
+		 */
+		void
+		write() const;
+
+	private:
+		ScalingReport();
+
+		/**
+		 * @brief Peak resident set size in kB
+		 */
+		static long
+		getPeakRSS();
+
+		static double
+		getSeconds(const timeval& begin, const timeval& end);
+
+		bool enabled;
+
+		std::string fileName;
+
+		timeval configured;
+
+		timeval worldCreated;
+
+		unsigned long trafficSources;
+
+		unsigned long generated;
+
+		unsigned long received;
+
+		wns::logger::Logger logger;
+	};
+}
+
+#endif // NOT defined COPPER_SCALINGREPORT_HPP
@@ -0,0 +1,249 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include <COPPER/TDMAExecutor.hpp>
+#include <COPPER/Logging.hpp>
+
+#include <WNS/Exception.hpp>
+
+#include <cmath>
+#include <algorithm>
+
+using namespace copper;
+
+TDMAExecutor::TDMAExecutor(const wns::pyconfig::View& config) :
+	schedule(),
+	slotDuration(config.get<simTimeType>("slotDuration")),
+	stations(),
+	backloggedSlots(),
+	grantEvent(),
+	grantPending(false),
+	grantedSlot(0),
+	nextSlot(0),
+	logger(config.get<wns::pyconfig::View>("logger"))
+{
+	if (this->slotDuration <= 0.0)
+	{
+		throw wns::Exception("TDMA slot duration must be > 0.0");
+	}
+
+	for (int ii = 0; ii < config.len("slots"); ++ii)
+	{
+		int id = config.get<int>("slots", ii);
+		this->schedule.push_back(id);
+		if (id != unusedSlot)
+		{
+			this->stations[id].slots.push_back(ii);
+		}
+	}
+
+	if (this->schedule.empty())
+	{
+		throw wns::Exception("TDMA schedule must contain at least one slot");
+	}
+
+	MESSAGE_BEGIN(NORMAL, this->logger, m, "Created TDMA executor: ");
+	m << this->schedule.size() << " slots of " << this->slotDuration
+	  << "s, " << this->stations.size() << " stations";
+	MESSAGE_END();
+}
+
+TDMAExecutor::~TDMAExecutor()
+{
+	if (this->grantPending)
+	{
+		wns::simulator::getEventScheduler()->cancelEvent(this->grantEvent);
+	}
+}
+
+void
+TDMAExecutor::addStation(int id, TransmitOpportunityInterface* transmitter)
+{
+	assure(transmitter, "must be non-NULL");
+
+	Station& station = this->getStation(id);
+	if (station.transmitter != NULL)
+	{
+		wns::Exception e;
+		e << "TDMA station " << id << " is already registered";
+		throw e;
+	}
+	station.transmitter = transmitter;
+
+	MESSAGE_SINGLE(
+		NORMAL, this->logger,
+		"Added station " << id << " owning " << station.slots.size() << " slot(s)");
+}
+
+void
+TDMAExecutor::removeStation(int id)
+{
+	this->onIdle(id);
+	this->getStation(id).transmitter = NULL;
+}
+
+void
+TDMAExecutor::onBacklogged(int id)
+{
+	Station& station = this->getStation(id);
+	assure(station.transmitter != NULL, "Station not registered");
+
+	if (station.backlogged)
+	{
+		return;
+	}
+
+	station.backlogged = true;
+	this->backloggedSlots.insert(station.slots.begin(), station.slots.end());
+
+	COPPER_FRAME_MESSAGE(NORMAL, this->logger, "Station " << id << " is backlogged");
+
+	this->scheduleNextGrant(this->getFirstUngrantedSlot());
+}
+
+void
+TDMAExecutor::onIdle(int id)
+{
+	Station& station = this->getStation(id);
+
+	if (!station.backlogged)
+	{
+		return;
+	}
+
+	station.backlogged = false;
+	for (
+		std::vector<size_t>::const_iterator itr = station.slots.begin();
+		itr != station.slots.end();
+		++itr)
+	{
+		this->backloggedSlots.erase(*itr);
+	}
+
+	COPPER_FRAME_MESSAGE(NORMAL, this->logger, "Station " << id << " is idle");
+
+	this->scheduleNextGrant(this->getFirstUngrantedSlot());
+}
+
+simTimeType
+TDMAExecutor::getSlotDuration() const
+{
+	return this->slotDuration;
+}
+
+void
+TDMAExecutor::onSlotStart()
+{
+	assure(this->grantPending, "No slot granted");
+
+	this->grantPending = false;
+	SlotNumber slot = this->grantedSlot;
+	this->nextSlot = slot + 1;
+
+	Station& station = this->getStation(this->schedule[slot % this->schedule.size()]);
+	assure(station.backlogged, "Slot granted to idle station");
+
+	COPPER_FRAME_MESSAGE(NORMAL, this->logger, "Granting slot " << slot);
+
+	// may call onBacklogged/onIdle and thus already schedule the next
+	// grant
+	station.transmitter->onTransmitOpportunity(this->slotDuration);
+
+	if (!this->grantPending)
+	{
+		this->scheduleNextGrant(this->nextSlot);
+	}
+}
+
+void
+TDMAExecutor::scheduleNextGrant(SlotNumber from)
+{
+	wns::events::scheduler::Interface* scheduler = wns::simulator::getEventScheduler();
+
+	if (this->backloggedSlots.empty())
+	{
+		if (this->grantPending)
+		{
+			scheduler->cancelEvent(this->grantEvent);
+			this->grantPending = false;
+		}
+		return;
+	}
+
+	const size_t frameLength = this->schedule.size();
+	const size_t index = from % frameLength;
+
+	std::set<size_t>::const_iterator itr = this->backloggedSlots.lower_bound(index);
+	SlotNumber slot;
+	if (itr != this->backloggedSlots.end())
+	{
+		slot = from + (*itr - index);
+	}
+	else
+	{
+		// wrap to the next frame
+		slot = from + (frameLength - index) + *this->backloggedSlots.begin();
+	}
+
+	if (this->grantPending)
+	{
+		if (this->grantedSlot == slot)
+		{
+			return;
+		}
+		scheduler->cancelEvent(this->grantEvent);
+	}
+
+	this->grantedSlot = slot;
+	this->grantPending = true;
+	this->grantEvent = scheduler->schedule(SlotStartEvent(this), slot * this->slotDuration);
+}
+
+TDMAExecutor::SlotNumber
+TDMAExecutor::getFirstUngrantedSlot() const
+{
+	// tolerance avoids that a slot starting now is regarded as past due
+	// to rounding
+	const double tolerance = 1E-9;
+	SlotNumber current = static_cast<SlotNumber>(
+		std::ceil(wns::simulator::getEventScheduler()->getTime() / this->slotDuration - tolerance));
+
+	return std::max(current, this->nextSlot);
+}
+
+TDMAExecutor::Station&
+TDMAExecutor::getStation(int id)
+{
+	std::map<int, Station>::iterator itr = this->stations.find(id);
+	if (itr == this->stations.end())
+	{
+		wns::Exception e;
+		e << "TDMA station " << id << " has no slot in the schedule";
+		throw e;
+	}
+	return itr->second;
+}
@@ -0,0 +1,235 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#ifndef COPPER_TDMAEXECUTOR_HPP
+#define COPPER_TDMAEXECUTOR_HPP
+
+#include <WNS/events/scheduler/Interface.hpp>
+#include <WNS/pyconfig/View.hpp>
+#include <WNS/logger/Logger.hpp>
+
+#include <vector>
+#include <map>
+#include <set>
+
+namespace copper
+{
+	/**
+	 * @brief Interface of a station that is granted transmit
+	 * opportunities by the TDMAExecutor
+	 */
+	class TransmitOpportunityInterface
+	{
+	public:
+		/**
+		 * @brief Destructor
+		 */
+		virtual
+		~TransmitOpportunityInterface()
+		{}
+
+		/**
+		 * @brief The station may transmit now for at most "duration"
+		 * seconds
+		 */
+		virtual void
+		onTransmitOpportunity(simTimeType duration) = 0;
+	};
+
+	/**
+	 * @brief Grants the slots of a precomputed TDMA schedule to backlogged
+	 * stations
+	 *
+	 * The schedule is a table of station ids, one per slot, which is
+	 * repeated periodically (the TDMA frame). Stations register with their
+	 * id and report when they become backlogged or idle. Events are only
+	 * scheduled for slots that belong to a backlogged station, so the
+	 * number of events does not depend on the number of stations or
+	 * frames but on the actual traffic. No carrier sensing is done, the
+	 * schedule guarantees exclusive access.
+	 */
+	class TDMAExecutor
+	{
+		/**
+		 * @brief Absolute slot number (counted from time 0.0)
+		 */
+		typedef unsigned long SlotNumber;
+
+		/**
+		 * @brief Signals the start of a granted slot
+		 */
+		class SlotStartEvent
+		{
+		public:
+			explicit
+			SlotStartEvent(TDMAExecutor* e) :
+				executor(e)
+			{
+				assure(this->executor, "must be non-NULL");
+			}
+
+			void
+			operator()()
+			{
+				this->executor->onSlotStart();
+			}
+
+		private:
+			TDMAExecutor* executor;
+		};
+
+		struct Station
+		{
+			Station() :
+				transmitter(NULL),
+				slots(),
+				backlogged(false)
+			{}
+
+			/**
+			 * @brief NULL as long as the station has not registered
+			 */
+			TransmitOpportunityInterface* transmitter;
+
+			/**
+			 * @brief Indices of the slots within the frame owned by
+			 * this station
+			 */
+			std::vector<size_t> slots;
+
+			bool backlogged;
+		};
+
+	public:
+		/**
+		 * @brief Station id used to mark unused slots in the schedule
+		 */
+		static const int unusedSlot = -1;
+
+		/**
+		 * @brief Constructor
+		 */
+		explicit
+		TDMAExecutor(const wns::pyconfig::View& config);
+
+		/**
+		 * @brief Destructor
+		 */
+		~TDMAExecutor();
+
+		/**
+		 * @brief Register the station "id" of the schedule
+		 */
+		void
+		addStation(int id, TransmitOpportunityInterface* transmitter);
+
+		/**
+		 * @brief Deregister the station "id"
+		 */
+		void
+		removeStation(int id);
+
+		/**
+		 * @brief The station has data to transmit
+		 */
+		void
+		onBacklogged(int id);
+
+		/**
+		 * @brief The station has no more data to transmit
+		 */
+		void
+		onIdle(int id);
+
+		/**
+		 * @brief Duration of a single slot
+		 */
+		simTimeType
+		getSlotDuration() const;
+
+	private:
+		/**
+		 * @brief Called by SlotStartEvent
+		 */
+		void
+		onSlotStart();
+
+		/**
+		 * @brief (Re)schedules the SlotStartEvent for the first slot
+		 * >= "from" that belongs to a backlogged station
+		 */
+		void
+		scheduleNextGrant(SlotNumber from);
+
+		/**
+		 * @brief First slot which may still be granted
+		 */
+		SlotNumber
+		getFirstUngrantedSlot() const;
+
+		Station&
+		getStation(int id);
+
+		/**
+		 * @brief The schedule (station id per slot of the frame)
+		 */
+		std::vector<int> schedule;
+
+		simTimeType slotDuration;
+
+		/**
+		 * @brief Stations by id
+		 */
+		std::map<int, Station> stations;
+
+		/**
+		 * @brief Frame indices of all slots owned by backlogged stations
+		 */
+		std::set<size_t> backloggedSlots;
+
+		/**
+		 * @brief The pending SlotStartEvent (if grantPending)
+		 */
+		wns::events::scheduler::IEventPtr grantEvent;
+
+		bool grantPending;
+
+		/**
+		 * @brief The slot for which grantEvent is scheduled
+		 */
+		SlotNumber grantedSlot;
+
+		/**
+		 * @brief Slots before this one have already been granted
+		 */
+		SlotNumber nextSlot;
+
+		wns::logger::Logger logger;
+	};
+}
+
+#endif // NOT defined COPPER_TDMAEXECUTOR_HPP
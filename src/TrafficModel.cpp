@@ -0,0 +1,154 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include <COPPER/TrafficModel.hpp>
+
+#include <WNS/Exception.hpp>
+
+#include <cmath>
+#include <string>
+
+using namespace copper;
+
+TrafficModel::TrafficModel(const wns::pyconfig::View& config) :
+	type(CBR),
+	interArrivalTime(config.get<simTimeType>("interArrivalTime")),
+	meanOnTime(0.0),
+	meanOffTime(0.0),
+	onPeriodEnd(0.0),
+	uniform()
+{
+	std::string name = config.get<std::string>("type");
+	if (name == "CBR")
+	{
+		this->type = CBR;
+	}
+	else if (name == "Poisson")
+	{
+		this->type = Poisson;
+	}
+	else if (name == "OnOff")
+	{
+		this->type = OnOff;
+		this->meanOnTime = config.get<simTimeType>("meanOnTime");
+		this->meanOffTime = config.get<simTimeType>("meanOffTime");
+	}
+	else
+	{
+		wns::Exception e;
+		e << "TrafficModel: unknown type " << name;
+		throw e;
+	}
+
+	this->check();
+}
+
+TrafficModel::TrafficModel(
+	Type _type,
+	simTimeType _interArrivalTime,
+	simTimeType _meanOnTime,
+	simTimeType _meanOffTime) :
+
+	type(_type),
+	interArrivalTime(_interArrivalTime),
+	meanOnTime(_meanOnTime),
+	meanOffTime(_meanOffTime),
+	onPeriodEnd(0.0),
+	uniform()
+{
+	this->check();
+}
+
+void
+TrafficModel::check() const
+{
+	if (this->interArrivalTime <= 0.0)
+	{
+		wns::Exception e;
+		e << "TrafficModel: interArrivalTime must be > 0 (is "
+		  << this->interArrivalTime << ")";
+		throw e;
+	}
+
+	if (this->type == OnOff && (this->meanOnTime <= 0.0 || this->meanOffTime < 0.0))
+	{
+		wns::Exception e;
+		e << "TrafficModel: meanOnTime must be > 0 and meanOffTime >= 0 (are "
+		  << this->meanOnTime << ", " << this->meanOffTime << ")";
+		throw e;
+	}
+}
+
+simTimeType
+TrafficModel::start(simTimeType startTime)
+{
+	if (this->type == OnOff)
+	{
+		this->onPeriodEnd = startTime + this->drawExponential(this->meanOnTime);
+	}
+	return startTime;
+}
+
+simTimeType
+TrafficModel::next(simTimeType now)
+{
+	switch (this->type)
+	{
+	case Poisson:
+		return now + this->drawExponential(this->interArrivalTime);
+
+	case OnOff:
+	{
+		simTimeType next = now + this->interArrivalTime;
+		if (next <= this->onPeriodEnd)
+		{
+			return next;
+		}
+		// the next on period begins after the off period
+		next = this->onPeriodEnd + this->drawExponential(this->meanOffTime);
+		this->onPeriodEnd = next + this->drawExponential(this->meanOnTime);
+		return next;
+	}
+
+	case CBR:
+	default:
+		return now + this->interArrivalTime;
+	}
+}
+
+TrafficModel::Type
+TrafficModel::getType() const
+{
+	return this->type;
+}
+
+simTimeType
+TrafficModel::drawExponential(simTimeType mean)
+{
+	// uniform() is in [0, 1)
+	return -mean * std::log(1.0 - this->uniform());
+}
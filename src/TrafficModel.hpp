@@ -0,0 +1,112 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#ifndef COPPER_TRAFFICMODEL_HPP
+#define COPPER_TRAFFICMODEL_HPP
+
+#include <WNS/distribution/Uniform.hpp>
+#include <WNS/pyconfig/View.hpp>
+
+namespace copper
+{
+	/**
+	 * @brief Arrival process of the TrafficSource
+	 *
+	 * CBR: one PDU every interArrivalTime.
+	 *
+	 * Poisson: exponentially distributed inter arrival times with mean
+	 * interArrivalTime.
+	 *
+	 * OnOff: one PDU every interArrivalTime during on periods, no PDUs
+	 * during off periods. The durations of the periods are exponentially
+	 * distributed with mean meanOnTime and meanOffTime. Each on period
+	 * begins with a PDU.
+	 */
+	class TrafficModel
+	{
+	public:
+		enum Type
+		{
+			CBR,
+			Poisson,
+			OnOff
+		};
+
+		/**
+		 * @brief Constructor (config keys "type", "interArrivalTime",
+		 * "meanOnTime", "meanOffTime")
+		 */
+		explicit
+		TrafficModel(const wns::pyconfig::View& config);
+
+		TrafficModel(
+			Type type,
+			simTimeType interArrivalTime,
+			simTimeType meanOnTime = 0.0,
+			simTimeType meanOffTime = 0.0);
+
+		/**
+		 * @brief Time of the first PDU (the first on period starts at
+		 * startTime)
+		 */
+		simTimeType
+		start(simTimeType startTime);
+
+		/**
+		 * @brief Time of the PDU following the one at "now"
+		 */
+		simTimeType
+		next(simTimeType now);
+
+		Type
+		getType() const;
+
+	private:
+		void
+		check() const;
+
+		simTimeType
+		drawExponential(simTimeType mean);
+
+		Type type;
+
+		simTimeType interArrivalTime;
+
+		simTimeType meanOnTime;
+
+		simTimeType meanOffTime;
+
+		/**
+		 * @brief End of the current on period (OnOff only)
+		 */
+		simTimeType onPeriodEnd;
+
+		wns::distribution::StandardUniform uniform;
+	};
+}
+
+#endif // NOT defined COPPER_TRAFFICMODEL_HPP
@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#ifndef COPPER_TRAFFICPDU_HPP
+#define COPPER_TRAFFICPDU_HPP
+
+#include <WNS/ldk/helper/FakePDU.hpp>
+
+namespace copper
+{
+	class TrafficSource;
+
+	/**
+	 * @brief PDU of the TrafficSource, carries the time it was handed
+	 * to the Transceiver so the TrafficSink can measure the latency, and
+	 * its sequence number so the TrafficSink can count lost and
+	 * reordered PDUs
+	 */
+	class TrafficPDU :
+		public wns::ldk::helper::FakePDU
+	{
+	public:
+		explicit
+		TrafficPDU(Bit length) :
+			wns::ldk::helper::FakePDU(length),
+			sentAt(0.0),
+			source(NULL),
+			sequenceNumber(0)
+		{}
+
+		simTimeType sentAt;
+
+		/**
+		 * @brief The generating TrafficSource
+		 */
+		const TrafficSource* source;
+
+		/**
+		 * @brief Number of the PDU among those the source handed to
+		 * its Transceiver, starting at 0
+		 */
+		unsigned long sequenceNumber;
+	};
+}
+
+#endif // NOT defined COPPER_TRAFFICPDU_HPP
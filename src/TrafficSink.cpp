@@ -0,0 +1,183 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include <COPPER/TrafficSink.hpp>
+#include <COPPER/TrafficPDU.hpp>
+#include <COPPER/ScalingReport.hpp>
+
+#include <WNS/events/scheduler/Interface.hpp>
+#include <WNS/node/Node.hpp>
+
+using namespace copper;
+
+STATIC_FACTORY_REGISTER_WITH_CREATOR(
+	TrafficSink,
+	wns::node::component::Interface,
+	"copper.TrafficSink",
+	wns::node::component::ConfigCreator
+	);
+
+TrafficSink::TrafficSink(
+	wns::node::Interface* node,
+	const wns::pyconfig::View& pyco) :
+
+	wns::node::component::Component(node, pyco),
+	address(pyco.get<int>("address")),
+	received(0),
+	collided(0),
+	receivedBits(0),
+	lost(0),
+	reordered(0),
+	expected(),
+	latency(NULL),
+	logger(pyco.get<wns::pyconfig::View>("logger"))
+{
+	if (!pyco.isNone("latencyHistogram"))
+	{
+		this->latency = new LatencyHistogram(pyco.get("latencyHistogram"));
+	}
+}
+
+TrafficSink::~TrafficSink()
+{
+	delete this->latency;
+}
+
+void
+TrafficSink::doStartup()
+{
+}
+
+void
+TrafficSink::onNodeCreated()
+{
+	wns::service::phy::copper::Notification* notification =
+		this->getService<wns::service::phy::copper::Notification*>(
+			this->getConfig().get<std::string>("notification"));
+
+	notification->setDLLUnicastAddress(this->address);
+	this->startObserving(notification);
+}
+
+void
+TrafficSink::onWorldCreated()
+{
+}
+
+void
+TrafficSink::onShutdown()
+{
+	MESSAGE_BEGIN(NORMAL, this->logger, m, "PDUs received ");
+	m << this->received
+	  << " (" << this->receivedBits << " Bit)"
+	  << ", collided " << this->collided
+	  << ", lost " << this->lost
+	  << ", reordered " << this->reordered;
+	if (this->latency != NULL && this->latency->getCount() > 0)
+	{
+		m << ", latency mean " << this->latency->getMean()
+		  << "s, p99 " << this->latency->getPercentile(99.0)
+		  << "s, max " << this->latency->getMax() << "s";
+	}
+	MESSAGE_END();
+}
+
+void
+TrafficSink::onData(const wns::osi::PDUPtr& pdu, double /*ber*/, bool collision)
+{
+	++this->received;
+	this->receivedBits += pdu->getLengthInBits();
+	if (collision)
+	{
+		++this->collided;
+	}
+	ScalingReport::getInstance().onPDUReceived();
+
+	const TrafficPDU* tp = dynamic_cast<const TrafficPDU*>(pdu.getPtr());
+	if (tp == NULL)
+	{
+		return;
+	}
+
+	if (this->latency != NULL)
+	{
+		this->latency->put(
+			wns::simulator::getEventScheduler()->getTime() - tp->sentAt);
+	}
+
+	unsigned long& next = this->expected[tp->source];
+	if (tp->sequenceNumber >= next)
+	{
+		this->lost += tp->sequenceNumber - next;
+		next = tp->sequenceNumber + 1;
+	}
+	else
+	{
+		// counted as lost when the later PDU arrived
+		++this->reordered;
+		if (this->lost > 0)
+		{
+			--this->lost;
+		}
+	}
+}
+
+unsigned long
+TrafficSink::getReceived() const
+{
+	return this->received;
+}
+
+unsigned long
+TrafficSink::getCollided() const
+{
+	return this->collided;
+}
+
+Bit
+TrafficSink::getReceivedBits() const
+{
+	return this->receivedBits;
+}
+
+unsigned long
+TrafficSink::getLost() const
+{
+	return this->lost;
+}
+
+unsigned long
+TrafficSink::getReordered() const
+{
+	return this->reordered;
+}
+
+const LatencyHistogram*
+TrafficSink::getLatencyHistogram() const
+{
+	return this->latency;
+}
@@ -0,0 +1,159 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#ifndef COPPER_TRAFFICSINK_HPP
+#define COPPER_TRAFFICSINK_HPP
+
+#include <COPPER/LatencyHistogram.hpp>
+
+#include <WNS/node/component/Component.hpp>
+#include <WNS/service/phy/copper/Notification.hpp>
+#include <WNS/service/phy/copper/Handler.hpp>
+#include <WNS/service/dll/Address.hpp>
+#include <WNS/Observer.hpp>
+#include <WNS/logger/Logger.hpp>
+
+#include <map>
+
+namespace copper
+{
+	class TrafficSource;
+
+	/**
+	 * @brief Counts the PDUs delivered by a Transceiver
+	 *
+	 * The sink sets the MAC address of the Transceiver. For PDUs of a
+	 * TrafficSource the latency (from sendData to delivery) is recorded
+	 * if a histogram is configured. Gaps in the sequence numbers of
+	 * each source are counted as lost PDUs. A PDU older than the latest
+	 * one of its source is counted as reordered and no longer as lost.
+	 */
+	class TrafficSink :
+		public wns::node::component::Component,
+		public wns::Observer<wns::service::phy::copper::Handler>
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 */
+		TrafficSink(
+			wns::node::Interface* node,
+			const wns::pyconfig::View& pyco);
+
+		/**
+		 * @brief Destructor
+		 */
+		virtual
+		~TrafficSink();
+
+		/**
+		 * @name wns::node::component::Interface
+		 */
+		//{@
+		virtual void
+		onNodeCreated();
+
+		virtual void
+		onWorldCreated();
+
+		virtual void
+		onShutdown();
+		//@}
+
+		/**
+		 * @name wns::service::phy::copper::Handler
+		 */
+		//{@
+		virtual void
+		onData(const wns::osi::PDUPtr& pdu, double ber, bool collision);
+		//@}
+
+		unsigned long
+		getReceived() const;
+
+		unsigned long
+		getCollided() const;
+
+		Bit
+		getReceivedBits() const;
+
+		/**
+		 * @brief PDUs of TrafficSources missing in the sequence
+		 */
+		unsigned long
+		getLost() const;
+
+		/**
+		 * @brief PDUs of TrafficSources received after a later PDU of
+		 * the same source
+		 */
+		unsigned long
+		getReordered() const;
+
+		/**
+		 * @brief Latency of the received PDUs (NULL if not configured)
+		 */
+		const LatencyHistogram*
+		getLatencyHistogram() const;
+
+	private:
+		virtual void
+		doStartup();
+
+		/**
+		 * @brief MAC address of the Transceiver
+		 */
+		wns::service::dll::UnicastAddress address;
+
+		unsigned long received;
+
+		/**
+		 * @brief PDUs received with the collision flag set
+		 */
+		unsigned long collided;
+
+		Bit receivedBits;
+
+		unsigned long lost;
+
+		unsigned long reordered;
+
+		/**
+		 * @brief Next expected sequence number per source
+		 */
+		std::map<const TrafficSource*, unsigned long> expected;
+
+		/**
+		 * @brief Owned, NULL if not configured
+		 */
+		LatencyHistogram* latency;
+
+		wns::logger::Logger logger;
+	};
+}
+
+#endif // NOT defined COPPER_TRAFFICSINK_HPP
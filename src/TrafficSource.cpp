@@ -0,0 +1,187 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include <COPPER/TrafficSource.hpp>
+#include <COPPER/ScalingReport.hpp>
+
+#include <WNS/node/Node.hpp>
+
+using namespace copper;
+
+STATIC_FACTORY_REGISTER_WITH_CREATOR(
+	TrafficSource,
+	wns::node::component::Interface,
+	"copper.TrafficSource",
+	wns::node::component::ConfigCreator
+	);
+
+TrafficSource::TrafficSource(
+	wns::node::Interface* node,
+	const wns::pyconfig::View& pyco) :
+
+	wns::node::component::Component(node, pyco),
+	dataTransmission(NULL),
+	target(),
+	pduSize(pyco.get<Bit>("pduSize")),
+	model(pyco.get("traffic")),
+	startTime(pyco.get<simTimeType>("startTime")),
+	pool(),
+	nextInPool(0),
+	nextSequenceNumber(0),
+	timer(),
+	timerPending(false),
+	generated(0),
+	blocked(0),
+	poolMisses(0),
+	logger(pyco.get<wns::pyconfig::View>("logger"))
+{
+	if (!pyco.isNone("target"))
+	{
+		this->target = wns::service::dll::UnicastAddress(pyco.get<int>("target"));
+	}
+
+	size_t poolSize = pyco.get<size_t>("poolSize");
+	this->pool.reserve(poolSize);
+	for (size_t ii = 0; ii < poolSize; ++ii)
+	{
+		this->pool.push_back(wns::osi::PDUPtr(new TrafficPDU(this->pduSize)));
+	}
+}
+
+TrafficSource::~TrafficSource()
+{
+	if (this->timerPending)
+	{
+		wns::simulator::getEventScheduler()->cancelEvent(this->timer);
+	}
+}
+
+void
+TrafficSource::doStartup()
+{
+}
+
+void
+TrafficSource::onNodeCreated()
+{
+	this->dataTransmission =
+		this->getService<wns::service::phy::copper::DataTransmission*>(
+			this->getConfig().get<std::string>("dataTransmission"));
+}
+
+void
+TrafficSource::onWorldCreated()
+{
+	ScalingReport::getInstance().onWorldCreated();
+
+	this->timer = wns::simulator::getEventScheduler()->schedule(
+		Timer(this), this->model.start(this->startTime));
+	this->timerPending = true;
+}
+
+void
+TrafficSource::onShutdown()
+{
+	MESSAGE_BEGIN(NORMAL, this->logger, m, "PDUs generated ");
+	m << this->generated
+	  << ", blocked " << this->blocked
+	  << ", allocated past the pool " << this->poolMisses;
+	MESSAGE_END();
+}
+
+void
+TrafficSource::generate()
+{
+	this->timerPending = false;
+	++this->generated;
+	ScalingReport::getInstance().onPDUGenerated();
+
+	wns::events::scheduler::Interface* scheduler = wns::simulator::getEventScheduler();
+	if (this->dataTransmission->isFree())
+	{
+		wns::osi::PDUPtr pdu = this->createPDU();
+		TrafficPDU* tp = static_cast<TrafficPDU*>(pdu.getPtr());
+		tp->sentAt = scheduler->getTime();
+		tp->source = this;
+		tp->sequenceNumber = this->nextSequenceNumber++;
+		if (this->target.isValid())
+		{
+			this->dataTransmission->sendData(this->target, pdu);
+		}
+		else
+		{
+			this->dataTransmission->sendData(wns::service::dll::BroadcastAddress(), pdu);
+		}
+	}
+	else
+	{
+		++this->blocked;
+	}
+
+	this->timer = scheduler->schedule(
+		Timer(this), this->model.next(scheduler->getTime()));
+	this->timerPending = true;
+}
+
+wns::osi::PDUPtr
+TrafficSource::createPDU()
+{
+	if (this->pool.empty())
+	{
+		return wns::osi::PDUPtr(new TrafficPDU(this->pduSize));
+	}
+
+	// only referenced by the pool once the Transceiver is done with it,
+	// a PDU still in use must not be overwritten
+	size_t index = this->nextInPool;
+	this->nextInPool = (this->nextInPool + 1) % this->pool.size();
+	if (this->pool[index]->getRefCount() > 1)
+	{
+		++this->poolMisses;
+		return wns::osi::PDUPtr(new TrafficPDU(this->pduSize));
+	}
+	return this->pool[index];
+}
+
+unsigned long
+TrafficSource::getGenerated() const
+{
+	return this->generated;
+}
+
+unsigned long
+TrafficSource::getBlocked() const
+{
+	return this->blocked;
+}
+
+unsigned long
+TrafficSource::getPoolMisses() const
+{
+	return this->poolMisses;
+}
+
@@ -0,0 +1,184 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#ifndef COPPER_TRAFFICSOURCE_HPP
+#define COPPER_TRAFFICSOURCE_HPP
+
+#include <COPPER/TrafficModel.hpp>
+#include <COPPER/TrafficPDU.hpp>
+
+#include <WNS/node/component/Component.hpp>
+#include <WNS/service/phy/copper/DataTransmission.hpp>
+#include <WNS/service/dll/Address.hpp>
+#include <WNS/events/scheduler/Interface.hpp>
+#include <WNS/logger/Logger.hpp>
+
+#include <vector>
+
+namespace copper
+{
+	/**
+	 * @brief Generates load on top of the DataTransmission service of a
+	 * Transceiver
+	 *
+	 * Used to load the wire without a DLL (e.g. by the scaling benchmark,
+	 * see copper/ScalingScenario.py). PDUs of pduSize Bit are sent to the
+	 * target (broadcast if not configured) according to the TrafficModel,
+	 * beginning at startTime. PDUs are only handed to the Transceiver if
+	 * it is free, otherwise they are counted as blocked. The received
+	 * PDUs are counted by the TrafficSink.
+	 *
+	 * With poolSize > 0 the PDUs are allocated once and reused round
+	 * robin, so the pool should be larger than the number of PDUs which
+	 * may be in the Transceiver at a time (queue capacity + 1). If the
+	 * next PDU of the pool is still referenced, a new PDU is allocated
+	 * instead (see getPoolMisses).
+	 */
+	class TrafficSource :
+		public wns::node::component::Component
+	{
+		/**
+		 * @brief Generates the next PDU
+		 */
+		class Timer
+		{
+		public:
+			explicit
+			Timer(TrafficSource* s) :
+				source(s)
+			{
+				assure(this->source, "must be non-NULL");
+			}
+
+			void
+			operator()()
+			{
+				this->source->generate();
+			}
+
+		private:
+			TrafficSource* source;
+		};
+
+	public:
+		/**
+		 * @brief Constructor
+		 */
+		TrafficSource(
+			wns::node::Interface* node,
+			const wns::pyconfig::View& pyco);
+
+		/**
+		 * @brief Destructor
+		 */
+		virtual
+		~TrafficSource();
+
+		/**
+		 * @name wns::node::component::Interface
+		 */
+		//{@
+		virtual void
+		onNodeCreated();
+
+		virtual void
+		onWorldCreated();
+
+		virtual void
+		onShutdown();
+		//@}
+
+		unsigned long
+		getGenerated() const;
+
+		unsigned long
+		getBlocked() const;
+
+		/**
+		 * @brief PDUs allocated because the PDU of the pool was still
+		 * in use
+		 */
+		unsigned long
+		getPoolMisses() const;
+
+	private:
+		virtual void
+		doStartup();
+
+		/**
+		 * @brief Sends a PDU and schedules the next one
+		 */
+		void
+		generate();
+
+		/**
+		 * @brief Next PDU of the pool or a new one
+		 */
+		wns::osi::PDUPtr
+		createPDU();
+
+		wns::service::phy::copper::DataTransmission* dataTransmission;
+
+		/**
+		 * @brief Destination, invalid for broadcast
+		 */
+		wns::service::dll::UnicastAddress target;
+
+		Bit pduSize;
+
+		TrafficModel model;
+
+		simTimeType startTime;
+
+		/**
+		 * @brief Preallocated PDUs (empty if poolSize is 0)
+		 */
+		std::vector<wns::osi::PDUPtr> pool;
+
+		size_t nextInPool;
+
+		/**
+		 * @brief Sequence number of the next PDU handed to the
+		 * Transceiver
+		 */
+		unsigned long nextSequenceNumber;
+
+		wns::events::scheduler::IEventPtr timer;
+
+		bool timerPending;
+
+		unsigned long generated;
+
+		unsigned long blocked;
+
+		unsigned long poolMisses;
+
+		wns::logger::Logger logger;
+	};
+}
+
+#endif // NOT defined COPPER_TRAFFICSOURCE_HPP
@@ -98,6 +98,10 @@ Transceiver::onWorldCreated()
 void
 Transceiver::onShutdown()
 {
+	if (this->transmitter != NULL)
+	{
+		this->transmitter->writeHistograms();
+	}
 }
 
 
@@ -31,11 +31,15 @@ using namespace copper;
 
 Transmission::Transmission(
 	const wns::osi::PDUPtr& _pdu,
-	TransmitterDataSentInterface* _sender) :
+	TransmitterDataSentInterface* _sender,
+	ChannelId _channel) :
 	// initialization
 	pdu(_pdu),
 	collision(false),
-	sender(_sender)
+	sender(_sender),
+	channel(_channel),
+	burst(),
+	queuedAt(0.0)
 	// body
 {
 	assure(this->pdu != wns::osi::PDUPtr(), "pdu may not be NULL");
@@ -50,9 +54,10 @@ Transmission::~Transmission()
 
 BroadcastTransmission::BroadcastTransmission(
 	const wns::osi::PDUPtr& _pdu,
-	TransmitterDataSentInterface* _sender) :
+	TransmitterDataSentInterface* _sender,
+	ChannelId _channel) :
 	// initialization
-	Transmission(_pdu, _sender)
+	Transmission(_pdu, _sender, _channel)
 	// body
 {
 }
@@ -61,13 +66,27 @@ BroadcastTransmission::BroadcastTransmission(
 UnicastTransmission::UnicastTransmission(
 	const wns::service::dll::UnicastAddress& _target,
 	const wns::osi::PDUPtr& _pdu,
-	TransmitterDataSentInterface* _sender) :
+	TransmitterDataSentInterface* _sender,
+	ChannelId _channel) :
 	// initialization
-	Transmission(_pdu, _sender),
+	Transmission(_pdu, _sender, _channel),
 	target(_target)
 	// body
 {
 }
 
 
+MulticastTransmission::MulticastTransmission(
+	GroupId _group,
+	const wns::osi::PDUPtr& _pdu,
+	TransmitterDataSentInterface* _sender,
+	ChannelId _channel) :
+	// initialization
+	Transmission(_pdu, _sender, _channel),
+	group(_group)
+	// body
+{
+}
+
+
 
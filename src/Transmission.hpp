@@ -32,17 +32,32 @@
 #include <WNS/SmartPtr.hpp>
 #include <WNS/service/dll/Address.hpp>
 
+#include <vector>
+
 namespace copper
 {
 	class TransmitterDataSentInterface;
 
+	/**
+	 * @brief Identifies a channel of a (multi-channel) Wire
+	 */
+	typedef unsigned int ChannelId;
+
+	/**
+	 * @brief Identifies a multicast group of a Wire (dense, starting
+	 * at 0)
+	 */
+	typedef unsigned int GroupId;
+
+	typedef std::vector<wns::osi::PDUPtr> PDUContainer;
 
 	struct Transmission :
 		virtual public wns::RefCountable
 	{
 		Transmission(
 			const wns::osi::PDUPtr& _pdu,
-			TransmitterDataSentInterface* _sender);
+			TransmitterDataSentInterface* _sender,
+			ChannelId _channel = 0);
 
 		virtual
 		~Transmission();
@@ -50,6 +65,21 @@ namespace copper
 		wns::osi::PDUPtr pdu;
 		bool collision;
 		TransmitterDataSentInterface* sender;
+		ChannelId channel;
+
+		/**
+		 * @brief Further PDUs sent back-to-back after pdu within the
+		 * same transmission (burst). Usually empty.
+		 *
+		 * The transmission is still identified by pdu.
+		 */
+		PDUContainer burst;
+
+		/**
+		 * @brief Time the PDU has been handed to the transmitter
+		 * (used for delay statistics)
+		 */
+		simTimeType queuedAt;
 	};
 
 
@@ -58,7 +88,8 @@ namespace copper
 	{
 		BroadcastTransmission(
 			const wns::osi::PDUPtr& _pdu,
-			TransmitterDataSentInterface* sender);
+			TransmitterDataSentInterface* sender,
+			ChannelId channel = 0);
 	};
 
 
@@ -68,15 +99,34 @@ namespace copper
 		UnicastTransmission(
 			const wns::service::dll::UnicastAddress& _target,
 			const wns::osi::PDUPtr& _pdu,
-			TransmitterDataSentInterface* sender);
+			TransmitterDataSentInterface* sender,
+			ChannelId channel = 0);
 
 		wns::service::dll::UnicastAddress target;
 	};
 
 
+	/**
+	 * @brief Delivered to the members of the group only (see
+	 * WireInterface::setGroupMembership)
+	 */
+	struct MulticastTransmission :
+		public Transmission
+	{
+		MulticastTransmission(
+			GroupId _group,
+			const wns::osi::PDUPtr& _pdu,
+			TransmitterDataSentInterface* sender,
+			ChannelId channel = 0);
+
+		GroupId group;
+	};
+
+
 	typedef wns::SmartPtr<Transmission> TransmissionPtr;
 	typedef wns::SmartPtr<BroadcastTransmission> BroadcastTransmissionPtr;
 	typedef wns::SmartPtr<UnicastTransmission> UnicastTransmissionPtr;
+	typedef wns::SmartPtr<MulticastTransmission> MulticastTransmissionPtr;
 }
 
 #endif // NOT defined COPPER_TRANSMISSION_HPP
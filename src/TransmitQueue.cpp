@@ -0,0 +1,232 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#include <COPPER/TransmitQueue.hpp>
+
+#include <WNS/Exception.hpp>
+
+using namespace copper;
+
+const size_t TransmitQueue::none;
+
+TransmitQueue::TransmitQueue(const wns::pyconfig::View& config) :
+	slots(),
+	classes(),
+	priorities(config.get<Priority>("priorities")),
+	capacity(config.get<size_t>("capacity")),
+	numberOfEntries(0)
+{
+	this->init();
+}
+
+TransmitQueue::TransmitQueue(Priority _priorities, size_t _capacity) :
+	slots(),
+	classes(),
+	priorities(_priorities),
+	capacity(_capacity),
+	numberOfEntries(0)
+{
+	this->init();
+}
+
+void
+TransmitQueue::init()
+{
+	if (this->priorities == 0 || this->capacity == 0)
+	{
+		throw wns::Exception("TransmitQueue needs at least one priority class and a capacity > 0");
+	}
+
+	this->slots.resize(this->priorities * this->capacity);
+	this->classes.resize(this->priorities);
+
+	// all slots of a class are free
+	for (Priority priority = 0; priority < this->priorities; ++priority)
+	{
+		size_t first = priority * this->capacity;
+		for (size_t ii = first; ii + 1 < first + this->capacity; ++ii)
+		{
+			this->slots[ii].next = ii + 1;
+		}
+		this->classes[priority].freeSlots = first;
+	}
+}
+
+bool
+TransmitQueue::push(const PendingTransmission& pt, Priority priority)
+{
+	assure(priority < this->priorities, "Invalid priority");
+	assure(this->find(pt.pdu) == none, "PDU already queued");
+
+	if (this->isFull(priority))
+	{
+		return false;
+	}
+
+	PriorityClass& pc = this->classes[priority];
+	size_t slot = pc.freeSlots;
+	pc.freeSlots = this->slots[slot].next;
+
+	this->slots[slot].pt = pt;
+	this->slots[slot].previous = pc.tail;
+	this->slots[slot].next = none;
+	if (pc.tail == none)
+	{
+		pc.head = slot;
+	}
+	else
+	{
+		this->slots[pc.tail].next = slot;
+	}
+	pc.tail = slot;
+	++pc.count;
+
+	++this->numberOfEntries;
+	return true;
+}
+
+const PendingTransmission&
+TransmitQueue::front() const
+{
+	assure(!this->empty(), "TransmitQueue is empty");
+
+	return this->slots[this->classes[this->getFrontPriority()].head].pt;
+}
+
+void
+TransmitQueue::pop()
+{
+	assure(!this->empty(), "TransmitQueue is empty");
+
+	this->release(this->classes[this->getFrontPriority()].head);
+}
+
+bool
+TransmitQueue::remove(const wns::osi::PDUPtr& pdu)
+{
+	size_t slot = this->find(pdu);
+	if (slot == none)
+	{
+		return false;
+	}
+
+	this->release(slot);
+	return true;
+}
+
+bool
+TransmitQueue::isFull(Priority priority) const
+{
+	assure(priority < this->priorities, "Invalid priority");
+
+	return this->classes[priority].count == this->capacity;
+}
+
+bool
+TransmitQueue::empty() const
+{
+	return this->numberOfEntries == 0;
+}
+
+size_t
+TransmitQueue::size() const
+{
+	return this->numberOfEntries;
+}
+
+TransmitQueue::Priority
+TransmitQueue::getNumberOfPriorities() const
+{
+	return this->priorities;
+}
+
+size_t
+TransmitQueue::getCapacity() const
+{
+	return this->capacity;
+}
+
+size_t
+TransmitQueue::find(const wns::osi::PDUPtr& pdu) const
+{
+	for (Priority priority = 0; priority < this->priorities; ++priority)
+	{
+		for (size_t slot = this->classes[priority].head; slot != none; slot = this->slots[slot].next)
+		{
+			if (this->slots[slot].pt.pdu == pdu)
+			{
+				return slot;
+			}
+		}
+	}
+	return none;
+}
+
+void
+TransmitQueue::release(size_t slot)
+{
+	PriorityClass& pc = this->classes[slot / this->capacity];
+	Slot& s = this->slots[slot];
+
+	if (s.previous == none)
+	{
+		pc.head = s.next;
+	}
+	else
+	{
+		this->slots[s.previous].next = s.next;
+	}
+	if (s.next == none)
+	{
+		pc.tail = s.previous;
+	}
+	else
+	{
+		this->slots[s.next].previous = s.previous;
+	}
+	--pc.count;
+
+	--this->numberOfEntries;
+
+	// release the PDUs
+	s.pt = PendingTransmission();
+	s.previous = none;
+	s.next = pc.freeSlots;
+	pc.freeSlots = slot;
+}
+
+TransmitQueue::Priority
+TransmitQueue::getFrontPriority() const
+{
+	Priority priority = 0;
+	while (this->classes[priority].count == 0)
+	{
+		++priority;
+	}
+	return priority;
+}
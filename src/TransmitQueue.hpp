@@ -0,0 +1,267 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#ifndef COPPER_TRANSMITQUEUE_HPP
+#define COPPER_TRANSMITQUEUE_HPP
+
+#include <COPPER/Transmission.hpp>
+
+#include <WNS/service/dll/Address.hpp>
+#include <WNS/pyconfig/View.hpp>
+
+#include <vector>
+
+namespace copper
+{
+	/**
+	 * @brief A PDU (or burst) waiting for transmission
+	 */
+	struct PendingTransmission
+	{
+		PendingTransmission() :
+			target(),
+			multicast(false),
+			group(0),
+			pdu(),
+			burst(),
+			queuedAt(0.0)
+		{}
+
+		PendingTransmission(
+			const wns::service::dll::UnicastAddress& _target,
+			const wns::osi::PDUPtr& _pdu) :
+			target(_target),
+			multicast(false),
+			group(0),
+			pdu(_pdu),
+			burst(),
+			queuedAt(0.0)
+		{}
+
+		/**
+		 * @brief Multicast to the group
+		 */
+		PendingTransmission(
+			GroupId _group,
+			const wns::osi::PDUPtr& _pdu) :
+			target(),
+			multicast(true),
+			group(_group),
+			pdu(_pdu),
+			burst(),
+			queuedAt(0.0)
+		{}
+
+		/**
+		 * @brief Invalid address for broadcast and multicast
+		 * transmissions
+		 */
+		wns::service::dll::UnicastAddress target;
+
+		bool multicast;
+
+		/**
+		 * @brief Only valid if multicast is set
+		 */
+		GroupId group;
+
+		wns::osi::PDUPtr pdu;
+
+		/**
+		 * @brief PDUs following pdu (see Transmission::burst)
+		 */
+		PDUContainer burst;
+
+		/**
+		 * @brief Time of sendData (see Transmission::queuedAt)
+		 */
+		simTimeType queuedAt;
+	};
+
+	/**
+	 * @brief Bounded transmit queue with strict priority classes
+	 *
+	 * The slots of all priority classes (capacity per class) are allocated
+	 * once on construction, each class links its entries in FIFO order.
+	 * Priority 0 is the highest priority, front() is the oldest entry of
+	 * the highest non-empty class. Entries are only removed via pop() and
+	 * remove(), remove() walks the entries of the classes (bounded by
+	 * the capacity), so nothing is allocated after construction.
+	 */
+	class TransmitQueue
+	{
+	public:
+		typedef unsigned int Priority;
+
+		/**
+		 * @brief Constructor (config keys "priorities" and "capacity")
+		 */
+		explicit
+		TransmitQueue(const wns::pyconfig::View& config);
+
+		/**
+		 * @brief Constructor
+		 *
+		 * @param priorities Number of priority classes
+		 * @param capacity Maximum number of entries per priority class
+		 */
+		TransmitQueue(Priority priorities, size_t capacity);
+
+		/**
+		 * @brief Appends the entry to its priority class, returns false
+		 * (and does nothing) if the class is full
+		 */
+		bool
+		push(const PendingTransmission& pt, Priority priority);
+
+		/**
+		 * @brief Oldest entry of the highest non-empty priority class
+		 */
+		const PendingTransmission&
+		front() const;
+
+		/**
+		 * @brief Removes front()
+		 */
+		void
+		pop();
+
+		/**
+		 * @brief Removes the entry identified by its (first) PDU,
+		 * returns false if not queued
+		 *
+		 * A PDU can only be queued once at a time.
+		 */
+		bool
+		remove(const wns::osi::PDUPtr& pdu);
+
+		bool
+		isFull(Priority priority) const;
+
+		bool
+		empty() const;
+
+		/**
+		 * @brief Number of entries in all priority classes
+		 */
+		size_t
+		size() const;
+
+		Priority
+		getNumberOfPriorities() const;
+
+		size_t
+		getCapacity() const;
+
+	private:
+		/**
+		 * @brief Marks the end of a list of slots
+		 */
+		static const size_t none = static_cast<size_t>(-1);
+
+		/**
+		 * @brief An entry and its links within its priority class (or
+		 * within the free slots of the class)
+		 */
+		struct Slot
+		{
+			Slot() :
+				pt(),
+				previous(none),
+				next(none)
+			{}
+
+			PendingTransmission pt;
+
+			size_t previous;
+
+			size_t next;
+		};
+
+		/**
+		 * @brief The entries of a priority class
+		 */
+		struct PriorityClass
+		{
+			PriorityClass() :
+				head(none),
+				tail(none),
+				freeSlots(none),
+				count(0)
+			{}
+
+			/**
+			 * @brief Slot of the oldest entry
+			 */
+			size_t head;
+
+			size_t tail;
+
+			/**
+			 * @brief First unused slot of the class
+			 */
+			size_t freeSlots;
+
+			size_t count;
+		};
+
+		void
+		init();
+
+		/**
+		 * @brief Slot of the queued PDU, none if not queued
+		 */
+		size_t
+		find(const wns::osi::PDUPtr& pdu) const;
+
+		/**
+		 * @brief Unlinks the slot from its class and returns it to the
+		 * free slots
+		 */
+		void
+		release(size_t slot);
+
+		Priority
+		getFrontPriority() const;
+
+		/**
+		 * @brief Storage of all classes, capacity slots per class
+		 */
+		std::vector<Slot> slots;
+
+		std::vector<PriorityClass> classes;
+
+		Priority priorities;
+
+		size_t capacity;
+
+		size_t numberOfEntries;
+	};
+}
+
+#endif // NOT defined COPPER_TRANSMITQUEUE_HPP
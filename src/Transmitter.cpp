@@ -28,6 +28,12 @@
 #include <COPPER/Transmitter.hpp>
 #include <COPPER/Transmission.hpp>
 #include <COPPER/Wire.hpp>
+#include <COPPER/Profiling.hpp>
+#include <COPPER/Logging.hpp>
+
+#include <WNS/Exception.hpp>
+
+#include <algorithm>
 
 using namespace copper;
 
@@ -36,16 +42,94 @@ Transmitter::Transmitter(
 	WireInterface* w) :
 	// init
 	wire(w),
+	channel(0),
 	dataRate(pyco.get<double>("dataRate")),
 	sensingTime(pyco.get<double>("sensingTime")),
+	tdma(NULL),
+	tdmaStation(TDMAExecutor::unusedSlot),
+	queue(),
+	priority(0),
+	current(),
+	csma(false),
+	backoffSlotTime(0.0),
+	maxAttempts(0),
+	maxBackoffExponent(0),
+	state(Idle),
+	attempts(0),
+	collisionDetected(false),
+	wakeupRequested(false),
+	timer(),
+	timerPending(false),
+	transmittedAt(0.0),
+	droppedPDUs(0),
+	accessDelay(),
+	latency(),
+	backoffDistribution(),
 	logger(pyco.get("logger"))
 	// body
 {
+	this->setChannel(pyco.get<ChannelId>("channel"));
+
+	if (!pyco.isNone("queue"))
+	{
+		this->queue.reset(new TransmitQueue(pyco.get("queue")));
+	}
+
+	if (!pyco.isNone("delayHistogram"))
+	{
+		this->accessDelay.reset(new LatencyHistogram(pyco.get("delayHistogram")));
+		this->latency.reset(new LatencyHistogram(pyco.get("delayHistogram")));
+	}
+
+	if (!pyco.isNone("tdmaStation"))
+	{
+		this->tdma = this->wire->getTDMAExecutor();
+		if (this->tdma == NULL)
+		{
+			throw wns::Exception("TDMA station configured but the wire has no TDMA schedule");
+		}
+		if (this->queue.get() == NULL)
+		{
+			throw wns::Exception("TDMA station needs a TransmitQueue");
+		}
+		this->tdmaStation = pyco.get<int>("tdmaStation");
+		this->tdma->addStation(this->tdmaStation, this);
+	}
+
+	if (!pyco.isNone("csma"))
+	{
+		if (this->tdma != NULL)
+		{
+			throw wns::Exception("CSMA/CD can not be used by a TDMA station");
+		}
+		if (this->queue.get() == NULL)
+		{
+			throw wns::Exception("CSMA/CD needs a TransmitQueue");
+		}
+
+		wns::pyconfig::View csmaConfig = pyco.get("csma");
+		this->csma = true;
+		this->backoffSlotTime = csmaConfig.get<simTimeType>("slotTime");
+		this->maxAttempts = csmaConfig.get<unsigned int>("maxAttempts");
+		this->maxBackoffExponent = csmaConfig.get<unsigned int>("maxBackoffExponent");
+	}
 }
 
 
 Transmitter::~Transmitter()
 {
+	this->cancelTimer();
+
+	// the wire must not wake up a deleted transmitter
+	if (this->wakeupRequested)
+	{
+		this->wire->cancelWakeupOnIdle(this);
+	}
+
+	if (this->tdma != NULL)
+	{
+		this->tdma->removeStation(this->tdmaStation);
+	}
 }
 
 
@@ -54,11 +138,8 @@ Transmitter::sendData(
 	const wns::service::dll::BroadcastAddress& /*peerAddress*/,
 	const wns::osi::PDUPtr& data)
 {
-	BroadcastTransmissionPtr bt(new BroadcastTransmission(data, this));
-
-	MESSAGE_SINGLE(NORMAL, this->logger, "sendData, broadcast");
-
-	this->wire->sendData(bt, this->getDuration(data->getLengthInBits()));
+	COPPER_PROFILE_SCOPE("Transmitter::sendData");
+	this->send(PendingTransmission(wns::service::dll::UnicastAddress(), data));
 }
 
 
@@ -67,11 +148,20 @@ Transmitter::sendData(
 	const wns::service::dll::UnicastAddress& peerAddress,
 	const wns::osi::PDUPtr& data)
 {
-	UnicastTransmissionPtr ut(new UnicastTransmission(peerAddress, data, this));
+	COPPER_PROFILE_SCOPE("Transmitter::sendData");
+	assure(peerAddress.isValid(), "Invalid peer address");
+
+	this->send(PendingTransmission(peerAddress, data));
+}
 
-	MESSAGE_SINGLE(NORMAL, this->logger, "sendData, target's MAC address: " << peerAddress);
 
-	wire->sendData(ut, this->getDuration(data->getLengthInBits()));
+void
+Transmitter::sendMulticast(
+	GroupId group,
+	const wns::osi::PDUPtr& data)
+{
+	COPPER_PROFILE_SCOPE("Transmitter::sendMulticast");
+	this->send(PendingTransmission(group, data));
 }
 
 
@@ -79,7 +169,35 @@ void
 Transmitter::cancelData(
 	const wns::osi::PDUPtr& pdu)
 {
-	MESSAGE_SINGLE(NORMAL, this->logger, "stopping transmission");
+	if (this->state != Idle && this->current.pdu == pdu)
+	{
+		COPPER_FRAME_MESSAGE(NORMAL, this->logger, "cancelling PDU in contention");
+		this->cancelTimer();
+		if (this->state == Transmitting)
+		{
+			// the next PDU is started when stopTransmission signals
+			// the free channel
+			this->finishPDU(true);
+			this->wire->stopTransmission(pdu);
+		}
+		else
+		{
+			this->finishPDU(false);
+		}
+		return;
+	}
+
+	if (this->queue.get() != NULL && this->queue->remove(pdu))
+	{
+		COPPER_FRAME_MESSAGE(NORMAL, this->logger, "removed queued PDU");
+		if (this->tdma != NULL && this->queue->empty())
+		{
+			this->tdma->onIdle(this->tdmaStation);
+		}
+		return;
+	}
+
+	COPPER_FRAME_MESSAGE(NORMAL, this->logger, "stopping transmission");
 	this->wire->stopTransmission(pdu);
 }
 
@@ -88,15 +206,500 @@ bool
 Transmitter::isFree(
 	) const
 {
-	return wire->blockedSince() < this->sensingTime;
+	if (this->queue.get() != NULL)
+	{
+		return !this->queue->isFull(this->priority);
+	}
+	return this->isChannelIdle();
+}
+
+void
+Transmitter::onTransmitOpportunity(
+	simTimeType duration)
+{
+	assure(!this->queue->empty(), "Transmit opportunity but nothing to send");
+
+	PendingTransmission pt = this->queue->front();
+	this->queue->pop();
+
+	// oversized PDUs are rejected by send
+	assure(this->getDuration(pt) <= duration, "Transmission does not fit into TDMA slot");
+
+	if (this->queue->empty())
+	{
+		this->tdma->onIdle(this->tdmaStation);
+	}
+
+	this->transmit(pt);
+}
+
+void
+Transmitter::transmit(
+	const PendingTransmission& pt)
+{
+	simTimeType duration = this->getDuration(pt);
+
+	// with CSMA/CD the attempt may still fail, see onDataSent
+	this->transmittedAt = wns::simulator::getEventScheduler()->getTime();
+	if (this->accessDelay.get() != NULL && !this->csma)
+	{
+		this->accessDelay->put(this->transmittedAt - pt.queuedAt);
+	}
+
+	if (pt.target.isValid())
+	{
+		UnicastTransmissionPtr ut(new UnicastTransmission(pt.target, pt.pdu, this, this->channel));
+		ut->burst = pt.burst;
+		ut->queuedAt = pt.queuedAt;
+
+		COPPER_FRAME_MESSAGE(
+			NORMAL, this->logger,
+			"sendData, target's MAC address: " << pt.target << ", channel " << this->channel
+			<< ", " << 1 + pt.burst.size() << " PDU(s)");
+
+		this->wire->sendData(ut, duration);
+	}
+	else if (pt.multicast)
+	{
+		MulticastTransmissionPtr mt(new MulticastTransmission(pt.group, pt.pdu, this, this->channel));
+		mt->burst = pt.burst;
+		mt->queuedAt = pt.queuedAt;
+
+		COPPER_FRAME_MESSAGE(
+			NORMAL, this->logger,
+			"sendData, multicast to group " << pt.group << " on channel " << this->channel
+			<< ", " << 1 + pt.burst.size() << " PDU(s)");
+
+		this->wire->sendData(mt, duration);
+	}
+	else
+	{
+		BroadcastTransmissionPtr bt(new BroadcastTransmission(pt.pdu, this, this->channel));
+		bt->burst = pt.burst;
+		bt->queuedAt = pt.queuedAt;
+
+		COPPER_FRAME_MESSAGE(
+			NORMAL, this->logger,
+			"sendData, broadcast on channel " << this->channel
+			<< ", " << 1 + pt.burst.size() << " PDU(s)");
+
+		this->wire->sendData(bt, duration);
+	}
+}
+
+void
+Transmitter::sendBurst(
+	const wns::service::dll::BroadcastAddress& /*peerAddress*/,
+	const PDUContainer& pdus)
+{
+	assure(!pdus.empty(), "Burst must contain at least one PDU");
+
+	PendingTransmission pt(wns::service::dll::UnicastAddress(), pdus.front());
+	pt.burst.assign(pdus.begin() + 1, pdus.end());
+	this->send(pt);
+}
+
+void
+Transmitter::sendBurst(
+	const wns::service::dll::UnicastAddress& peerAddress,
+	const PDUContainer& pdus)
+{
+	assure(peerAddress.isValid(), "Invalid peer address");
+	assure(!pdus.empty(), "Burst must contain at least one PDU");
+
+	PendingTransmission pt(peerAddress, pdus.front());
+	pt.burst.assign(pdus.begin() + 1, pdus.end());
+	this->send(pt);
+}
+
+unsigned long
+Transmitter::getDroppedPDUs(
+	) const
+{
+	return this->droppedPDUs;
+}
+
+const LatencyHistogram*
+Transmitter::getAccessDelayHistogram(
+	) const
+{
+	return this->accessDelay.get();
+}
+
+const LatencyHistogram*
+Transmitter::getLatencyHistogram(
+	) const
+{
+	return this->latency.get();
+}
+
+void
+Transmitter::writeHistograms(
+	) const
+{
+	if (this->latency.get() == NULL)
+	{
+		return;
+	}
+
+	const LatencyHistogram* histograms[] = {this->accessDelay.get(), this->latency.get()};
+	const char* names[] = {"access delay", "latency"};
+
+	for (int ii = 0; ii < 2; ++ii)
+	{
+		const LatencyHistogram* h = histograms[ii];
+		MESSAGE_BEGIN(NORMAL, this->logger, m, names[ii]);
+		m << ": samples " << h->getCount()
+		  << ", mean " << h->getMean()
+		  << ", p50 " << h->getPercentile(50.0)
+		  << ", p90 " << h->getPercentile(90.0)
+		  << ", p99 " << h->getPercentile(99.0)
+		  << ", p99.9 " << h->getPercentile(99.9)
+		  << ", max " << h->getMax();
+		MESSAGE_END();
+	}
+}
+
+void
+Transmitter::send(
+	const PendingTransmission& _pt)
+{
+	PendingTransmission pt(_pt);
+	pt.queuedAt = wns::simulator::getEventScheduler()->getTime();
+
+	if (this->queue.get() == NULL)
+	{
+		this->transmit(pt);
+		return;
+	}
+
+	if (this->tdma != NULL && this->getDuration(pt) > this->tdma->getSlotDuration())
+	{
+		++this->droppedPDUs;
+		COPPER_FRAME_MESSAGE(
+			NORMAL, this->logger,
+			"transmission of " << this->getDuration(pt) << "s does not fit into TDMA slot of "
+			<< this->tdma->getSlotDuration() << "s, dropping PDU");
+		return;
+	}
+
+	if (!this->queue->push(pt, this->priority))
+	{
+		++this->droppedPDUs;
+		COPPER_FRAME_MESSAGE(NORMAL, this->logger, "queue full, dropping PDU of priority " << this->priority);
+		return;
+	}
+
+	COPPER_FRAME_MESSAGE(NORMAL, this->logger, "queued PDU, " << this->queue->size() << " PDU(s) waiting");
+
+	if (this->tdma != NULL)
+	{
+		if (this->queue->size() == 1)
+		{
+			this->tdma->onBacklogged(this->tdmaStation);
+		}
+	}
+	else if (this->state == Idle)
+	{
+		this->nextPDU();
+	}
+}
+
+simTimeType
+Transmitter::getDuration(
+	const PendingTransmission& pt)
+{
+	Bit len = pt.pdu->getLengthInBits();
+	for (
+		PDUContainer::const_iterator itr = pt.burst.begin();
+		itr != pt.burst.end();
+		++itr)
+	{
+		len += (*itr)->getLengthInBits();
+	}
+	return this->getDuration(len);
 }
 
 void
-Transmitter::onDataSent(wns::osi::PDUPtr pdu)
+Transmitter::onDataSent(
+	const TransmissionPtr& transmission)
 {
+	bool contended =
+		this->state == Transmitting &&
+		this->current.pdu == transmission->pdu;
+
+	if (contended)
+	{
+		this->cancelTimer();
+		if (this->csma && transmission->collision)
+		{
+			// the collision has not been detected before the end of
+			// the transmission
+			this->backoff();
+			return;
+		}
+
+		// the successful attempt, including backoff and retries
+		if (this->accessDelay.get() != NULL && this->csma)
+		{
+			this->accessDelay->put(this->transmittedAt - transmission->queuedAt);
+		}
+	}
+
+	if (this->latency.get() != NULL)
+	{
+		this->latency->put(wns::simulator::getEventScheduler()->getTime() - transmission->queuedAt);
+	}
+
+	wns::osi::PDUPtr pdu = transmission->pdu;
 	this->sendNotifies(
 		&wns::service::phy::copper::DataTransmissionFeedbackInterface::onDataSent,
 		pdu);
+
+	for (
+		PDUContainer::const_iterator itr = transmission->burst.begin();
+		itr != transmission->burst.end();
+		++itr)
+	{
+		pdu = *itr;
+		this->sendNotifies(
+			&wns::service::phy::copper::DataTransmissionFeedbackInterface::onDataSent,
+			pdu);
+	}
+
+	if (contended)
+	{
+		this->finishPDU(true);
+	}
+}
+
+void
+Transmitter::onCollision(
+	const TransmissionPtr& transmission)
+{
+	if (!this->csma ||
+	    this->state != Transmitting ||
+	    this->collisionDetected ||
+	    this->current.pdu != transmission->pdu)
+	{
+		return;
+	}
+
+	COPPER_FRAME_MESSAGE(NORMAL, this->logger, "collision, aborting after " << this->sensingTime << "s");
+
+	// the collision is detected after the sensing time
+	this->collisionDetected = true;
+	this->timer = wns::simulator::getEventScheduler()->scheduleDelay(
+		Timer(this, &Transmitter::abortTransmission),
+		this->sensingTime);
+	this->timerPending = true;
+}
+
+void
+Transmitter::onWireIdle(
+	ChannelId /*channel*/)
+{
+	this->wakeupRequested = false;
+
+	if (this->state == Releasing)
+	{
+		this->nextPDU();
+		return;
+	}
+
+	if (this->state != WaitingForIdle || this->timerPending)
+	{
+		return;
+	}
+
+	if (this->sensingTime > 0.0)
+	{
+		// the idle channel is detected after the sensing time
+		this->timer = wns::simulator::getEventScheduler()->scheduleDelay(
+			Timer(this, &Transmitter::attempt),
+			this->sensingTime);
+		this->timerPending = true;
+	}
+	else
+	{
+		this->attempt();
+	}
+}
+
+void
+Transmitter::attempt(
+	)
+{
+	// may be called by the timer
+	this->timerPending = false;
+
+	if (this->isChannelIdle())
+	{
+		COPPER_FRAME_MESSAGE(NORMAL, this->logger, "channel idle, attempt " << this->attempts + 1);
+		this->state = Transmitting;
+		this->collisionDetected = false;
+		this->transmit(this->current);
+	}
+	else
+	{
+		this->state = WaitingForIdle;
+		if (!this->wakeupRequested)
+		{
+			this->wakeupRequested = true;
+			this->wire->wakeupOnIdle(this, this->channel);
+		}
+	}
+}
+
+void
+Transmitter::abortTransmission(
+	)
+{
+	this->timerPending = false;
+
+	assure(this->state == Transmitting, "No transmission to abort");
+
+	// backoff may drop the PDU and wait for the free channel, which
+	// stopTransmission signals
+	wns::osi::PDUPtr pdu = this->current.pdu;
+	this->backoff();
+	this->wire->stopTransmission(pdu);
+}
+
+void
+Transmitter::backoff(
+	)
+{
+	++this->attempts;
+	this->collisionDetected = false;
+
+	if (this->attempts >= this->maxAttempts)
+	{
+		++this->droppedPDUs;
+		COPPER_FRAME_MESSAGE(NORMAL, this->logger, "dropping PDU after " << this->attempts << " attempts");
+		this->finishPDU(true);
+		return;
+	}
+
+	unsigned long window = 1UL << std::min(this->attempts, this->maxBackoffExponent);
+	unsigned long slots = static_cast<unsigned long>(this->backoffDistribution() * window);
+	slots = std::min(slots, window - 1);
+
+	COPPER_FRAME_MESSAGE(NORMAL, this->logger, "backoff for " << slots << " of " << window << " slots");
+
+	this->state = BackingOff;
+	this->timer = wns::simulator::getEventScheduler()->scheduleDelay(
+		Timer(this, &Transmitter::attempt),
+		slots * this->backoffSlotTime);
+	this->timerPending = true;
+}
+
+void
+Transmitter::nextPDU(
+	)
+{
+	this->state = Idle;
+
+	if (!this->queue->empty())
+	{
+		this->current = this->queue->front();
+		this->queue->pop();
+		this->attempt();
+	}
+}
+
+void
+Transmitter::finishPDU(
+	bool freeChannelPending)
+{
+	this->current = PendingTransmission();
+	this->attempts = 0;
+	this->collisionDetected = false;
+	this->state = Idle;
+
+	if (this->queue->empty())
+	{
+		return;
+	}
+
+	if (!freeChannelPending)
+	{
+		this->nextPDU();
+		return;
+	}
+
+	// PDUs queued meanwhile wait for onWireIdle
+	this->state = Releasing;
+	if (!this->wakeupRequested)
+	{
+		this->wakeupRequested = true;
+		this->wire->wakeupOnIdle(this, this->channel);
+	}
+}
+
+void
+Transmitter::cancelTimer(
+	)
+{
+	if (this->timerPending)
+	{
+		wns::simulator::getEventScheduler()->cancelEvent(this->timer);
+		this->timerPending = false;
+	}
+}
+
+bool
+Transmitter::isChannelIdle(
+	) const
+{
+	return this->wire->blockedSince(this->channel) < this->sensingTime;
+}
+
+bool
+Transmitter::isCarrierBusyAt(simTimeType t) const
+{
+	return this->wire->isCarrierBusyAt(this->channel, t, this->sensingTime);
+}
+
+void
+Transmitter::setChannel(
+	ChannelId _channel)
+{
+	if (_channel >= this->wire->getNumberOfChannels())
+	{
+		wns::Exception e;
+		e << "Channel " << _channel << " not available, wire has only "
+		  << this->wire->getNumberOfChannels() << " channel(s)";
+		throw e;
+	}
+	this->channel = _channel;
+}
+
+ChannelId
+Transmitter::getChannel(
+	) const
+{
+	return this->channel;
+}
+
+void
+Transmitter::setPriority(
+	TransmitQueue::Priority _priority)
+{
+	if (this->queue.get() == NULL || _priority >= this->queue->getNumberOfPriorities())
+	{
+		wns::Exception e;
+		e << "Priority " << _priority << " not available";
+		throw e;
+	}
+	this->priority = _priority;
+}
+
+TransmitQueue::Priority
+Transmitter::getPriority(
+	) const
+{
+	return this->priority;
 }
 
 simTimeType
@@ -105,6 +708,3 @@ Transmitter::getDuration(
 {
 	return len/this->dataRate;
 }
-
-
-
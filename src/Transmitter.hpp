@@ -28,15 +28,28 @@
 #ifndef COPPER_TRANSMITTER_HPP
 #define COPPER_TRANSMITTER_HPP
 
+#include <COPPER/Transmission.hpp>
+#include <COPPER/TDMAExecutor.hpp>
+#include <COPPER/TransmitQueue.hpp>
+#include <COPPER/LatencyHistogram.hpp>
+
 #include <WNS/service/phy/copper/DataTransmissionFeedback.hpp>
 #include <WNS/service/phy/copper/DataTransmission.hpp>
 #include <WNS/service/phy/copper/Handler.hpp>
+#include <WNS/events/scheduler/Interface.hpp>
+#include <WNS/distribution/Uniform.hpp>
 #include <WNS/logger/Logger.hpp>
 
+#include <memory>
+
 namespace copper
 {
 	class WireInterface;
 
+	/**
+	 * @brief Interface used by the Wire to inform the sender of a
+	 * transmission
+	 */
 	class TransmitterDataSentInterface
 	{
 	public:
@@ -45,9 +58,27 @@ namespace copper
 		{
 		}
 
+		/**
+		 * @brief The transmission has been completed (it may have
+		 * collided, see Transmission::collision)
+		 */
 		virtual void
 		onDataSent(
-			wns::osi::PDUPtr pdu) = 0;
+			const TransmissionPtr& transmission) = 0;
+
+		/**
+		 * @brief The ongoing transmission collided with another one
+		 */
+		virtual void
+		onCollision(
+			const TransmissionPtr& transmission) = 0;
+
+		/**
+		 * @brief The channel got free (see WireInterface::wakeupOnIdle)
+		 */
+		virtual void
+		onWireIdle(
+			ChannelId channel) = 0;
 	};
 
 	/**
@@ -57,17 +88,83 @@ namespace copper
 	 * This transmitter can detect ongoing transmissions after a
 	 * configurable amount time (sensing time). Setting this time to 0.0
 	 * (the default) allows collision free operation.
+	 *
+	 * The transmitter sends on one channel of the wire at a time. The
+	 * channel is configured and may be switched by the upper layer
+	 * between two transmissions.
+	 *
+	 * If a TransmitQueue is configured, sendData only queues the PDU
+	 * (with the priority set by setPriority) and the queue is drained
+	 * by the transmitter itself: The head of the queue is sent as soon
+	 * as the channel is sensed idle, the wire wakes the transmitter up
+	 * when the channel gets free (see WireInterface::wakeupOnIdle). PDUs
+	 * are dropped if their priority class is full. After a transmission
+	 * the next PDU is started by the same wakeup, when the wire signals
+	 * the free channel, and waits behind senders that registered
+	 * earlier.
+	 *
+	 * If the transmitter is configured as station of the wire's TDMA
+	 * schedule, the queued PDUs are sent one per slot granted by the
+	 * TDMAExecutor and the wire is not sensed. PDUs that do not fit
+	 * into a slot are dropped when they are sent.
+	 *
+	 * If CSMA/CD is configured in addition to the queue, the transmitter
+	 * aborts the transmission if a collision is detected (after the
+	 * sensing time) and retries after a binary exponential backoff. After
+	 * maxAttempts failed attempts the PDU is dropped. The upper layer
+	 * only sees onDataSent for successfully transmitted PDUs.
 	 */
 	class Transmitter :
 		virtual public wns::service::phy::copper::DataTransmission,
 		virtual public wns::service::phy::copper::DataTransmissionFeedback,
-		virtual public TransmitterDataSentInterface
+		virtual public TransmitterDataSentInterface,
+		virtual public TransmitOpportunityInterface
 	{
 		typedef wns::service::phy::copper::DataTransmission
 		Super;
 
 		typedef wns::service::phy::copper::Handler
 		Handler;
+
+		/**
+		 * @brief State of the channel access of the PDU taken from the
+		 * queue
+		 */
+		enum ContentionState
+		{
+			Idle,
+			WaitingForIdle,
+			BackingOff,
+			Transmitting,
+			Releasing
+		};
+
+		/**
+		 * @brief Calls a member function of the Transmitter (used for
+		 * the backoff and collision detection timers)
+		 */
+		class Timer
+		{
+		public:
+			Timer(Transmitter* t, void (Transmitter::*f)()) :
+				transmitter(t),
+				function(f)
+			{
+				assure(this->transmitter, "must be non-NULL");
+			}
+
+			void
+			operator()()
+			{
+				(this->transmitter->*function)();
+			}
+
+		private:
+			Transmitter* transmitter;
+
+			void (Transmitter::*function)();
+		};
+
 	public:
 		/**
 		 * @brief Constructor
@@ -101,16 +198,159 @@ namespace copper
 		cancelData(
 			const wns::osi::PDUPtr& data);
 
+		/**
+		 * @brief With a TransmitQueue true as long as the priority
+		 * class is not full
+		 */
 		virtual bool
 		isFree(
 			) const;
 		//@}
 
+		/**
+		 * @name TransmitterDataSentInterface
+		 */
+		//@{
 		virtual void
 		onDataSent(
-			wns::osi::PDUPtr pdu);
+			const TransmissionPtr& transmission);
+
+		virtual void
+		onCollision(
+			const TransmissionPtr& transmission);
+
+		virtual void
+		onWireIdle(
+			ChannelId channel);
+		//@}
+
+		/**
+		 * @brief Select the channel of the wire used by subsequent
+		 * calls to sendData and isFree
+		 */
+		void
+		setChannel(
+			ChannelId _channel);
+
+		/**
+		 * @brief Returns the channel of the wire used for transmission
+		 */
+		ChannelId
+		getChannel(
+			) const;
+
+		/**
+		 * @brief True if the channel was sensed busy at time t (t <=
+		 * now), the same answer as Receiver::isCarrierBusyAt for the
+		 * same sensing time (see WireInterface::isCarrierBusyAt)
+		 */
+		bool
+		isCarrierBusyAt(simTimeType t) const;
+
+		/**
+		 * @brief Select the priority class of the TransmitQueue used by
+		 * subsequent calls to sendData, sendBurst and isFree
+		 */
+		void
+		setPriority(
+			TransmitQueue::Priority _priority);
+
+		TransmitQueue::Priority
+		getPriority(
+			) const;
+
+		/**
+		 * @brief Send the PDU to the members of the multicast group
+		 * (queued like sendData)
+		 */
+		void
+		sendMulticast(
+			GroupId group,
+			const wns::osi::PDUPtr& data);
+
+		/**
+		 * @brief Send the PDUs back-to-back as a single transmission
+		 *
+		 * The wire is occupied once for the sum of the PDU durations.
+		 * Each PDU is delivered individually (with its own BER) and
+		 * onDataSent is called for each PDU. The burst is identified
+		 * by its first PDU, cancelData with this PDU cancels the whole
+		 * burst.
+		 */
+		void
+		sendBurst(
+			const wns::service::dll::BroadcastAddress& peerAddress,
+			const PDUContainer& pdus);
+
+		/**
+		 * @brief Unicast variant of sendBurst
+		 */
+		void
+		sendBurst(
+			const wns::service::dll::UnicastAddress& peerAddress,
+			const PDUContainer& pdus);
+
+		/**
+		 * @brief Number of dropped PDUs (queue full, longer than a TDMA
+		 * slot or maximum number of CSMA/CD attempts reached)
+		 */
+		unsigned long
+		getDroppedPDUs(
+			) const;
+
+		/**
+		 * @brief Delay from sendData until the successful
+		 * transmission starts, with CSMA/CD including backoff and
+		 * retries (NULL if not configured). Dropped PDUs are not
+		 * recorded.
+		 */
+		const LatencyHistogram*
+		getAccessDelayHistogram() const;
+
+		/**
+		 * @brief Delay from sendData until onDataSent is reported to
+		 * the upper layer (NULL if not configured)
+		 */
+		const LatencyHistogram*
+		getLatencyHistogram() const;
+
+		/**
+		 * @brief Writes the percentiles of the histograms to the logger
+		 */
+		void
+		writeHistograms() const;
+
+		/**
+		 * @name TransmitOpportunityInterface
+		 */
+		//@{
+		virtual void
+		onTransmitOpportunity(
+			simTimeType duration);
+		//@}
 
 	private:
+		/**
+		 * @brief Starts the transmission on the wire
+		 */
+		void
+		transmit(
+			const PendingTransmission& pt);
+
+		/**
+		 * @brief Queues or transmits immediately (no TransmitQueue)
+		 */
+		void
+		send(
+			const PendingTransmission& pt);
+
+		/**
+		 * @brief Duration of the transmission of all PDUs
+		 */
+		simTimeType
+		getDuration(
+			const PendingTransmission& pt);
+
 		/**
 		 * @brief Calculate how long it takes to transmit "len" Bit
 		 */
@@ -118,11 +358,80 @@ namespace copper
 		getDuration(
 			Bit len);
 
+		/**
+		 * @brief True if the channel is sensed idle
+		 */
+		bool
+		isChannelIdle(
+			) const;
+
+		/**
+		 * @name Channel access
+		 */
+		//@{
+		/**
+		 * @brief Transmit the current PDU if the channel is idle, wait
+		 * for the channel to get idle otherwise
+		 */
+		void
+		attempt(
+			);
+
+		/**
+		 * @brief Called by the collision detection timer, aborts the
+		 * collided transmission
+		 */
+		void
+		abortTransmission(
+			);
+
+		/**
+		 * @brief Schedule the next attempt or drop the PDU if the
+		 * maximum number of attempts is reached
+		 */
+		void
+		backoff(
+			);
+
+		/**
+		 * @brief Takes the next PDU from the queue (if any) and tries
+		 * to transmit it, no PDU may be in contention
+		 */
+		void
+		nextPDU(
+			);
+
+		/**
+		 * @brief Done with the current PDU
+		 *
+		 * If freeChannelPending is set the wire is completing (or about
+		 * to stop) a transmission of this transmitter, the next PDU is
+		 * then taken from the queue by onWireIdle when the wire signals
+		 * the free channel (see Wire::signalCopperFreeAgainToReceivers).
+		 * Otherwise it is taken at once.
+		 */
+		void
+		finishPDU(
+			bool freeChannelPending);
+
+		/**
+		 * @brief Cancels the pending timer (if any)
+		 */
+		void
+		cancelTimer(
+			);
+		//@}
+
 		/**
 		 * @brief Wire to be used for transmission
 		 */
 		WireInterface* wire;
 
+		/**
+		 * @brief Channel of the wire to be used for transmission
+		 */
+		ChannelId channel;
+
 		/**
 		 * @brief The data rate the transmitter is able to use for tranmission
 		 */
@@ -134,6 +443,99 @@ namespace copper
 		 */
 		simTimeType sensingTime;
 
+		/**
+		 * @brief TDMA executor of the wire if the transmitter is a TDMA
+		 * station, NULL otherwise
+		 */
+		TDMAExecutor* tdma;
+
+		/**
+		 * @brief Station id in the TDMA schedule
+		 */
+		int tdmaStation;
+
+		/**
+		 * @brief PDUs waiting for a TDMA slot or channel access, NULL
+		 * if not configured
+		 */
+		std::auto_ptr<TransmitQueue> queue;
+
+		/**
+		 * @brief Priority class used by sendData
+		 */
+		TransmitQueue::Priority priority;
+
+		/**
+		 * @brief PDU taken from the queue, valid unless state is Idle
+		 * or Releasing
+		 */
+		PendingTransmission current;
+
+		/**
+		 * @brief True if CSMA/CD is configured
+		 */
+		bool csma;
+
+		/**
+		 * @brief Duration of a backoff slot
+		 */
+		simTimeType backoffSlotTime;
+
+		/**
+		 * @brief Attempts per PDU before it is dropped
+		 */
+		unsigned int maxAttempts;
+
+		/**
+		 * @brief The contention window is at most 2^maxBackoffExponent
+		 * slots
+		 */
+		unsigned int maxBackoffExponent;
+
+		ContentionState state;
+
+		/**
+		 * @brief Failed attempts of the current PDU
+		 */
+		unsigned int attempts;
+
+		/**
+		 * @brief True if a collision of the ongoing transmission has
+		 * been detected
+		 */
+		bool collisionDetected;
+
+		/**
+		 * @brief True if registered at the wire via wakeupOnIdle
+		 */
+		bool wakeupRequested;
+
+		/**
+		 * @brief Backoff, collision detection or sensing timer
+		 */
+		wns::events::scheduler::IEventPtr timer;
+
+		bool timerPending;
+
+		/**
+		 * @brief Start of the latest transmission (attempt)
+		 */
+		simTimeType transmittedAt;
+
+		unsigned long droppedPDUs;
+
+		/**
+		 * @brief Histograms (NULL if delayHistogram is not configured)
+		 */
+		std::auto_ptr<LatencyHistogram> accessDelay;
+
+		std::auto_ptr<LatencyHistogram> latency;
+
+		/**
+		 * @brief Draws the backoff
+		 */
+		wns::distribution::StandardUniform backoffDistribution;
+
 		/**
 		 * @brief Logger
 		 */
@@ -142,5 +544,3 @@ namespace copper
 }
 
 #endif // NOT defined COPPER_TRANSMITTER_HPP
-
-
@@ -30,6 +30,7 @@
 #include <COPPER/Receiver.hpp>
 #include <COPPER/Transmission.hpp>
 #include <COPPER/Transmitter.hpp>
+#include <COPPER/Logging.hpp>
 
 #include <WNS/service/phy/copper/Handler.hpp>
 #include <WNS/service/dll/Address.hpp>
@@ -37,22 +38,127 @@
 #include <WNS/Exception.hpp>
 #include <WNS/rng/RNGen.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 using namespace copper;
 
+const ChannelId Wire::maxChannels;
+
 Wire::Wire(const wns::pyconfig::View& config) :
 	name(config.get<std::string>("name")),
+	id(0),
 	roundRobin(),
 	receivers(),
+	broadcastSubscribers(),
+	carrierSenseReceivers(),
+	carrierSenseInterests(),
+	indexedReceivers(),
+	receiverIndices(),
+	groups(),
 	transmissionEndEvents(),
 	transmissions(),
 	addressMapping(),
-	logger(config.get<wns::pyconfig::View>("logger"))
+	taps(),
+	logger(config.get<wns::pyconfig::View>("logger")),
+	channels(config.get<ChannelId>("channels")),
+	idleWaiters(channels.size()),
+	busyHistory(channels.size(), BusyHistory(config.get<unsigned int>("busyHistory"))),
+	busyChannels(0),
+	slotDuration(config.get<simTimeType>("slotDuration")),
+	slotTransmissions(),
+	slotPositions(),
+	activeSlotTransmissions(0),
+	currentSlot(0),
+	slotEndEvent(),
+	tdmaExecutor(NULL),
+	counters(),
+	createdAt(wns::simulator::getEventScheduler()->getTime()),
+	busySince(0.0),
+	utilizationProbe(),
+	collisionsProbe(),
+	framesCompletedProbe(),
+	framesCancelledProbe(),
+	peakConcurrentTransmissionsProbe(),
+	trace(NULL),
+	chromeTrace(NULL),
+	pcap(NULL)
 {
+	static unsigned int nextId = 0;
+	this->id = nextId++;
+
+	if (this->channels.empty() || this->channels.size() > maxChannels)
+	{
+		wns::Exception e;
+		e << "Wire " << this->name << ": number of channels must be in [1, "
+		  << maxChannels << "] but is " << this->channels.size();
+		throw e;
+	}
+
+	if (this->slotDuration < 0.0)
+	{
+		wns::Exception e;
+		e << "Wire " << this->name << ": slot duration must not be negative";
+		throw e;
+	}
+
+	if (!config.isNone("tdma"))
+	{
+		this->tdmaExecutor = new TDMAExecutor(config.get("tdma"));
+	}
+
+	if (!config.isNone("probePrefix"))
+	{
+		std::string prefix = config.get<std::string>("probePrefix");
+		this->utilizationProbe = wns::probe::bus::ContextCollectorPtr(
+			new wns::probe::bus::ContextCollector(prefix + ".utilization"));
+		this->collisionsProbe = wns::probe::bus::ContextCollectorPtr(
+			new wns::probe::bus::ContextCollector(prefix + ".collisions"));
+		this->framesCompletedProbe = wns::probe::bus::ContextCollectorPtr(
+			new wns::probe::bus::ContextCollector(prefix + ".framesCompleted"));
+		this->framesCancelledProbe = wns::probe::bus::ContextCollectorPtr(
+			new wns::probe::bus::ContextCollector(prefix + ".framesCancelled"));
+		this->peakConcurrentTransmissionsProbe = wns::probe::bus::ContextCollectorPtr(
+			new wns::probe::bus::ContextCollector(prefix + ".peakConcurrentTransmissions"));
+	}
+
+	if (!config.isNone("trace"))
+	{
+		this->trace = new WireTrace(config.get("trace"));
+	}
+
+	if (!config.isNone("chromeTrace"))
+	{
+		this->chromeTrace = new ChromeTrace(
+			config.get("chromeTrace"), this->id, this->name, this->channels.size());
+	}
+
+	if (!config.isNone("pcap"))
+	{
+		this->pcap = new PcapCapture(config.get("pcap"), this->id);
+	}
+
+	Wire::getWireList().push_back(this);
+
 	MESSAGE_BEGIN(NORMAL, logger, m, "Created wire: ");
-	m << this->name;
+	m << this->name << " with " << this->channels.size() << " channel(s)";
+	if (this->isSlotted())
+	{
+		m << ", slot duration " << this->slotDuration;
+	}
 	MESSAGE_END();
 }
 
+Wire::~Wire()
+{
+	Wire::getWireList().remove(this);
+
+	delete this->tdmaExecutor;
+	delete this->trace;
+	delete this->chromeTrace;
+	delete this->pcap;
+}
+
 void
 Wire::sendData(const UnicastTransmissionPtr& ut, simTimeType duration)
 {
@@ -61,10 +167,13 @@ Wire::sendData(const UnicastTransmissionPtr& ut, simTimeType duration)
 		"Target receiver not at this wire");
 
 	simTimeType arrivalTime = sendDataGeneric(ut, duration);
+	this->counters.unicastBits += getLengthInBits(ut);
 
- 	MESSAGE_SINGLE(
+ 	COPPER_FRAME_RECORD(
 		       NORMAL, this->logger,
+		       WireUnicastStart, this->id, ut->target.getInteger(), ut->channel, arrivalTime,
 		       "Sending to MAC address: " << ut->target
+		       << " on channel " << ut->channel
 		       << ". Arrival time: " << arrivalTime);
 
 }
@@ -73,47 +182,161 @@ void
 Wire::sendData(const BroadcastTransmissionPtr& bt, simTimeType duration)
 {
 	simTimeType arrivalTime = sendDataGeneric(bt, duration);
+	this->counters.broadcastBits += getLengthInBits(bt);
 
-	MESSAGE_SINGLE(
+	COPPER_FRAME_RECORD(
 		NORMAL, this->logger,
-		"Sending to: BROADCAST. Arrival time: " << arrivalTime);
+		WireBroadcastStart, this->id, -1, bt->channel, arrivalTime,
+		"Sending to: BROADCAST on channel " << bt->channel
+		<< ". Arrival time: " << arrivalTime);
+}
+
+void
+Wire::sendData(const MulticastTransmissionPtr& mt, simTimeType duration)
+{
+	simTimeType arrivalTime = sendDataGeneric(mt, duration);
+	this->counters.multicastBits += getLengthInBits(mt);
+
+	COPPER_FRAME_RECORD(
+		NORMAL, this->logger,
+		WireMulticastStart, this->id, mt->group, mt->channel, arrivalTime,
+		"Sending to: group " << mt->group << " on channel " << mt->channel
+		<< ". Arrival time: " << arrivalTime);
 }
 
 simTimeType
-Wire::blockedSince() const
+Wire::blockedSince(ChannelId channel) const
 {
-	if (this->isFree())
+	assure(channel < this->channels.size(), "Channel not available at this wire");
+
+	if (this->isFree(channel))
 	{
 		// return a number < 0 (doesn't matter)
 		return -1.0;
 	}
 	else
 	{
-		// the wire is blocked, return the time for which the wire
-		// has been blocked
-		return wns::simulator::getEventScheduler()->getTime() - this->timeWireBlocked;
+		// the channel is blocked, return the time for which the
+		// channel has been blocked
+		return wns::simulator::getEventScheduler()->getTime() - this->channels[channel].timeBlocked;
 	}
 }
 
+simTimeType
+Wire::blockedSinceAt(ChannelId channel, simTimeType t) const
+{
+	assure(channel < this->channels.size(), "Channel not available at this wire");
+	assure(t <= wns::simulator::getEventScheduler()->getTime(), "Cannot look into the future");
+
+	return this->busyHistory[channel].blockedSince(t);
+}
+
+bool
+Wire::isCarrierBusyAt(ChannelId channel, simTimeType t, simTimeType sensingTime) const
+{
+	assure(channel < this->channels.size(), "Channel not available at this wire");
+	assure(t <= wns::simulator::getEventScheduler()->getTime(), "Cannot look into the future");
+
+	return this->busyHistory[channel].isBusyAt(t, sensingTime);
+}
+
+ChannelId
+Wire::getNumberOfChannels() const
+{
+	return this->channels.size();
+}
+
+TDMAExecutor*
+Wire::getTDMAExecutor() const
+{
+	return this->tdmaExecutor;
+}
+
+void
+Wire::wakeupOnIdle(TransmitterDataSentInterface* sender, ChannelId channel)
+{
+	assure(sender, "must be non-NULL");
+	assure(channel < this->channels.size(), "Channel not available at this wire");
+
+	this->idleWaiters[channel].push_back(sender);
+}
+
+void
+Wire::cancelWakeupOnIdle(TransmitterDataSentInterface* sender)
+{
+	for (ChannelId channel = 0; channel < this->idleWaiters.size(); ++channel)
+	{
+		this->idleWaiters[channel].remove(sender);
+	}
+}
+
+size_t
+Wire::getNumberOfIdleWaiters(ChannelId channel) const
+{
+	assure(channel < this->idleWaiters.size(), "Channel not available at this wire");
+	return this->idleWaiters[channel].size();
+}
 
 bool
 Wire::isFree() const
 {
-	return this->transmissions.empty();
+	return this->busyChannels == 0;
+}
+
+bool
+Wire::isFree(ChannelId channel) const
+{
+	return (this->busyChannels & (ChannelMask(1) << channel)) == 0;
+}
+
+void
+Wire::occupyChannel(const TransmissionPtr& t)
+{
+	if (this->busyChannels == 0)
+	{
+		this->busySince = wns::simulator::getEventScheduler()->getTime();
+	}
+	++this->channels[t->channel].activeTransmissions;
+	this->busyChannels |= ChannelMask(1) << t->channel;
+}
+
+bool
+Wire::releaseChannel(const TransmissionPtr& t)
+{
+	Channel& c = this->channels[t->channel];
+	assure(c.activeTransmissions > 0, "No transmission active on this channel");
+
+	if (--c.activeTransmissions == 0)
+	{
+		if (this->chromeTrace != NULL)
+		{
+			this->chromeTrace->busyPeriod(
+				t->channel, c.timeBlocked, wns::simulator::getEventScheduler()->getTime());
+		}
+		this->busyHistory[t->channel].free(wns::simulator::getEventScheduler()->getTime());
+		this->busyChannels &= ~(ChannelMask(1) << t->channel);
+		if (this->busyChannels == 0)
+		{
+			this->counters.busyTime +=
+				wns::simulator::getEventScheduler()->getTime() - this->busySince;
+		}
+		return true;
+	}
+	return false;
 }
 
 void
 Wire::addReceiver(
 	ReceiverInterface* r,
-	const wns::service::dll::UnicastAddress& macAddress)
+	const wns::service::dll::UnicastAddress& macAddress,
+	bool carrierSenseInterest)
 {
 	assure(r, "wo must be non-NULL");
 	MESSAGE_SINGLE(
 		NORMAL, this->logger,
 		"adding receiver with MAC address" << macAddress);
 
-	this->roundRobin.add(r);
-	this->receivers.push_back(r);
+	// the wire is left unchanged if the address is taken
 	if (this->addressMapping.find(macAddress) != this->addressMapping.end())
 	{
 		wns::Exception e;
@@ -122,32 +345,234 @@ Wire::addReceiver(
 		  <<") is already registered";
 		throw e;
 	}
+
+	if (carrierSenseInterest)
+	{
+		this->roundRobin.add(r);
+		this->carrierSenseReceivers.push_back(r);
+	}
+	this->receivers.push_back(r);
+	this->broadcastSubscribers.push_back(this->indexedReceivers.size());
+	this->carrierSenseInterests.push_back(carrierSenseInterest);
+	this->receiverIndices[r] = this->indexedReceivers.size();
+	this->addressMapping[macAddress] = this->indexedReceivers.size();
+	this->indexedReceivers.push_back(r);
+
+	if (this->chromeTrace != NULL)
+	{
+		this->chromeTrace->addReceiver(r, macAddress);
+	}
+}
+
+void
+Wire::setBroadcastSubscription(ReceiverInterface* r, bool subscribed)
+{
+	std::map<ReceiverInterface*, size_t>::const_iterator index = this->receiverIndices.find(r);
+	assure(index != this->receiverIndices.end(), "Receiver not at this wire");
+
+	// sorted indices keep the order in which the receivers were added
+	std::vector<size_t>::iterator itr = std::lower_bound(
+		this->broadcastSubscribers.begin(), this->broadcastSubscribers.end(), index->second);
+	bool isSubscribed = itr != this->broadcastSubscribers.end() && *itr == index->second;
+
+	if (subscribed == isSubscribed)
+	{
+		return;
+	}
+
+	if (subscribed)
+	{
+		this->broadcastSubscribers.insert(itr, index->second);
+	}
+	else
+	{
+		this->broadcastSubscribers.erase(itr);
+	}
+}
+
+size_t
+Wire::getNumberOfBroadcastSubscribers() const
+{
+	return this->broadcastSubscribers.size();
+}
+
+void
+Wire::setCarrierSenseInterest(ReceiverInterface* r, bool interested)
+{
+	std::map<ReceiverInterface*, size_t>::const_iterator index = this->receiverIndices.find(r);
+	assure(index != this->receiverIndices.end(), "Receiver not at this wire");
+
+	if (interested == this->carrierSenseInterests[index->second])
+	{
+		return;
+	}
+	this->carrierSenseInterests[index->second] = interested;
+
+	// only an actual change searches the receivers, the initial
+	// interest is set by addReceiver
+	if (interested)
+	{
+		this->carrierSenseReceivers.push_back(r);
+		this->roundRobin.add(r);
+	}
+	else
+	{
+		this->carrierSenseReceivers.erase(
+			std::find(this->carrierSenseReceivers.begin(), this->carrierSenseReceivers.end(), r));
+		this->roundRobin.remove(r);
+	}
+}
+
+size_t
+Wire::getNumberOfCarrierSenseReceivers() const
+{
+	return this->carrierSenseReceivers.size();
+}
+
+void
+Wire::setGroupMembership(GroupId group, ReceiverInterface* r, bool member)
+{
+	std::map<ReceiverInterface*, size_t>::const_iterator itr = this->receiverIndices.find(r);
+	assure(itr != this->receiverIndices.end(), "Receiver not at this wire");
+
+	if (group >= this->groups.size())
+	{
+		this->groups.resize(group + 1);
+	}
+
+	GroupMembers& members = this->groups[group];
+	size_t word = itr->second / 32;
+	uint32_t bit = uint32_t(1) << (itr->second % 32);
+	if (word >= members.size())
+	{
+		members.resize(word + 1, 0);
+	}
+
+	if (member)
+	{
+		members[word] |= bit;
+	}
 	else
 	{
-		this->addressMapping[macAddress] = r;
+		members[word] &= ~bit;
+	}
+}
+
+size_t
+Wire::getNumberOfGroupMembers(GroupId group) const
+{
+	if (group >= this->groups.size())
+	{
+		return 0;
+	}
+
+	size_t n = 0;
+	const GroupMembers& members = this->groups[group];
+	for (size_t word = 0; word < members.size(); ++word)
+	{
+		n += __builtin_popcount(members[word]);
+	}
+	return n;
+}
+
+void
+Wire::addTap(WireTap* tap)
+{
+	assure(tap, "must be non-NULL");
+	assure(
+		std::find(this->taps.begin(), this->taps.end(), tap) == this->taps.end(),
+		"Tap already registered");
+
+	this->taps.push_back(tap);
+}
+
+void
+Wire::removeTap(WireTap* tap)
+{
+	std::vector<WireTap*>::iterator itr =
+		std::find(this->taps.begin(), this->taps.end(), tap);
+	assure(itr != this->taps.end(), "Tap not registered");
+
+	this->taps.erase(itr);
+}
+
+void
+Wire::notifyTaps(const UnicastTransmissionPtr& ut)
+{
+	for (size_t ii = 0; ii < this->taps.size(); ++ii)
+	{
+		this->taps[ii]->onUnicast(ut);
+	}
+}
+
+void
+Wire::notifyTaps(const BroadcastTransmissionPtr& bt)
+{
+	for (size_t ii = 0; ii < this->taps.size(); ++ii)
+	{
+		this->taps[ii]->onBroadcast(bt);
+	}
+}
+
+void
+Wire::notifyTaps(const MulticastTransmissionPtr& mt)
+{
+	for (size_t ii = 0; ii < this->taps.size(); ++ii)
+	{
+		this->taps[ii]->onMulticast(mt);
 	}
 }
 
 void
 Wire::stopTransmission(const wns::osi::PDUPtr& pdu)
 {
+	COPPER_PROFILE_SCOPE("Wire::stopTransmission(cancel)");
 	assure(
 		this->transmissions.find(pdu) != this->transmissions.end(),
 		"Transmission not active");
 
-	TransmissionEndEventContainer::iterator itr =
-		this->transmissionEndEvents.find(pdu);
+	if (this->isSlotted())
+	{
+		// the entry may belong to the slot being completed, so it is
+		// only marked
+		SlotPositions::iterator position = this->slotPositions.find(pdu);
+		assure(position != this->slotPositions.end(), "Transmission not in current slot");
+		position->second->cancelled = true;
+
+		if (position->second->slot == this->currentSlot && --this->activeSlotTransmissions == 0)
+		{
+			// last transmission of the slot -> no need to end the slot
+			wns::simulator::getEventScheduler()->cancelEvent(this->slotEndEvent);
+			this->slotTransmissions.clear();
+		}
+		this->slotPositions.erase(position);
+	}
+	else
+	{
+		TransmissionEndEventContainer::iterator itr =
+			this->transmissionEndEvents.find(pdu);
+
+		// delete event from EventScheduler
+		wns::simulator::getEventScheduler()->cancelEvent(itr->second);
+	}
 
-	// delete event from EventScheduler
-	wns::simulator::getEventScheduler()->cancelEvent(itr->second);
-	// manually execute the event to stop transmission
-	this->transmissionEndEvents.erase(itr);
+	// keep the transmission, it is needed to find the channel
+	TransmissionPtr transmission = this->transmissions[pdu];
+	this->removeTransmissionEndEvent(transmission);
+	++this->counters.framesCancelled;
 
-	this->transmissions.erase(pdu);
+	if (this->isTracing())
+	{
+		this->trace->record(TraceRecord::Cancel, this->id, transmission, -1);
+	}
+	if (this->chromeTrace != NULL)
+	{
+		this->chromeTrace->end(transmission, true);
+	}
 
-	if (this->isFree())
+	if (this->isFree(transmission->channel))
 	{
-		this->signalCopperFreeAgainToReceivers();
+		this->signalCopperFreeAgainToReceivers(transmission->channel);
 	}
 
 }
@@ -161,11 +586,26 @@ Wire::removeTransmissionEndEvent(const TransmissionPtr& transmission)
 
 	this->transmissionEndEvents.erase(transmission->pdu);
 	this->transmissions.erase(transmission->pdu);
+	this->releaseChannel(transmission);
+}
+
+template <typename TRANSMISSIONTYPE>
+bool
+Wire::deliver(size_t index, const TRANSMISSIONTYPE& transmission)
+{
+	bool received = this->indexedReceivers[index]->onData(transmission);
+
+	if (received && this->chromeTrace != NULL)
+	{
+		this->chromeTrace->delivery(this->indexedReceivers[index], transmission);
+	}
+	return received;
 }
 
 void
 Wire::stopTransmission(const UnicastTransmissionPtr& ut)
 {
+	COPPER_PROFILE_SCOPE("Wire::stopTransmission(unicast)");
 	assure(ut, "must be non-NULL");
 
 	Address2ReceiverContainer::iterator itr =
@@ -174,90 +614,441 @@ Wire::stopTransmission(const UnicastTransmissionPtr& ut)
 	assure(itr != this->addressMapping.end(), "Target receiver not at this wire");
 
 	this->removeTransmissionEndEvent(ut);
+	++this->counters.framesCompleted;
+
+	if (this->isTracing())
+	{
+		this->trace->record(TraceRecord::End, this->id, ut, -1);
+	}
+	if (this->chromeTrace != NULL)
+	{
+		this->chromeTrace->end(ut, false);
+	}
+	if (this->pcap != NULL)
+	{
+		this->pcap->capture(ut, PcapPacketHeader::Unicast, ut->target.getInteger());
+	}
 
 	// inform sender, that the data has been sent
-	ut->sender->onDataSent(ut->pdu);
+	ut->sender->onDataSent(ut);
 
 	// inform the receiver, that there is data available
-	itr->second->onData(ut);
+	this->deliver(itr->second, ut);
+
+	if (!this->taps.empty())
+	{
+		this->notifyTaps(ut);
+	}
 
-	MESSAGE_SINGLE(NORMAL, this->logger, "UnicastTransmission finished");
+	COPPER_FRAME_RECORD(
+		NORMAL, this->logger,
+		WireUnicastEnd, this->id, ut->target.getInteger(), ut->channel, 0.0,
+		"UnicastTransmission finished");
 
-	if (this->isFree())
+	if (this->isFree(ut->channel))
 	{
-		this->signalCopperFreeAgainToReceivers();
+		this->signalCopperFreeAgainToReceivers(ut->channel);
 	}
 }
 
 void
 Wire::stopTransmission(const BroadcastTransmissionPtr& bt)
 {
+	COPPER_PROFILE_SCOPE("Wire::stopTransmission(broadcast)");
 	assure(bt, "must be non-NULL");
 
 	this->removeTransmissionEndEvent(bt);
+	++this->counters.framesCompleted;
+
+	if (this->isTracing())
+	{
+		this->trace->record(TraceRecord::End, this->id, bt, -1);
+	}
+	if (this->chromeTrace != NULL)
+	{
+		this->chromeTrace->end(bt, false);
+	}
+	if (this->pcap != NULL)
+	{
+		this->pcap->capture(bt, PcapPacketHeader::Broadcast, -1);
+	}
 
 	// inform sender, that the data has been sent
-	bt->sender->onDataSent(bt->pdu);
+	bt->sender->onDataSent(bt);
 
-	// inform the receivers, that there is data available
-	for (
-		std::list<ReceiverInterface*>::iterator itr = this->receivers.begin();
-		itr != this->receivers.end();
-		++itr)
+	// inform the subscribed receivers, that there is data available
+	// (indexed, a receiver may change its subscription in onData)
+	for (size_t ii = 0; ii < this->broadcastSubscribers.size(); ++ii)
 	{
-		(*itr)->onData(bt);
+		this->deliver(this->broadcastSubscribers[ii], bt);
 	}
 
-	MESSAGE_SINGLE(NORMAL, this->logger, "BroadcastTransmission finished");
+	if (!this->taps.empty())
+	{
+		this->notifyTaps(bt);
+	}
 
-	if(this->isFree())
+	COPPER_FRAME_RECORD(
+		NORMAL, this->logger,
+		WireBroadcastEnd, this->id, -1, bt->channel, 0.0,
+		"BroadcastTransmission finished");
+
+	if(this->isFree(bt->channel))
 	{
-		this->signalCopperFreeAgainToReceivers();
+		this->signalCopperFreeAgainToReceivers(bt->channel);
 	}
 }
 
 void
-Wire::checkForCollision(const TransmissionPtr& t)
+Wire::stopTransmission(const MulticastTransmissionPtr& mt)
 {
-	if(!this->isFree())
+	COPPER_PROFILE_SCOPE("Wire::stopTransmission(multicast)");
+	assure(mt, "must be non-NULL");
+
+	this->removeTransmissionEndEvent(mt);
+	++this->counters.framesCompleted;
+
+	if (this->isTracing())
+	{
+		this->trace->record(TraceRecord::End, this->id, mt, -1);
+	}
+	if (this->chromeTrace != NULL)
+	{
+		this->chromeTrace->end(mt, false);
+	}
+	if (this->pcap != NULL)
+	{
+		this->pcap->capture(mt, PcapPacketHeader::Multicast, mt->group);
+	}
+
+	// inform sender, that the data has been sent
+	mt->sender->onDataSent(mt);
+
+	// inform the members of the group, only the set bits are visited
+	if (mt->group < this->groups.size())
+	{
+		const GroupMembers& members = this->groups[mt->group];
+		for (size_t word = 0; word < members.size(); ++word)
+		{
+			uint32_t bits = members[word];
+			while (bits != 0)
+			{
+				size_t index = word * 32 + __builtin_ctz(bits);
+				bits &= bits - 1;
+				this->deliver(index, mt);
+			}
+		}
+	}
+
+	if (!this->taps.empty())
+	{
+		this->notifyTaps(mt);
+	}
+
+	COPPER_FRAME_RECORD(
+		NORMAL, this->logger,
+		WireMulticastEnd, this->id, mt->group, mt->channel, 0.0,
+		"MulticastTransmission finished");
+
+	if(this->isFree(mt->channel))
+	{
+		this->signalCopperFreeAgainToReceivers(mt->channel);
+	}
+}
+
+void
+Wire::checkForCollision(const TransmissionPtr& t, TransmissionContainer& collided)
+{
+	if(!this->isFree(t->channel))
 	{
 		for(
 			Transmissions::iterator itr = this->transmissions.begin();
 			itr != this->transmissions.end();
 			++itr)
 		{
-			itr->second->collision = true;
+			if (itr->second->channel == t->channel && !itr->second->collision)
+			{
+				itr->second->collision = true;
+				collided.push_back(itr->second);
+			}
 		}
 		t->collision = true;
-		MESSAGE_SINGLE(NORMAL, logger, "Collision occured!!");
+		collided.push_back(t);
+		++this->counters.collisions;
+		COPPER_FRAME_RECORD(
+			NORMAL, logger,
+			WireCollision, this->id, -1, t->channel, 0.0,
+			"Collision occured on channel " << t->channel << "!!");
+
+		for (size_t ii = 0; ii < this->carrierSenseReceivers.size(); ++ii)
+		{
+			this->carrierSenseReceivers[ii]->onCollision(t->channel);
+		}
+	}
+
+}
+
+
+bool
+Wire::isSlotted() const
+{
+	return this->slotDuration > 0.0;
+}
+
+simTimeType
+Wire::getArrivalTime(simTimeType duration) const
+{
+	simTimeType now = wns::simulator::getEventScheduler()->getTime();
+
+	if (!this->isSlotted())
+	{
+		return now + duration;
+	}
+
+	// tolerance avoids that a transmission started exactly at the slot
+	// boundary is assigned to the previous slot due to rounding
+	const double tolerance = 1E-9;
+	simTimeType slotEnd =
+		(std::floor(now / this->slotDuration + tolerance) + 1.0) * this->slotDuration;
+
+	if (now + duration > slotEnd + tolerance * this->slotDuration)
+	{
+		wns::Exception e;
+		e << "Wire " << this->name << ": transmission of duration " << duration
+		  << " does not fit into the slot (slot ends at " << slotEnd << ")";
+		throw e;
+	}
+	return slotEnd;
+}
+
+void
+Wire::signalCollisionToSenders(const TransmissionContainer& collided)
+{
+	for (
+		TransmissionContainer::const_iterator itr = collided.begin();
+		itr != collided.end();
+		++itr)
+	{
+		if (this->isTracing())
+		{
+			this->trace->record(TraceRecord::Collision, this->id, *itr, -1);
+		}
+		if (this->chromeTrace != NULL)
+		{
+			this->chromeTrace->collision(*itr);
+		}
+		(*itr)->sender->onCollision(*itr);
+	}
+}
+
+void
+Wire::resolveSlotCollisions()
+{
+	TransmissionContainer collided;
+
+	for (ChannelId channel = 0; channel < this->channels.size(); ++channel)
+	{
+		if (this->channels[channel].activeTransmissions < 2)
+		{
+			continue;
+		}
 
 		for(
-			std::list<ReceiverInterface*>::iterator itr = this->receivers.begin();
-			itr != this->receivers.end();
+			Transmissions::iterator itr = this->transmissions.begin();
+			itr != this->transmissions.end();
 			++itr)
 		{
-			(*itr)->onCollision();
+			if (itr->second->channel == channel)
+			{
+				itr->second->collision = true;
+				collided.push_back(itr->second);
+			}
+		}
+		++this->counters.collisions;
+		COPPER_FRAME_RECORD(
+			NORMAL, logger,
+			WireCollision, this->id, -1, channel, 0.0,
+			"Collision occured in slot on channel " << channel << "!!");
+
+		for (size_t ii = 0; ii < this->carrierSenseReceivers.size(); ++ii)
+		{
+			this->carrierSenseReceivers[ii]->onCollision(channel);
 		}
 	}
 
+	this->signalCollisionToSenders(collided);
 }
 
+void
+Wire::onSlotEnd()
+{
+	COPPER_FRAME_MESSAGE(
+		NORMAL, this->logger,
+		"End of slot, completing " << this->activeSlotTransmissions << " transmission(s)");
+
+	this->resolveSlotCollisions();
+
+	// transmissions started while completing this slot belong to the
+	// next slot, the entries stay valid in finished (list::swap)
+	SlotTransmissions finished;
+	finished.swap(this->slotTransmissions);
+	this->activeSlotTransmissions = 0;
+	++this->currentSlot;
+
+	for (
+		SlotTransmissions::iterator itr = finished.begin();
+		itr != finished.end();
+		++itr)
+	{
+		// may have been cancelled by an earlier completion
+		if (!itr->cancelled)
+		{
+			this->slotPositions.erase(itr->pdu);
+			itr->complete();
+		}
+	}
+}
 
 void
-Wire::signalCopperFreeAgainToReceivers()
+Wire::signalCopperFreeAgainToReceivers(ChannelId channel)
 {
-	MESSAGE_SINGLE(NORMAL, this->logger, "Wire is free again");
+	COPPER_DETAIL_RECORD(
+		NORMAL, this->logger,
+		WireChannelFree, this->id, -1, channel, 0.0,
+		"Channel " << channel << " is free again");
+
+	// senders waiting to transmit come first
+	IdleWaiters& waiters = this->idleWaiters[channel];
+	while (!waiters.empty() && this->isFree(channel))
+	{
+		TransmitterDataSentInterface* sender = waiters.front();
+		waiters.pop_front();
+		sender->onWireIdle(channel);
+	}
 
 	this->roundRobin.startRound();
-	MESSAGE_SINGLE(NORMAL, this->logger, "Starting round robin wakeup");
+	COPPER_DETAIL_MESSAGE(NORMAL, this->logger, "Starting round robin wakeup");
 
-	while(this->roundRobin.hasNext() && this->isFree())
+	while(this->roundRobin.hasNext() && this->isFree(channel))
 	{
-		this->roundRobin.next()->onCopperFree();
+		this->roundRobin.next()->onCopperFree(channel);
 	}
 
 	this->roundRobin.endRound();
-	MESSAGE_SINGLE(NORMAL, this->logger, "Round robin stopped");
+	COPPER_DETAIL_MESSAGE(NORMAL, this->logger, "Round robin stopped");
+}
+
+Bit
+Wire::getLengthInBits(const TransmissionPtr& t)
+{
+	Bit len = t->pdu->getLengthInBits();
+	for (
+		PDUContainer::const_iterator itr = t->burst.begin();
+		itr != t->burst.end();
+		++itr)
+	{
+		len += (*itr)->getLengthInBits();
+	}
+	return len;
+}
+
+WireCounters
+Wire::getCounters() const
+{
+	simTimeType now = wns::simulator::getEventScheduler()->getTime();
+
+	WireCounters c = this->counters;
+	if (!this->isFree())
+	{
+		c.busyTime += now - this->busySince;
+	}
+	c.idleTime = now - this->createdAt - c.busyTime;
+	return c;
+}
+
+void
+Wire::writeCounters() const
+{
+	WireCounters c = this->getCounters();
+	simTimeType lifetime = c.busyTime + c.idleTime;
+	double utilization = lifetime > 0.0 ? c.busyTime / lifetime : 0.0;
+
+	MESSAGE_BEGIN(NORMAL, this->logger, m, "Counters of wire ");
+	m << this->name
+	  << ": frames started " << c.framesStarted
+	  << ", completed " << c.framesCompleted
+	  << ", cancelled " << c.framesCancelled
+	  << ", collisions " << c.collisions
+	  << ", unicast Bits " << c.unicastBits
+	  << ", broadcast Bits " << c.broadcastBits
+	  << ", multicast Bits " << c.multicastBits
+	  << ", peak concurrent transmissions " << c.peakConcurrentTransmissions
+	  << ", busy " << c.busyTime << "s"
+	  << ", idle " << c.idleTime << "s"
+	  << ", utilization " << utilization;
+	MESSAGE_END();
+
+	if (this->utilizationProbe)
+	{
+		this->utilizationProbe->put(utilization);
+		this->collisionsProbe->put(c.collisions);
+		this->framesCompletedProbe->put(c.framesCompleted);
+		this->framesCancelledProbe->put(c.framesCancelled);
+		this->peakConcurrentTransmissionsProbe->put(c.peakConcurrentTransmissions);
+	}
+}
+
+unsigned int
+Wire::getId() const
+{
+	return this->id;
+}
+
+WireTrace*
+Wire::getTrace() const
+{
+	return this->trace;
+}
+
+ChromeTrace*
+Wire::getChromeTrace() const
+{
+	return this->chromeTrace;
+}
+
+PcapCapture*
+Wire::getPcapCapture() const
+{
+	return this->pcap;
 }
 
+void
+Wire::traceStart(const UnicastTransmissionPtr& ut)
+{
+	this->trace->record(TraceRecord::UnicastStart, this->id, ut, ut->target.getInteger());
+}
 
+void
+Wire::traceStart(const BroadcastTransmissionPtr& bt)
+{
+	this->trace->record(TraceRecord::BroadcastStart, this->id, bt, -1);
+}
+
+void
+Wire::traceStart(const MulticastTransmissionPtr& mt)
+{
+	this->trace->record(TraceRecord::MulticastStart, this->id, mt, mt->group);
+}
+
+const std::list<Wire*>&
+Wire::getWires()
+{
+	return Wire::getWireList();
+}
+
+std::list<Wire*>&
+Wire::getWireList()
+{
+	static std::list<Wire*> wires;
+	return wires;
+}
@@ -30,6 +30,13 @@
 
 #include <COPPER/Transmission.hpp>
 #include <COPPER/ReceiverInterface.hpp>
+#include <COPPER/TDMAExecutor.hpp>
+#include <COPPER/WireTrace.hpp>
+#include <COPPER/ChromeTrace.hpp>
+#include <COPPER/PcapCapture.hpp>
+#include <COPPER/WireTap.hpp>
+#include <COPPER/Profiling.hpp>
+#include <COPPER/BusyHistory.hpp>
 
 #include <WNS/events/CanTimeout.hpp>
 #include <WNS/pyconfig/View.hpp>
@@ -40,10 +47,13 @@
 #include <WNS/osi/PDU.hpp>
 #include <WNS/service/dll/Address.hpp>
 #include <WNS/events/scheduler/Interface.hpp>
+#include <WNS/probe/bus/ContextCollector.hpp>
 #include <WNS/osi/PDU.hpp>
 
 #include <list>
 #include <map>
+#include <stdint.h>
+#include <vector>
 
 namespace copper
 {
@@ -55,6 +65,10 @@ namespace copper
 	 * connected to a wire is unlimted. If one transmission is active the
 	 * wire is blocked. If another transmitter will transmit although the
 	 * wire is not free a collision will occur.
+	 *
+	 * A wire may be divided into several channels (e.g. frequency bands
+	 * of a DSL line). Each channel is blocked and collides independently
+	 * of the others, while all channels share the connected receivers.
 	 */
 	class WireInterface
 	{
@@ -84,6 +98,16 @@ namespace copper
 		virtual void
 		sendData(const BroadcastTransmissionPtr& bt, simTimeType duration) = 0;
 
+		/**
+		 * @brief Send data (Multicast Transmission) to the members of
+		 * the group
+		 *
+		 * @param mt Data (multicast) to be sent
+		 * @param duration The duration of the data transmission
+		 */
+		virtual void
+		sendData(const MulticastTransmissionPtr& mt, simTimeType duration) = 0;
+
 		/**
 		 * @brief Stops a transmission before the duration specified in
 		 * send data is reached.
@@ -109,21 +133,189 @@ namespace copper
 		 * - values > 0.0: A transmission is ongoing since "value"
 		 * seconds
 		 *
+		 * @param channel The channel of the wire to be checked
+		 */
+		virtual simTimeType
+		blockedSince(ChannelId channel) const = 0;
+
+		/**
+		 * @brief blockedSince of channel 0 (single channel wires)
+		 */
+		simTimeType
+		blockedSince() const
+		{
+			return this->blockedSince(0);
+		}
+
+		/**
+		 * @brief Returns what blockedSince would have returned at
+		 * time t (t <= now)
+		 *
+		 * Answered from a bounded history of busy periods, allows the
+		 * carrier state to be queried at decision points instead of
+		 * following onCopperBusy and onCopperFree.
 		 */
 		virtual simTimeType
-		blockedSince() const = 0;
+		blockedSinceAt(ChannelId channel, simTimeType t) const = 0;
+
+		/**
+		 * @brief Carrier state perceived at time t (t <= now) by a
+		 * station with the given sensing time (see
+		 * BusyHistory::isBusyAt)
+		 */
+		virtual bool
+		isCarrierBusyAt(ChannelId channel, simTimeType t, simTimeType sensingTime) const = 0;
+
+		/**
+		 * @brief Returns the number of channels of this wire
+		 */
+		virtual ChannelId
+		getNumberOfChannels() const = 0;
 
 		/**
-		 * @brief Receiver need to register themselves via this method
+		 * @brief Returns the TDMA executor of this wire or NULL if the
+		 * wire is not operated with a TDMA schedule
+		 */
+		virtual TDMAExecutor*
+		getTDMAExecutor() const = 0;
+
+		/**
+		 * @brief Call onWireIdle of the sender as soon as the (busy)
+		 * channel gets free again
+		 *
+		 * This is a one-shot registration. Waiting senders are woken
+		 * in the order of registration before the receivers are
+		 * informed. A sender may also register while the wire completes
+		 * the transmission that frees the channel (e.g. from
+		 * onDataSent), it is woken when the completion signals the free
+		 * channel.
+		 */
+		virtual void
+		wakeupOnIdle(TransmitterDataSentInterface* sender, ChannelId channel) = 0;
+
+		/**
+		 * @brief Remove the sender from the waiting senders of all
+		 * channels (e.g. before it is deleted)
+		 */
+		virtual void
+		cancelWakeupOnIdle(TransmitterDataSentInterface* sender) = 0;
+
+		/**
+		 * @brief Receiver need to register themselves via this method,
+		 * carrierSenseInterest is the initial setting of
+		 * setCarrierSenseInterest
 		 */
 		virtual void
 		addReceiver(
 			ReceiverInterface* r,
-			const wns::service::dll::UnicastAddress& macAddress) = 0;
+			const wns::service::dll::UnicastAddress& macAddress,
+			bool carrierSenseInterest) = 0;
+
+		/**
+		 * @brief Receivers are subscribed to broadcasts when they are
+		 * added, unsubscribed receivers only get unicasts addressed
+		 * to them
+		 */
+		virtual void
+		setBroadcastSubscription(ReceiverInterface* r, bool subscribed) = 0;
+
+		/**
+		 * @brief Adds the receiver to or removes it from the multicast
+		 * group
+		 */
+		virtual void
+		setGroupMembership(GroupId group, ReceiverInterface* r, bool member) = 0;
+
+		/**
+		 * @brief Uninterested receivers get no onCopperBusy,
+		 * onCopperFree and onCollision calls. Receivers should pass
+		 * their interest to addReceiver, a change is more expensive.
+		 */
+		virtual void
+		setCarrierSenseInterest(ReceiverInterface* r, bool interested) = 0;
+	};
+
+	/**
+	 * @brief Performance counters of a wire
+	 *
+	 * The counters are updated with plain increments while transmissions
+	 * start and end. Time values are only updated when the wire changes
+	 * between idle (all channels free) and busy.
+	 */
+	struct WireCounters
+	{
+		WireCounters() :
+			framesStarted(0),
+			framesCompleted(0),
+			framesCancelled(0),
+			collisions(0),
+			unicastBits(0),
+			broadcastBits(0),
+			multicastBits(0),
+			peakConcurrentTransmissions(0),
+			busyTime(0.0),
+			idleTime(0.0)
+		{}
+
+		unsigned long framesStarted;
+
+		unsigned long framesCompleted;
+
+		/**
+		 * @brief Transmissions stopped via stopTransmission(pdu)
+		 */
+		unsigned long framesCancelled;
+
+		/**
+		 * @brief Number of collision events (a transmission started on
+		 * a busy channel or, in slotted mode, a slot with more than
+		 * one transmission on a channel)
+		 */
+		unsigned long collisions;
+
+		/**
+		 * @brief Bits of all started unicast transmissions (including
+		 * bursts)
+		 */
+		unsigned long unicastBits;
+
+		/**
+		 * @brief Bits of all started broadcast transmissions (including
+		 * bursts)
+		 */
+		unsigned long broadcastBits;
+
+		/**
+		 * @brief Bits of all started multicast transmissions
+		 * (including bursts)
+		 */
+		unsigned long multicastBits;
+
+		/**
+		 * @brief Maximum number of simultaneous transmissions (all
+		 * channels)
+		 */
+		unsigned long peakConcurrentTransmissions;
+
+		/**
+		 * @brief Time at least one channel was busy
+		 */
+		simTimeType busyTime;
+
+		/**
+		 * @brief Time all channels were free
+		 */
+		simTimeType idleTime;
 	};
 
 	/**
 	 * @brief An implementation of WireInterface
+	 *
+	 * If a slot duration is configured the wire operates in slotted
+	 * mode: All transmissions starting within a slot end at the end of
+	 * this slot. A single event at the end of the slot resolves the
+	 * collisions (more than one transmission on a channel) and completes
+	 * all transmissions of the slot at once.
 	 */
 	class Wire :
 		public virtual WireInterface
@@ -135,6 +327,12 @@ namespace copper
 		explicit
 		Wire(const wns::pyconfig::View& config);
 
+		/**
+		 * @brief Destructor
+		 */
+		virtual
+		~Wire();
+
 		/**
 		 * @name WireInterface
 		 */
@@ -145,22 +343,191 @@ namespace copper
 		void
 		sendData(const BroadcastTransmissionPtr& bt, simTimeType duration);
 
+		void
+		sendData(const MulticastTransmissionPtr& mt, simTimeType duration);
+
 		/**
 		 * @brief Cancel a transmission before it is finished
 		 */
 		void
 		stopTransmission(const wns::osi::PDUPtr& pdu);
 
+		using WireInterface::blockedSince;
+
+		simTimeType
+		blockedSince(ChannelId channel) const;
+
 		simTimeType
-		blockedSince() const;
+		blockedSinceAt(ChannelId channel, simTimeType t) const;
+
+		bool
+		isCarrierBusyAt(ChannelId channel, simTimeType t, simTimeType sensingTime) const;
+
+		ChannelId
+		getNumberOfChannels() const;
+
+		TDMAExecutor*
+		getTDMAExecutor() const;
+
+		void
+		wakeupOnIdle(TransmitterDataSentInterface* sender, ChannelId channel);
+
+		void
+		cancelWakeupOnIdle(TransmitterDataSentInterface* sender);
 
 		void
 		addReceiver(
 			ReceiverInterface* r,
-			const wns::service::dll::UnicastAddress& macAddress);
+			const wns::service::dll::UnicastAddress& macAddress,
+			bool carrierSenseInterest);
+
+		void
+		setBroadcastSubscription(ReceiverInterface* r, bool subscribed);
+
+		void
+		setGroupMembership(GroupId group, ReceiverInterface* r, bool member);
+
+		void
+		setCarrierSenseInterest(ReceiverInterface* r, bool interested);
 		//@}
 
+		/**
+		 * @brief Number of receivers interested in the carrier state
+		 */
+		size_t
+		getNumberOfCarrierSenseReceivers() const;
+
+		/**
+		 * @brief Number of receivers in the multicast group
+		 */
+		size_t
+		getNumberOfGroupMembers(GroupId group) const;
+
+		/**
+		 * @brief Number of receivers subscribed to broadcasts
+		 */
+		size_t
+		getNumberOfBroadcastSubscribers() const;
+
+		/**
+		 * @brief Number of senders waiting for the channel to get free
+		 */
+		size_t
+		getNumberOfIdleWaiters(ChannelId channel) const;
+
+		/**
+		 * @brief Registers a promiscuous observer of all completed
+		 * transmissions (see WireTap)
+		 *
+		 * Wires without taps only pay a single empty test per
+		 * completed transmission.
+		 */
+		void
+		addTap(WireTap* tap);
+
+		/**
+		 * @brief Unregisters a tap added with addTap
+		 */
+		void
+		removeTap(WireTap* tap);
+
+		/**
+		 * @brief Maximum number of channels per wire (limited by the
+		 * width of ChannelMask)
+		 */
+		static const ChannelId maxChannels = 32;
+
+		/**
+		 * @brief Returns the counters, busy and idle time are
+		 * accounted up to now
+		 */
+		WireCounters
+		getCounters() const;
+
+		/**
+		 * @brief Writes the counters to the logger and, if configured,
+		 * to the probes
+		 */
+		void
+		writeCounters() const;
+
+		/**
+		 * @brief Number of the wire, wires are numbered in the order of
+		 * creation
+		 */
+		unsigned int
+		getId() const;
+
+		/**
+		 * @brief Returns the trace recorder (NULL if not configured),
+		 * e.g. to switch tracing on and off
+		 */
+		WireTrace*
+		getTrace() const;
+
+		/**
+		 * @brief Returns the Chrome trace exporter (NULL if not
+		 * configured)
+		 */
+		ChromeTrace*
+		getChromeTrace() const;
+
+		/**
+		 * @brief Returns the pcap capture (NULL if not configured)
+		 */
+		PcapCapture*
+		getPcapCapture() const;
+
+		/**
+		 * @brief All existing wires (used by Copper::shutDown to write
+		 * the counters)
+		 */
+		static const std::list<Wire*>&
+		getWires();
+
 	private:
+		/**
+		 * @brief Not copyable (owns the TDMA executor and the traces)
+		 */
+		Wire(const Wire&);
+
+		Wire&
+		operator=(const Wire&);
+
+		/**
+		 * @brief Storage of getWires
+		 */
+		static std::list<Wire*>&
+		getWireList();
+
+		/**
+		 * @brief One bit per channel, set if the channel is busy
+		 */
+		typedef unsigned int ChannelMask;
+
+		/**
+		 * @brief State of a single channel of the wire
+		 */
+		struct Channel
+		{
+			Channel() :
+				timeBlocked(0.0),
+				activeTransmissions(0)
+			{}
+
+			/**
+			 * @brief The time when the channel was blocked by a
+			 * transmission
+			 */
+			simTimeType timeBlocked;
+
+			/**
+			 * @brief Number of transmissions currently ongoing on
+			 * this channel
+			 */
+			unsigned int activeTransmissions;
+		};
+
 		/**
 		 * @brief Event to be scheduled at start of a transmission to
 		 * signal the end of a transmission
@@ -251,9 +618,83 @@ namespace copper
 		typedef std::map< wns::osi::PDUPtr, TransmissionPtr >
 		Transmissions;
 
-		typedef std::map<wns::service::dll::UnicastAddress, ReceiverInterface*>
+		typedef std::map<wns::service::dll::UnicastAddress, size_t>
 		Address2ReceiverContainer;
 
+		typedef std::list<TransmitterDataSentInterface*>
+		IdleWaiters;
+
+		typedef std::vector<TransmissionPtr>
+		TransmissionContainer;
+
+		/**
+		 * @brief Transmission of a slot (slotted mode)
+		 */
+		struct SlotTransmission
+		{
+			SlotTransmission(
+				const wns::osi::PDUPtr& _pdu,
+				const wns::events::scheduler::Callable& _complete,
+				unsigned long _slot) :
+				pdu(_pdu),
+				complete(_complete),
+				slot(_slot),
+				cancelled(false)
+			{}
+
+			wns::osi::PDUPtr pdu;
+
+			/**
+			 * @brief Completes the transmission (see
+			 * TransmissionEndEvent)
+			 */
+			wns::events::scheduler::Callable complete;
+
+			/**
+			 * @brief Number of the slot the transmission belongs to
+			 */
+			unsigned long slot;
+
+			/**
+			 * @brief Set by stopTransmission, the entry is skipped
+			 * at the end of the slot
+			 */
+			bool cancelled;
+		};
+
+		/**
+		 * @brief Transmissions of a slot in the order they have been
+		 * started
+		 */
+		typedef std::list<SlotTransmission>
+		SlotTransmissions;
+
+		typedef std::map<wns::osi::PDUPtr, SlotTransmissions::iterator>
+		SlotPositions;
+
+		/**
+		 * @brief Signals the end of a slot (slotted mode only)
+		 */
+		class SlotEndEvent
+		{
+		public:
+			explicit
+			SlotEndEvent(Wire* w) :
+				wire(w)
+			{
+				assure(this->wire, "must be non-NULL");
+			}
+
+			void
+			operator()()
+			{
+				this->wire->onSlotEnd();
+			}
+
+		private:
+			Wire* wire;
+		};
+
 		/**
 		 * @brief Stops a unicast transmission (called on finished transmission)
 		 *
@@ -271,19 +712,40 @@ namespace copper
 		stopTransmission(const BroadcastTransmissionPtr& bt);
 
 		/**
-		 * @brief Used to check if the wire is free
+		 * @brief Stops a multicast transmission (called on finished
+		 * transmission), delivers to the members of the group
+		 */
+		void
+		stopTransmission(const MulticastTransmissionPtr& mt);
+
+		/**
+		 * @brief Used to check if all channels of the wire are free
 		 */
 		bool
 		isFree() const;
 
+		/**
+		 * @brief Used to check if a channel of the wire is free
+		 */
+		bool
+		isFree(ChannelId channel) const;
+
 		/**
 		 * @brief Checks if a transmission collided with another
-		 * transmission
+		 * transmission on the same channel
 		 *
-		 * The result will be stored IN the TransmissionPtr t
+		 * The result will be stored IN the TransmissionPtr t. All
+		 * transmissions which collided for the first time are appended
+		 * to "collided".
 		 */
 		void
-		checkForCollision(const TransmissionPtr& t);
+		checkForCollision(const TransmissionPtr& t, TransmissionContainer& collided);
+
+		/**
+		 * @brief Calls onCollision of the senders of the transmissions
+		 */
+		void
+		signalCollisionToSenders(const TransmissionContainer& collided);
 
 		/**
 		 * @brief Calls onCopperFreeAgain of each connected receiver
@@ -294,7 +756,52 @@ namespace copper
 		 * round to be called.
 		 */
 		void
-		signalCopperFreeAgainToReceivers();
+		signalCopperFreeAgainToReceivers(ChannelId channel);
+
+		/**
+		 * @brief Marks the channel of the transmission as occupied
+		 * (one more active transmission)
+		 */
+		void
+		occupyChannel(const TransmissionPtr& t);
+
+		/**
+		 * @brief Counterpart of occupyChannel. Returns true if the
+		 * channel got free.
+		 */
+		bool
+		releaseChannel(const TransmissionPtr& t);
+
+		/**
+		 * @brief True if the wire operates in slotted mode
+		 */
+		bool
+		isSlotted() const;
+
+		/**
+		 * @brief Returns the time a transmission started now with the
+		 * given duration ends
+		 *
+		 * In slotted mode this is the end of the current slot. Throws
+		 * if the transmission does not fit into the slot.
+		 */
+		simTimeType
+		getArrivalTime(simTimeType duration) const;
+
+		/**
+		 * @brief Marks all transmissions on channels with more than one
+		 * transmission in the current slot as collided and informs the
+		 * receivers once per channel
+		 */
+		void
+		resolveSlotCollisions();
+
+		/**
+		 * @brief Called by SlotEndEvent, completes all transmissions of
+		 * the slot
+		 */
+		void
+		onSlotEnd();
 
 		/**
 		 * @brief Stores and sends the event together with the PDU of
@@ -313,8 +820,26 @@ namespace copper
 
 			
 			this->transmissions[t->pdu] = te.getTransmission();
-			this->transmissionEndEvents[t->pdu] =
-				wns::simulator::getEventScheduler()->schedule(te, arrivalTime);
+
+			if (this->isSlotted())
+			{
+				// one event for all transmissions of the slot
+				if (this->activeSlotTransmissions == 0)
+				{
+					this->slotEndEvent =
+						wns::simulator::getEventScheduler()->schedule(
+							SlotEndEvent(this), arrivalTime);
+				}
+				this->slotTransmissions.push_back(
+					SlotTransmission(t->pdu, wns::events::scheduler::Callable(te), this->currentSlot));
+				this->slotPositions[t->pdu] = --this->slotTransmissions.end();
+				++this->activeSlotTransmissions;
+			}
+			else
+			{
+				this->transmissionEndEvents[t->pdu] =
+					wns::simulator::getEventScheduler()->schedule(te, arrivalTime);
+			}
 			
 		}
 
@@ -322,26 +847,108 @@ namespace copper
 		wns::simulator::Time
 		sendDataGeneric(const TRANSMISSIONTYPE& transmission, simTimeType duration)
 		{
+			COPPER_PROFILE_SCOPE("Wire::sendData");
 			assure(transmission, "must be non-NULL");
-			// if wire is not already blocked set time to now and
-			// tell every Receiver the wire is busy
-			if (this->isFree())
+			assure(
+				transmission->channel < this->channels.size(),
+				"Channel not available at this wire");
+
+			// throws if the transmission does not fit into the slot,
+			// so check before any state is changed
+			wns::simulator::Time arrivalTime = this->getArrivalTime(duration);
+
+			const ChannelId channel = transmission->channel;
+			// if channel is not already blocked set time to now and
+			// tell every Receiver the channel is busy
+			if (this->isFree(channel))
 			{
-				this->timeWireBlocked = wns::simulator::getEventScheduler()->getTime();
+				this->channels[channel].timeBlocked =
+					wns::simulator::getEventScheduler()->getTime();
+				this->busyHistory[channel].busy(this->channels[channel].timeBlocked);
 				std::for_each(
-					receivers.begin(),
-					receivers.end(),
-					std::mem_fun(&ReceiverInterface::onCopperBusy));
+					carrierSenseReceivers.begin(),
+					carrierSenseReceivers.end(),
+					std::bind2nd(std::mem_fun(&ReceiverInterface::onCopperBusy), channel));
 			}
 
-			wns::simulator::Time arrivalTime =
-				wns::simulator::getEventScheduler()->getTime() + duration;
-			this->checkForCollision(transmission);
+			// in slotted mode collisions are resolved at the end of
+			// the slot
+			TransmissionContainer collided;
+			if (!this->isSlotted())
+			{
+				this->checkForCollision(transmission, collided);
+			}
+			this->occupyChannel(transmission);
 
 			this->addTransmissionEndEvent(transmission, arrivalTime);
+
+			if (this->isTracing())
+			{
+				this->traceStart(transmission);
+			}
+			if (this->chromeTrace != NULL)
+			{
+				this->chromeTrace->start(transmission);
+			}
+
+			++this->counters.framesStarted;
+			if (this->transmissions.size() > this->counters.peakConcurrentTransmissions)
+			{
+				this->counters.peakConcurrentTransmissions = this->transmissions.size();
+			}
+
+			// the senders are informed when the new transmission is
+			// fully registered, they may react immediately
+			this->signalCollisionToSenders(collided);
 			return arrivalTime;
 		}
 
+		bool
+		isTracing() const
+		{
+			return this->trace != NULL && this->trace->isEnabled();
+		}
+
+		/**
+		 * @brief Records the start of the transmission in the trace
+		 */
+		void
+		traceStart(const UnicastTransmissionPtr& ut);
+
+		void
+		traceStart(const BroadcastTransmissionPtr& bt);
+
+		void
+		traceStart(const MulticastTransmissionPtr& mt);
+
+		/**
+		 * @brief Number of Bits of the transmission (including the
+		 * burst)
+		 */
+		static Bit
+		getLengthInBits(const TransmissionPtr& t);
+
+		/**
+		 * @brief Informs all taps, kept out of line so the completion
+		 * path only contains the empty test
+		 */
+		void
+		notifyTaps(const UnicastTransmissionPtr& ut);
+
+		void
+		notifyTaps(const BroadcastTransmissionPtr& bt);
+
+		void
+		notifyTaps(const MulticastTransmissionPtr& mt);
+
+		/**
+		 * @brief Hands the transmission to the receiver with the given
+		 * index, returns true if it was received
+		 */
+		template <typename TRANSMISSIONTYPE>
+		bool
+		deliver(size_t index, const TRANSMISSIONTYPE& transmission);
+
 		/**
 		 * @brief Remove event according to its PDU
 		 */
@@ -353,9 +960,15 @@ namespace copper
 		 */
 		std::string name;
 
+		/**
+		 * @brief See getId
+		 */
+		unsigned int id;
+
 		/**
 		 * @brief Round robin container to realize round robin
-		 * signalling in signalCopperFreeAgainToReceivers
+		 * signalling in signalCopperFreeAgainToReceivers (receivers
+		 * interested in the carrier state only)
 		 */
 		wns::RoundRobin<ReceiverInterface*> roundRobin;
 
@@ -365,6 +978,45 @@ namespace copper
 		 */
 		std::list<ReceiverInterface*> receivers;
 
+		/**
+		 * @brief Indices of the receivers subscribed to broadcasts
+		 * (sorted, i.e. in the order they were added), the broadcast
+		 * fan-out only iterates these
+		 */
+		std::vector<size_t> broadcastSubscribers;
+
+		/**
+		 * @brief Receivers informed about busy channels and collisions
+		 * (see setCarrierSenseInterest), roundRobin holds the same
+		 * receivers for the wakeup of free channels
+		 */
+		std::vector<ReceiverInterface*> carrierSenseReceivers;
+
+		/**
+		 * @brief Interest in the carrier state, indexed by the dense
+		 * receiver index
+		 */
+		std::vector<bool> carrierSenseInterests;
+
+		/**
+		 * @brief Receivers indexed by their dense index (order of
+		 * addReceiver), used by the group bitsets
+		 */
+		std::vector<ReceiverInterface*> indexedReceivers;
+
+		std::map<ReceiverInterface*, size_t> receiverIndices;
+
+		/**
+		 * @brief Bitset over the receiver indices (bit ii of word
+		 * ii / 32)
+		 */
+		typedef std::vector<uint32_t> GroupMembers;
+
+		/**
+		 * @brief Members of each multicast group, indexed by GroupId
+		 */
+		std::vector<GroupMembers> groups;
+
 		/**
 		 * @brief Associative container: key=PDU,
 		 * value=TransmissionEndEvent
@@ -378,19 +1030,125 @@ namespace copper
 
 		/**
 		 * @brief Associative container: Allows mapping of Layer 2
-		 * addresses to a copper::Receiver
+		 * addresses to the index of a copper::Receiver
 		 */
 		Address2ReceiverContainer addressMapping;
 
+		/**
+		 * @brief Promiscuous observers, see addTap
+		 */
+		std::vector<WireTap*> taps;
+
 		/**
 		 * @brief Logger instance
 		 */
 		wns::logger::Logger logger;
 
 		/**
-		 * @brief the time when the wire was blocked by a transmission
+		 * @brief Per channel state, indexed by ChannelId
+		 */
+		std::vector<Channel> channels;
+
+		/**
+		 * @brief Senders waiting for a channel to get free, indexed by
+		 * ChannelId
+		 */
+		std::vector<IdleWaiters> idleWaiters;
+
+		/**
+		 * @brief Recent busy periods, indexed by ChannelId (see
+		 * blockedSinceAt)
+		 */
+		std::vector<BusyHistory> busyHistory;
+
+		/**
+		 * @brief Bit i is set if channel i is busy. Allows checking
+		 * all channels at once.
+		 */
+		ChannelMask busyChannels;
+
+		/**
+		 * @brief Duration of a slot, 0.0 if the wire is not slotted
+		 */
+		simTimeType slotDuration;
+
+		/**
+		 * @brief Transmissions started in the current slot
+		 */
+		SlotTransmissions slotTransmissions;
+
+		/**
+		 * @brief Entries of the transmissions of the current slot and
+		 * of the slot being completed that are neither completed nor
+		 * cancelled, keyed by PDU
+		 */
+		SlotPositions slotPositions;
+
+		/**
+		 * @brief Entries of slotTransmissions that are not cancelled
+		 */
+		unsigned int activeSlotTransmissions;
+
+		/**
+		 * @brief Number of the current slot, incremented at the end of
+		 * each slot
+		 */
+		unsigned long currentSlot;
+
+		/**
+		 * @brief The event ending the current slot (only valid if
+		 * activeSlotTransmissions is not 0)
+		 */
+		wns::events::scheduler::IEventPtr slotEndEvent;
+
+		/**
+		 * @brief Grants transmit opportunities if a TDMA schedule is
+		 * configured (owned, may be NULL)
+		 */
+		TDMAExecutor* tdmaExecutor;
+
+		WireCounters counters;
+
+		/**
+		 * @brief Creation time of the wire (start of the idle time)
+		 */
+		simTimeType createdAt;
+
+		/**
+		 * @brief Start of the current busy period (only valid if a
+		 * channel is busy)
+		 */
+		simTimeType busySince;
+
+		/**
+		 * @brief Probes written by writeCounters (NULL if not
+		 * configured)
+		 */
+		wns::probe::bus::ContextCollectorPtr utilizationProbe;
+
+		wns::probe::bus::ContextCollectorPtr collisionsProbe;
+
+		wns::probe::bus::ContextCollectorPtr framesCompletedProbe;
+
+		wns::probe::bus::ContextCollectorPtr framesCancelledProbe;
+
+		wns::probe::bus::ContextCollectorPtr peakConcurrentTransmissionsProbe;
+
+		/**
+		 * @brief Binary trace of the wire activity (owned, may be NULL)
+		 */
+		WireTrace* trace;
+
+		/**
+		 * @brief Chrome trace exporter (owned, may be NULL)
+		 */
+		ChromeTrace* chromeTrace;
+
+		/**
+		 * @brief Capture of the completed transmissions (owned, may be
+		 * NULL)
 		 */
-		simTimeType timeWireBlocked;
+		PcapCapture* pcap;
 	};
 
 	/**
@@ -0,0 +1,352 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#include <COPPER/WireReplay.hpp>
+
+#include <WNS/ldk/helper/FakePDU.hpp>
+#include <WNS/events/scheduler/Interface.hpp>
+#include <WNS/Exception.hpp>
+
+#include <sys/time.h>
+#include <map>
+#include <set>
+
+using namespace copper;
+
+double
+ReplayResult::getEventsPerSecond() const
+{
+	return this->wallTime > 0.0 ? this->events / this->wallTime : 0.0;
+}
+
+double
+ReplayResult::getNanosecondsPerFrame() const
+{
+	return this->frames > 0 ? this->wallTime * 1E9 / this->frames : 0.0;
+}
+
+WireReplay::Sender::Sender(ReplayResult* r) :
+	result(r)
+{
+}
+
+void
+WireReplay::Sender::onDataSent(const TransmissionPtr& /*transmission*/)
+{
+	++this->result->completed;
+}
+
+void
+WireReplay::Sender::onCollision(const TransmissionPtr& /*transmission*/)
+{
+	++this->result->collisions;
+}
+
+void
+WireReplay::Sender::onWireIdle(ChannelId /*channel*/)
+{
+}
+
+WireReplay::Receiver::Receiver(const wns::service::dll::UnicastAddress& _address) :
+	address(_address)
+{
+}
+
+bool
+WireReplay::Receiver::onData(const UnicastTransmissionPtr& transmission)
+{
+	return transmission->target == this->address;
+}
+
+bool
+WireReplay::Receiver::onData(const BroadcastTransmissionPtr& /*transmission*/)
+{
+	return true;
+}
+
+bool
+WireReplay::Receiver::onData(const MulticastTransmissionPtr& /*transmission*/)
+{
+	return true;
+}
+
+void
+WireReplay::Receiver::onCopperFree(ChannelId /*channel*/)
+{
+}
+
+void
+WireReplay::Receiver::onCopperBusy(ChannelId /*channel*/)
+{
+}
+
+void
+WireReplay::Receiver::onCollision(ChannelId /*channel*/)
+{
+}
+
+WireReplay::WireReplay(
+	const wns::pyconfig::View& _wireConfig,
+	const std::string& traceFileName) :
+	wireConfig(_wireConfig),
+	frames(),
+	actions(),
+	nextAction(0),
+	targets(),
+	numberOfSenders(0),
+	receivers(),
+	senders(),
+	wire(),
+	result()
+{
+	if (!this->wireConfig.isNone("trace") &&
+	    this->wireConfig.get<std::string>("trace.fileName") == traceFileName)
+	{
+		throw wns::Exception("WireReplay: the replayed wire would overwrite the trace");
+	}
+
+	WireTraceReader reader(traceFileName);
+
+	// frame number in the trace -> index in frames
+	std::map<uint32_t, size_t> index;
+	std::vector<bool> finished;
+	std::vector<Action> recorded;
+	std::set<int32_t> unicastTargets;
+	ChannelId channels = this->wireConfig.get<ChannelId>("channels");
+
+	TraceRecord r;
+	while (reader.next(r))
+	{
+		// multicasts are replayed as broadcasts (the replay has no
+		// group membership)
+		if (r.type == TraceRecord::UnicastStart ||
+		    r.type == TraceRecord::BroadcastStart ||
+		    r.type == TraceRecord::MulticastStart)
+		{
+			if (r.channel >= channels)
+			{
+				wns::Exception e;
+				e << "WireReplay: trace uses channel " << r.channel << " but the wire has only "
+				  << channels << " channel(s)";
+				throw e;
+			}
+
+			index[r.frame] = this->frames.size();
+			recorded.push_back(Action(this->frames.size(), false));
+			this->frames.push_back(Frame());
+			this->frames.back().start = r;
+			finished.push_back(false);
+
+			if (r.type == TraceRecord::UnicastStart)
+			{
+				unicastTargets.insert(r.target);
+			}
+			if (r.sender >= this->numberOfSenders)
+			{
+				this->numberOfSenders = r.sender + 1;
+			}
+			continue;
+		}
+
+		std::map<uint32_t, size_t>::iterator itr = index.find(r.frame);
+		if (itr == index.end())
+		{
+			// started before the trace begins
+			continue;
+		}
+
+		Frame& f = this->frames[itr->second];
+		if (r.type == TraceRecord::End)
+		{
+			f.duration = r.time - f.start.time;
+			finished[itr->second] = true;
+		}
+		else if (r.type == TraceRecord::Cancel)
+		{
+			f.cancelAt = r.time;
+			f.duration = 2.0 * (r.time - f.start.time) + 1E-9;
+			finished[itr->second] = true;
+			recorded.push_back(Action(itr->second, true));
+		}
+	}
+
+	// drop transmissions without end, preallocate the PDUs
+	std::vector<Frame> replayed;
+	std::vector<size_t> renumbered(this->frames.size());
+	replayed.reserve(this->frames.size());
+	for (size_t ii = 0; ii < this->frames.size(); ++ii)
+	{
+		if (finished[ii])
+		{
+			renumbered[ii] = replayed.size();
+			replayed.push_back(this->frames[ii]);
+			replayed.back().pdu = wns::osi::PDUPtr(
+				new wns::ldk::helper::FakePDU(this->frames[ii].start.length));
+		}
+	}
+	this->frames.swap(replayed);
+
+	for (size_t ii = 0; ii < recorded.size(); ++ii)
+	{
+		if (finished[recorded[ii].frame])
+		{
+			this->actions.push_back(Action(renumbered[recorded[ii].frame], recorded[ii].cancel));
+		}
+	}
+
+	this->targets.assign(unicastTargets.begin(), unicastTargets.end());
+}
+
+WireReplay::~WireReplay()
+{
+}
+
+ReplayResult
+WireReplay::run()
+{
+	wns::events::scheduler::Interface* scheduler = wns::simulator::getEventScheduler();
+
+	this->result = ReplayResult();
+	this->reset();
+	this->wire.reset(new Wire(this->wireConfig));
+
+	for (size_t ii = 0; ii < this->targets.size(); ++ii)
+	{
+		this->receivers.push_back(Receiver(wns::service::dll::UnicastAddress(this->targets[ii])));
+		this->wire->addReceiver(&this->receivers.back(), wns::service::dll::UnicastAddress(this->targets[ii]), true);
+	}
+	if (this->receivers.empty())
+	{
+		// broadcast only
+		this->receivers.push_back(Receiver(wns::service::dll::UnicastAddress(0)));
+		this->wire->addReceiver(&this->receivers.back(), wns::service::dll::UnicastAddress(0), true);
+	}
+
+	// not resized while the wire refers to the senders
+	this->senders.assign(this->numberOfSenders, Sender(&this->result));
+
+	this->nextAction = 0;
+	this->scheduleAction();
+
+	timeval begin;
+	timeval end;
+	gettimeofday(&begin, NULL);
+
+	unsigned long processed = 0;
+	while (scheduler->processOneEvent())
+	{
+		++processed;
+	}
+
+	gettimeofday(&end, NULL);
+	this->result.wallTime = (end.tv_sec - begin.tv_sec) + (end.tv_usec - begin.tv_usec) * 1E-6;
+
+	// one event per action
+	this->result.events = processed - this->nextAction;
+
+	this->reset();
+
+	return this->result;
+}
+
+void
+WireReplay::reset()
+{
+	this->wire.reset();
+	this->receivers.clear();
+	this->senders.clear();
+}
+
+size_t
+WireReplay::getNumberOfFrames() const
+{
+	return this->frames.size();
+}
+
+void
+WireReplay::onAction()
+{
+	const Action& action = this->actions[this->nextAction++];
+	if (action.cancel)
+	{
+		this->cancelFrame(action.frame);
+	}
+	else
+	{
+		this->startFrame(action.frame);
+	}
+	this->scheduleAction();
+}
+
+void
+WireReplay::scheduleAction()
+{
+	if (this->nextAction < this->actions.size())
+	{
+		wns::simulator::getEventScheduler()->schedule(
+			ActionEvent(this),
+			this->getTime(this->actions[this->nextAction]));
+	}
+}
+
+simTimeType
+WireReplay::getTime(const Action& action) const
+{
+	const Frame& f = this->frames[action.frame];
+	return action.cancel ? f.cancelAt : f.start.time;
+}
+
+void
+WireReplay::startFrame(size_t frame)
+{
+	const Frame& f = this->frames[frame];
+	TransmitterDataSentInterface* sender = &this->senders[f.start.sender];
+
+	if (f.start.type == TraceRecord::UnicastStart)
+	{
+		this->wire->sendData(
+			UnicastTransmissionPtr(
+				new UnicastTransmission(
+					wns::service::dll::UnicastAddress(f.start.target), f.pdu, sender, f.start.channel)),
+			f.duration);
+	}
+	else
+	{
+		this->wire->sendData(
+			BroadcastTransmissionPtr(new BroadcastTransmission(f.pdu, sender, f.start.channel)),
+			f.duration);
+	}
+	++this->result.frames;
+}
+
+void
+WireReplay::cancelFrame(size_t frame)
+{
+	this->wire->stopTransmission(this->frames[frame].pdu);
+	++this->result.cancelled;
+}
@@ -0,0 +1,330 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#ifndef COPPER_WIREREPLAY_HPP
+#define COPPER_WIREREPLAY_HPP
+
+#include <COPPER/Wire.hpp>
+#include <COPPER/WireTrace.hpp>
+#include <COPPER/Transmitter.hpp>
+#include <COPPER/ReceiverInterface.hpp>
+
+#include <WNS/pyconfig/View.hpp>
+
+#include <vector>
+#include <list>
+#include <string>
+#include <memory>
+
+namespace copper
+{
+	/**
+	 * @brief Result of WireReplay::run
+	 */
+	struct ReplayResult
+	{
+		ReplayResult() :
+			frames(0),
+			cancelled(0),
+			completed(0),
+			collisions(0),
+			events(0),
+			wallTime(0.0)
+		{}
+
+		/**
+		 * @brief Events processed per second (wall time)
+		 */
+		double
+		getEventsPerSecond() const;
+
+		/**
+		 * @brief Wall time per started frame in ns
+		 */
+		double
+		getNanosecondsPerFrame() const;
+
+		/**
+		 * @brief Transmissions started
+		 */
+		unsigned long frames;
+
+		unsigned long cancelled;
+
+		/**
+		 * @brief onDataSent calls
+		 */
+		unsigned long completed;
+
+		/**
+		 * @brief onCollision calls
+		 */
+		unsigned long collisions;
+
+		/**
+		 * @brief Events of the wire processed by the event scheduler
+		 * (the start and cancel events of the replay are not counted)
+		 */
+		unsigned long events;
+
+		/**
+		 * @brief In s
+		 */
+		double wallTime;
+	};
+
+	/**
+	 * @brief Replays a recorded WireTrace on a Wire without the rest of
+	 * the simulator
+	 *
+	 * The start and cancel records of the trace are replayed at their
+	 * recorded time by calling Wire::sendData and
+	 * Wire::stopTransmission directly. Only one replay event is pending
+	 * at a time, so records with equal time keep their order relative
+	 * to the events of the wire. Receivers for all targets in the
+	 * trace and the senders are minimal stubs, so the measured wall
+	 * time is dominated by the wire. The duration of a transmission is
+	 * taken from its end record. Transmissions cancelled in the trace
+	 * are started with a duration that exceeds the cancel time.
+	 * Transmissions without end or cancel record (e.g. at the end of
+	 * the trace) are not replayed.
+	 *
+	 * The trace is read completely on construction, run() uses the
+	 * global event scheduler which must be empty.
+	 */
+	class WireReplay
+	{
+		/**
+		 * @brief A transmission to be replayed
+		 */
+		struct Frame
+		{
+			Frame() :
+				start(),
+				duration(0.0),
+				cancelAt(-1.0),
+				pdu()
+			{}
+
+			TraceRecord start;
+
+			simTimeType duration;
+
+			/**
+			 * @brief Time of the cancel record, < 0.0 if not
+			 * cancelled
+			 */
+			simTimeType cancelAt;
+
+			wns::osi::PDUPtr pdu;
+		};
+
+		/**
+		 * @brief Counts the calls of the wire
+		 */
+		class Sender :
+			virtual public TransmitterDataSentInterface
+		{
+		public:
+			explicit
+			Sender(ReplayResult* r);
+
+			virtual void
+			onDataSent(const TransmissionPtr& transmission);
+
+			virtual void
+			onCollision(const TransmissionPtr& transmission);
+
+			virtual void
+			onWireIdle(ChannelId channel);
+
+		private:
+			ReplayResult* result;
+		};
+
+		/**
+		 * @brief Accepts unicast data for its address and all broadcast
+		 * data
+		 */
+		class Receiver :
+			virtual public ReceiverInterface
+		{
+		public:
+			explicit
+			Receiver(const wns::service::dll::UnicastAddress& _address);
+
+			virtual bool
+			onData(const UnicastTransmissionPtr& transmission);
+
+			virtual bool
+			onData(const BroadcastTransmissionPtr& transmission);
+
+			virtual bool
+			onData(const MulticastTransmissionPtr& transmission);
+
+			virtual void
+			onCopperFree(ChannelId channel);
+
+			virtual void
+			onCopperBusy(ChannelId channel);
+
+			virtual void
+			onCollision(ChannelId channel);
+
+		private:
+			wns::service::dll::UnicastAddress address;
+		};
+
+		/**
+		 * @brief Start or cancel of a frame
+		 */
+		struct Action
+		{
+			Action(size_t f, bool c) :
+				frame(f),
+				cancel(c)
+			{}
+
+			size_t frame;
+
+			bool cancel;
+		};
+
+		/**
+		 * @brief Executes the next action
+		 */
+		class ActionEvent
+		{
+		public:
+			explicit
+			ActionEvent(WireReplay* r) :
+				replay(r)
+			{}
+
+			void
+			operator()()
+			{
+				this->replay->onAction();
+			}
+
+		private:
+			WireReplay* replay;
+		};
+
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * @param wireConfig Configuration of the Wire to be used (see
+		 * copper.Copper.Wire)
+		 * @param traceFileName Trace written by WireTrace
+		 */
+		WireReplay(
+			const wns::pyconfig::View& wireConfig,
+			const std::string& traceFileName);
+
+		~WireReplay();
+
+		/**
+		 * @brief Replays the trace and returns the measurements
+		 */
+		ReplayResult
+		run();
+
+		/**
+		 * @brief Number of transmissions that will be replayed
+		 */
+		size_t
+		getNumberOfFrames() const;
+
+	private:
+		WireReplay(const WireReplay&);
+
+		WireReplay&
+		operator=(const WireReplay&);
+
+		/**
+		 * @brief Executes the next action and schedules the following
+		 */
+		void
+		onAction();
+
+		void
+		scheduleAction();
+
+		simTimeType
+		getTime(const Action& action) const;
+
+		void
+		startFrame(size_t frame);
+
+		void
+		cancelFrame(size_t frame);
+
+		/**
+		 * @brief Deletes the wire and the stubs of the last run
+		 */
+		void
+		reset();
+
+		wns::pyconfig::View wireConfig;
+
+		std::vector<Frame> frames;
+
+		/**
+		 * @brief Starts and cancels in the order of the trace
+		 */
+		std::vector<Action> actions;
+
+		size_t nextAction;
+
+		/**
+		 * @brief MAC addresses of all unicast targets
+		 */
+		std::vector<int32_t> targets;
+
+		/**
+		 * @brief Number of senders in the trace
+		 */
+		uint32_t numberOfSenders;
+
+		/**
+		 * @brief Stubs of the current run, declared before the wire
+		 * which refers to them and is deleted first
+		 */
+		std::list<Receiver> receivers;
+
+		std::vector<Sender> senders;
+
+		std::auto_ptr<Wire> wire;
+
+		ReplayResult result;
+	};
+}
+
+#endif // NOT defined COPPER_WIREREPLAY_HPP
@@ -0,0 +1,74 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#ifndef COPPER_WIRETAP_HPP
+#define COPPER_WIRETAP_HPP
+
+#include <COPPER/Transmission.hpp>
+
+namespace copper {
+
+	/**
+	 * @brief Promiscuous observer of a Wire (see Wire::addTap)
+	 *
+	 * A tap sees every completed transmission of the wire, on all
+	 * channels and independent of the target, including collided ones
+	 * (Transmission::collision). Cancelled transmissions are not
+	 * reported. Taps are not receivers: they are not part of the
+	 * delivery fan-out, the address mapping or the round robin wakeup.
+	 */
+	class WireTap
+	{
+	public:
+		virtual
+		~WireTap()
+		{}
+
+		/**
+		 * @brief Called after the target has been informed
+		 */
+		virtual void
+		onUnicast(const UnicastTransmissionPtr& transmission) = 0;
+
+		/**
+		 * @brief Called after all receivers have been informed
+		 */
+		virtual void
+		onBroadcast(const BroadcastTransmissionPtr& transmission) = 0;
+
+		/**
+		 * @brief Called after all members of the group have been
+		 * informed, ignored by default
+		 */
+		virtual void
+		onMulticast(const MulticastTransmissionPtr& /*transmission*/)
+		{}
+	};
+} // copper
+
+#endif // COPPER_WIRETAP_HPP
@@ -0,0 +1,372 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#include <COPPER/WireTrace.hpp>
+
+#include <WNS/events/scheduler/Interface.hpp>
+#include <WNS/Exception.hpp>
+
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <cerrno>
+#include <sstream>
+
+using namespace copper;
+
+namespace
+{
+	const char traceMagic[4] = {'C', 'W', 'T', 'R'};
+}
+
+const uint32_t WireTrace::version;
+
+WireTrace::WireTrace(const wns::pyconfig::View& config) :
+	fileName(config.get<std::string>("fileName")),
+	capacity(config.get<uint32_t>("capacity")),
+	ring(config.get<bool>("ring")),
+	flushInterval(config.get<unsigned long>("flushInterval")),
+	enabled(config.get<bool>("enabled")),
+	mapping(NULL),
+	mappingSize(0),
+	header(NULL),
+	records(NULL),
+	segment(0),
+	numberOfRecords(0),
+	nextFrame(0),
+	frames(),
+	senders()
+{
+	this->openSegment();
+}
+
+WireTrace::WireTrace(
+	const std::string& _fileName,
+	uint32_t _capacity,
+	bool _ring,
+	unsigned long _flushInterval) :
+	fileName(_fileName),
+	capacity(_capacity),
+	ring(_ring),
+	flushInterval(_flushInterval),
+	enabled(true),
+	mapping(NULL),
+	mappingSize(0),
+	header(NULL),
+	records(NULL),
+	segment(0),
+	numberOfRecords(0),
+	nextFrame(0),
+	frames(),
+	senders()
+{
+	this->openSegment();
+}
+
+WireTrace::~WireTrace()
+{
+	this->closeSegment();
+}
+
+void
+WireTrace::setEnabled(bool _enabled)
+{
+	this->enabled = _enabled;
+
+	if (!this->enabled)
+	{
+		// the ends of the ongoing transmissions are not recorded,
+		// their PDUs may be deleted and the addresses reused
+		this->frames.clear();
+	}
+}
+
+void
+WireTrace::record(
+	TraceRecord::Type type,
+	uint32_t wire,
+	const TransmissionPtr& t,
+	int32_t target)
+{
+	if (!this->ring && this->header->written == this->capacity)
+	{
+		this->closeSegment();
+		++this->segment;
+		this->openSegment();
+	}
+
+	const wns::osi::PDU* pdu = t->pdu.getPtr();
+	uint32_t frame;
+	if (type == TraceRecord::UnicastStart ||
+	    type == TraceRecord::BroadcastStart ||
+	    type == TraceRecord::MulticastStart)
+	{
+		frame = this->nextFrame++;
+		this->frames[pdu] = frame;
+	}
+	else
+	{
+		std::map<const wns::osi::PDU*, uint32_t>::iterator itr = this->frames.find(pdu);
+		if (itr == this->frames.end())
+		{
+			// started while tracing was disabled
+			itr = this->frames.insert(std::make_pair(pdu, this->nextFrame++)).first;
+		}
+		frame = itr->second;
+		if (type != TraceRecord::Collision)
+		{
+			this->frames.erase(itr);
+		}
+	}
+
+	Bit length = t->pdu->getLengthInBits();
+	for (
+		PDUContainer::const_iterator itr = t->burst.begin();
+		itr != t->burst.end();
+		++itr)
+	{
+		length += (*itr)->getLengthInBits();
+	}
+
+	TraceRecord& r = this->records[this->header->written % this->capacity];
+	r.time = wns::simulator::getEventScheduler()->getTime();
+	r.wire = wire;
+	r.frame = frame;
+	r.sender = this->getSenderId(t->sender);
+	r.target = target;
+	r.length = length;
+	r.channel = t->channel;
+	r.type = type;
+	r.collision = t->collision;
+
+	++this->header->written;
+	++this->numberOfRecords;
+
+	if (this->flushInterval > 0 && this->numberOfRecords % this->flushInterval == 0)
+	{
+		this->flush();
+	}
+}
+
+void
+WireTrace::flush()
+{
+	::msync(this->mapping, this->mappingSize, MS_ASYNC);
+}
+
+uint64_t
+WireTrace::getNumberOfRecords() const
+{
+	return this->numberOfRecords;
+}
+
+std::string
+WireTrace::getSegmentFileName(const std::string& fileName, uint32_t segment)
+{
+	if (segment == 0)
+	{
+		return fileName;
+	}
+
+	std::stringstream ss;
+	ss << fileName << "." << segment;
+	return ss.str();
+}
+
+void
+WireTrace::openSegment()
+{
+	if (this->capacity == 0)
+	{
+		throw wns::Exception("WireTrace: capacity must be > 0");
+	}
+
+	std::string name = getSegmentFileName(this->fileName, this->segment);
+	this->mappingSize = sizeof(TraceFileHeader) + this->capacity * sizeof(TraceRecord);
+
+	int fd = ::open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+	{
+		wns::Exception e;
+		e << "WireTrace: can not open " << name << ": " << std::strerror(errno);
+		throw e;
+	}
+
+	if (::ftruncate(fd, this->mappingSize) != 0)
+	{
+		::close(fd);
+		wns::Exception e;
+		e << "WireTrace: can not resize " << name << ": " << std::strerror(errno);
+		throw e;
+	}
+
+	this->mapping = ::mmap(NULL, this->mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	// the mapping stays valid
+	::close(fd);
+
+	if (this->mapping == MAP_FAILED)
+	{
+		this->mapping = NULL;
+		wns::Exception e;
+		e << "WireTrace: can not map " << name << ": " << std::strerror(errno);
+		throw e;
+	}
+
+	this->header = static_cast<TraceFileHeader*>(this->mapping);
+	std::memcpy(this->header->magic, traceMagic, sizeof(traceMagic));
+	this->header->version = version;
+	this->header->recordSize = sizeof(TraceRecord);
+	this->header->capacity = this->capacity;
+	this->header->written = 0;
+	this->header->segment = this->segment;
+	this->header->ring = this->ring ? 1 : 0;
+
+	this->records = reinterpret_cast<TraceRecord*>(this->header + 1);
+}
+
+void
+WireTrace::closeSegment()
+{
+	if (this->mapping != NULL)
+	{
+		::munmap(this->mapping, this->mappingSize);
+		this->mapping = NULL;
+		this->header = NULL;
+		this->records = NULL;
+	}
+}
+
+uint32_t
+WireTrace::getSenderId(const TransmitterDataSentInterface* sender)
+{
+	std::map<const TransmitterDataSentInterface*, uint32_t>::iterator itr =
+		this->senders.find(sender);
+
+	if (itr == this->senders.end())
+	{
+		itr = this->senders.insert(std::make_pair(sender, this->senders.size())).first;
+	}
+	return itr->second;
+}
+
+WireTraceReader::WireTraceReader(const std::string& fileName) :
+	file(fileName.c_str(), std::ios::in | std::ios::binary),
+	header(),
+	first(0),
+	count(0),
+	position(0)
+{
+	if (!this->file)
+	{
+		wns::Exception e;
+		e << "WireTraceReader: can not open " << fileName;
+		throw e;
+	}
+
+	this->file.read(reinterpret_cast<char*>(&this->header), sizeof(this->header));
+
+	if (!this->file ||
+	    std::memcmp(this->header.magic, traceMagic, sizeof(traceMagic)) != 0 ||
+	    this->header.version != WireTrace::version ||
+	    this->header.recordSize != sizeof(TraceRecord) ||
+	    this->header.capacity == 0)
+	{
+		wns::Exception e;
+		e << "WireTraceReader: " << fileName << " is not a wire trace (version "
+		  << WireTrace::version << ")";
+		throw e;
+	}
+
+	if (this->header.written > this->header.capacity)
+	{
+		// ring mode, the oldest records have been overwritten
+		this->count = this->header.capacity;
+		this->first = this->header.written % this->header.capacity;
+	}
+	else
+	{
+		this->count = this->header.written;
+		this->first = 0;
+	}
+}
+
+bool
+WireTraceReader::next(TraceRecord& r)
+{
+	if (this->position == this->count)
+	{
+		return false;
+	}
+
+	uint64_t index = (this->first + this->position) % this->header.capacity;
+	this->file.seekg(sizeof(TraceFileHeader) + index * sizeof(TraceRecord));
+	this->file.read(reinterpret_cast<char*>(&r), sizeof(TraceRecord));
+	if (!this->file)
+	{
+		throw wns::Exception("WireTraceReader: trace file truncated");
+	}
+
+	++this->position;
+	return true;
+}
+
+const TraceFileHeader&
+WireTraceReader::getHeader() const
+{
+	return this->header;
+}
+
+uint64_t
+WireTraceReader::size() const
+{
+	return this->count;
+}
+
+const char*
+WireTraceReader::getTypeName(uint8_t type)
+{
+	switch (type)
+	{
+	case TraceRecord::UnicastStart:
+		return "unicast";
+	case TraceRecord::BroadcastStart:
+		return "broadcast";
+	case TraceRecord::End:
+		return "end";
+	case TraceRecord::Cancel:
+		return "cancel";
+	case TraceRecord::Collision:
+		return "collision";
+	case TraceRecord::MulticastStart:
+		return "multicast";
+	default:
+		return "unknown";
+	}
+}
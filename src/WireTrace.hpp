@@ -0,0 +1,308 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#ifndef COPPER_WIRETRACE_HPP
+#define COPPER_WIRETRACE_HPP
+
+#include <COPPER/Transmission.hpp>
+
+#include <WNS/pyconfig/View.hpp>
+
+#include <stdint.h>
+#include <string>
+#include <fstream>
+#include <map>
+
+namespace copper
+{
+	/**
+	 * @brief Fixed size record of the binary wire trace
+	 */
+	struct TraceRecord
+	{
+		enum Type
+		{
+			UnicastStart = 0,
+			BroadcastStart = 1,
+			End = 2,
+			Cancel = 3,
+			Collision = 4,
+			MulticastStart = 5
+		};
+
+		/**
+		 * @brief Simulation time
+		 */
+		double time;
+
+		/**
+		 * @brief Wire::getId of the wire
+		 */
+		uint32_t wire;
+
+		/**
+		 * @brief Number of the transmission within the trace, the same
+		 * for all records of a transmission
+		 */
+		uint32_t frame;
+
+		/**
+		 * @brief Sender id, numbered in the order of appearance
+		 */
+		uint32_t sender;
+
+		/**
+		 * @brief MAC address of the target, -1 for broadcast, the
+		 * group for multicast (only set in start records, -1
+		 * otherwise)
+		 */
+		int32_t target;
+
+		/**
+		 * @brief Bits of the transmission (including the burst)
+		 */
+		uint32_t length;
+
+		uint16_t channel;
+
+		/**
+		 * @brief One of Type
+		 */
+		uint8_t type;
+
+		uint8_t collision;
+	};
+
+	/**
+	 * @brief Header at the beginning of each trace file
+	 */
+	struct TraceFileHeader
+	{
+		char magic[4];
+
+		uint32_t version;
+
+		uint32_t recordSize;
+
+		/**
+		 * @brief Number of records the file can hold
+		 */
+		uint32_t capacity;
+
+		/**
+		 * @brief Number of records written to this file. In ring mode
+		 * this may exceed capacity, the oldest records are then
+		 * overwritten.
+		 */
+		uint64_t written;
+
+		/**
+		 * @brief Number of the segment (segment mode)
+		 */
+		uint32_t segment;
+
+		/**
+		 * @brief 1 in ring mode
+		 */
+		uint32_t ring;
+	};
+
+	/**
+	 * @brief Records wire activity into a memory mapped file
+	 *
+	 * In ring mode a single file of fixed capacity is used and the
+	 * oldest records are overwritten. Otherwise a new segment file
+	 * (fileName.1, fileName.2, ...) is started whenever the current one
+	 * is full. The mapping is written back by the kernel, flushInterval
+	 * (in records) additionally triggers an asynchronous msync.
+	 */
+	class WireTrace
+	{
+	public:
+		static const uint32_t version = 1;
+
+		/**
+		 * @brief Constructor (config keys "fileName", "capacity",
+		 * "ring", "enabled", "flushInterval")
+		 */
+		explicit
+		WireTrace(const wns::pyconfig::View& config);
+
+		WireTrace(
+			const std::string& fileName,
+			uint32_t capacity,
+			bool ring,
+			unsigned long flushInterval = 0);
+
+		/**
+		 * @brief Destructor, writes back and unmaps the file
+		 */
+		~WireTrace();
+
+		/**
+		 * @brief Switch recording on or off at runtime
+		 *
+		 * Switching off forgets the ongoing transmissions, records of
+		 * their end get a new frame number.
+		 */
+		void
+		setEnabled(bool _enabled);
+
+		bool
+		isEnabled() const
+		{
+			return this->enabled;
+		}
+
+		/**
+		 * @brief Appends a record for the transmission
+		 *
+		 * @param target MAC address (integer) or -1 for broadcast
+		 */
+		void
+		record(
+			TraceRecord::Type type,
+			uint32_t wire,
+			const TransmissionPtr& t,
+			int32_t target);
+
+		/**
+		 * @brief Asynchronous write back of the mapping
+		 */
+		void
+		flush();
+
+		/**
+		 * @brief Total number of records written (all segments)
+		 */
+		uint64_t
+		getNumberOfRecords() const;
+
+		/**
+		 * @brief File name of the given segment
+		 */
+		static std::string
+		getSegmentFileName(const std::string& fileName, uint32_t segment);
+
+	private:
+		WireTrace(const WireTrace&);
+
+		WireTrace&
+		operator=(const WireTrace&);
+
+		void
+		openSegment();
+
+		void
+		closeSegment();
+
+		uint32_t
+		getSenderId(const TransmitterDataSentInterface* sender);
+
+		std::string fileName;
+
+		uint32_t capacity;
+
+		bool ring;
+
+		unsigned long flushInterval;
+
+		bool enabled;
+
+		/**
+		 * @brief Mapping of the current file (header + records)
+		 */
+		void* mapping;
+
+		size_t mappingSize;
+
+		TraceFileHeader* header;
+
+		TraceRecord* records;
+
+		uint32_t segment;
+
+		uint64_t numberOfRecords;
+
+		uint32_t nextFrame;
+
+		/**
+		 * @brief Frame numbers of the ongoing transmissions
+		 */
+		std::map<const wns::osi::PDU*, uint32_t> frames;
+
+		std::map<const TransmitterDataSentInterface*, uint32_t> senders;
+	};
+
+	/**
+	 * @brief Reads the records of a trace file in chronological order
+	 */
+	class WireTraceReader
+	{
+	public:
+		/**
+		 * @brief Opens the file, throws if it is not a valid trace
+		 */
+		explicit
+		WireTraceReader(const std::string& fileName);
+
+		/**
+		 * @brief Returns false at the end of the file
+		 */
+		bool
+		next(TraceRecord& r);
+
+		const TraceFileHeader&
+		getHeader() const;
+
+		/**
+		 * @brief Number of records available in the file
+		 */
+		uint64_t
+		size() const;
+
+		/**
+		 * @brief Name of the record type
+		 */
+		static const char*
+		getTypeName(uint8_t type);
+
+	private:
+		std::ifstream file;
+
+		TraceFileHeader header;
+
+		uint64_t first;
+
+		uint64_t count;
+
+		uint64_t position;
+	};
+}
+
+#endif // NOT defined COPPER_WIRETRACE_HPP
@@ -0,0 +1,191 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#include <COPPER/AsyncLog.hpp>
+#include <COPPER/Logging.hpp>
+
+#include <WNS/events/scheduler/Interface.hpp>
+#include <WNS/CppUnit.hpp>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+namespace copper { namespace tests {
+
+	/**
+	 * @brief Test for copper::AsyncLog
+	 */
+	class AsyncLogTest :
+		public wns::TestFixture
+	{
+		CPPUNIT_TEST_SUITE( AsyncLogTest );
+		CPPUNIT_TEST( capacity );
+		CPPUNIT_TEST( drop );
+		CPPUNIT_TEST( block );
+		CPPUNIT_TEST( format );
+		CPPUNIT_TEST( messageMacro );
+		CPPUNIT_TEST_SUITE_END();
+	public:
+		void prepare();
+		void cleanup();
+		void capacity();
+		void drop();
+		void block();
+		void format();
+		void messageMacro();
+
+	private:
+		static unsigned long
+		countLines(const std::string& fileName, std::string& last);
+	};
+
+	CPPUNIT_TEST_SUITE_REGISTRATION( AsyncLogTest );
+
+	void
+	AsyncLogTest::prepare()
+	{
+		wns::simulator::getEventScheduler()->reset();
+	}
+
+	void
+	AsyncLogTest::cleanup()
+	{
+		AsyncLog::setActive(NULL);
+		std::remove("asyncLogTest.log");
+	}
+
+	unsigned long
+	AsyncLogTest::countLines(const std::string& fileName, std::string& last)
+	{
+		std::ifstream file(fileName.c_str());
+		std::string line;
+		unsigned long lines = 0;
+		while (std::getline(file, line))
+		{
+			last = line;
+			++lines;
+		}
+		return lines;
+	}
+
+	void
+	AsyncLogTest::capacity()
+	{
+		AsyncLog log("asyncLogTest.log", 5, AsyncLog::Drop);
+		CPPUNIT_ASSERT_EQUAL( 8UL, log.getCapacity() );
+	}
+
+	void
+	AsyncLogTest::drop()
+	{
+		{
+			// no writer thread: the ring fills up
+			AsyncLog log("asyncLogTest.log", 4, AsyncLog::Drop);
+			for (int ii = 0; ii < 10; ++ii)
+			{
+				log.record(LogEntry::WireCollision, 1, -1, ii, 0.0);
+			}
+			CPPUNIT_ASSERT_EQUAL( 6UL, log.getDropped() );
+
+			log.stop();
+			CPPUNIT_ASSERT_EQUAL( 4UL, log.getWritten() );
+		}
+
+		std::string last;
+		CPPUNIT_ASSERT_EQUAL( 5UL, countLines("asyncLogTest.log", last) );
+		CPPUNIT_ASSERT_EQUAL( std::string("# 6 records dropped"), last );
+	}
+
+	void
+	AsyncLogTest::block()
+	{
+		{
+			AsyncLog log("asyncLogTest.log", 4, AsyncLog::Block);
+			log.start();
+			for (int ii = 0; ii < 1000; ++ii)
+			{
+				log.record(LogEntry::WireChannelFree, 1, -1, ii, 0.0);
+			}
+			log.stop();
+			CPPUNIT_ASSERT_EQUAL( 0UL, log.getDropped() );
+			CPPUNIT_ASSERT_EQUAL( 1000UL, log.getWritten() );
+		}
+
+		std::string last;
+		CPPUNIT_ASSERT_EQUAL( 1000UL, countLines("asyncLogTest.log", last) );
+		CPPUNIT_ASSERT_EQUAL( std::string("0 wire 1: Channel 999 is free again"), last );
+	}
+
+	void
+	AsyncLogTest::format()
+	{
+		LogEntry e;
+		e.time = 0.5;
+		e.source = 3;
+		e.kind = LogEntry::WireUnicastStart;
+		e.a = 7;
+		e.b = 1;
+		e.value = 0.75;
+		CPPUNIT_ASSERT_EQUAL(
+			std::string("0.5 wire 3: Sending to MAC address: 7 on channel 1. Arrival time: 0.75"),
+			AsyncLog::format(e) );
+
+		e.kind = LogEntry::ReceiverDeliver;
+		e.value = 0.25;
+		CPPUNIT_ASSERT_EQUAL(
+			std::string("0.5 receiver 3: Delivering PDU with BER: 0.25"),
+			AsyncLog::format(e) );
+	}
+
+	void
+	AsyncLogTest::messageMacro()
+	{
+		wns::logger::Logger logger("COPPER", "AsyncLogTest");
+		AsyncLog log("asyncLogTest.log", 16, AsyncLog::Drop);
+		AsyncLog::setActive(&log);
+
+		COPPER_FRAME_RECORD(
+			NORMAL, logger,
+			WireCollision, 2, -1, 0, 0.0,
+			"Collision occured on channel 0!!");
+		AsyncLog::setActive(NULL);
+		COPPER_FRAME_RECORD(
+			NORMAL, logger,
+			WireCollision, 2, -1, 0, 0.0,
+			"Collision occured on channel 0!!");
+
+		log.stop();
+		unsigned long expected = COPPER_LOG_LEVEL >= COPPER_LOG_FRAME ? 1 : 0;
+		CPPUNIT_ASSERT_EQUAL( expected, log.getWritten() );
+	}
+
+} // tests
+} // copper
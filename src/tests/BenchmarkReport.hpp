@@ -0,0 +1,174 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#ifndef COPPER_TESTS_BENCHMARKREPORT_HPP
+#define COPPER_TESTS_BENCHMARKREPORT_HPP
+
+#include <sys/time.h>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace copper { namespace tests {
+
+	/**
+	 * @brief Measures the wall time between start and stop
+	 */
+	class Stopwatch
+	{
+	public:
+		Stopwatch() :
+			seconds(0.0)
+		{
+			gettimeofday(&this->begin, NULL);
+		}
+
+		void
+		start()
+		{
+			gettimeofday(&this->begin, NULL);
+		}
+
+		/**
+		 * @brief Adds the time since start to the measured time
+		 */
+		void
+		stop()
+		{
+			timeval end;
+			gettimeofday(&end, NULL);
+			this->seconds +=
+				(end.tv_sec - this->begin.tv_sec) +
+				(end.tv_usec - this->begin.tv_usec) * 1E-6;
+		}
+
+		double
+		getSeconds() const
+		{
+			return this->seconds;
+		}
+
+	private:
+		timeval begin;
+
+		double seconds;
+	};
+
+	/**
+	 * @brief Collects the results of the performance suites and writes
+	 * them as JSON
+	 *
+	 * The file is rewritten after each result, so a crashing benchmark
+	 * keeps the results of the previous ones. The file name is taken
+	 * from the environment variable COPPER_BENCHMARK_FILE (default
+	 * "copperBenchmarks.json").
+	 */
+	class BenchmarkReport
+	{
+		struct Result
+		{
+			std::string name;
+			std::string parameterName;
+			unsigned long parameter;
+			unsigned long iterations;
+			double seconds;
+		};
+
+	public:
+		static BenchmarkReport&
+		getInstance()
+		{
+			static BenchmarkReport report;
+			return report;
+		}
+
+		/**
+		 * @brief Adds the result of a benchmark run with the given
+		 * parameter (e.g. the number of receivers)
+		 */
+		void
+		add(
+			const std::string& name,
+			const std::string& parameterName,
+			unsigned long parameter,
+			unsigned long iterations,
+			double seconds)
+		{
+			Result r;
+			r.name = name;
+			r.parameterName = parameterName;
+			r.parameter = parameter;
+			r.iterations = iterations;
+			r.seconds = seconds;
+			this->results.push_back(r);
+			this->write();
+		}
+
+	private:
+		BenchmarkReport() :
+			results(),
+			fileName("copperBenchmarks.json")
+		{
+			const char* env = std::getenv("COPPER_BENCHMARK_FILE");
+			if (env != NULL)
+			{
+				this->fileName = env;
+			}
+		}
+
+		void
+		write() const
+		{
+			std::ofstream out(this->fileName.c_str());
+			out << "{\n  \"module\": \"copper\",\n  \"benchmarks\": [";
+			for (size_t ii = 0; ii < this->results.size(); ++ii)
+			{
+				const Result& r = this->results[ii];
+				double perIteration = r.iterations > 0 ? r.seconds / r.iterations : 0.0;
+				out << (ii == 0 ? "\n" : ",\n")
+				    << "    {\"name\": \"" << r.name << "\""
+				    << ", \"" << r.parameterName << "\": " << r.parameter
+				    << ", \"iterations\": " << r.iterations
+				    << ", \"seconds\": " << r.seconds
+				    << ", \"nsPerIteration\": " << perIteration * 1E9
+				    << ", \"iterationsPerSecond\": "
+				    << (r.seconds > 0.0 ? r.iterations / r.seconds : 0.0)
+				    << "}";
+			}
+			out << "\n  ]\n}\n";
+		}
+
+		std::vector<Result> results;
+
+		std::string fileName;
+	};
+
+} // tests
+} // copper
+
+#endif // NOT defined COPPER_TESTS_BENCHMARKREPORT_HPP
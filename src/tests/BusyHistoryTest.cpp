@@ -0,0 +1,146 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#include <COPPER/BusyHistory.hpp>
+
+#include <WNS/CppUnit.hpp>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace copper { namespace tests {
+
+	/**
+	 * @brief Test for copper::BusyHistory
+	 */
+	class BusyHistoryTest :
+		public wns::TestFixture
+	{
+		CPPUNIT_TEST_SUITE( BusyHistoryTest );
+		CPPUNIT_TEST( periods );
+		CPPUNIT_TEST( ongoing );
+		CPPUNIT_TEST( horizon );
+		CPPUNIT_TEST( perceived );
+		CPPUNIT_TEST_SUITE_END();
+	public:
+		void prepare();
+		void cleanup();
+		void periods();
+		void ongoing();
+		void horizon();
+		void perceived();
+	};
+
+	CPPUNIT_TEST_SUITE_REGISTRATION( BusyHistoryTest );
+
+	void
+	BusyHistoryTest::prepare()
+	{
+	}
+
+	void
+	BusyHistoryTest::cleanup()
+	{
+	}
+
+	void
+	BusyHistoryTest::periods()
+	{
+		BusyHistory h(4);
+		CPPUNIT_ASSERT( h.blockedSince(1.0) < 0.0 );
+
+		h.busy(1.0);
+		h.free(2.0);
+		h.busy(3.0);
+		h.free(3.5);
+
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), h.size());
+		CPPUNIT_ASSERT( h.blockedSince(0.5) < 0.0 );
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, h.blockedSince(1.0), 1E-9);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, h.blockedSince(1.5), 1E-9);
+		// the end of a period is free
+		CPPUNIT_ASSERT( h.blockedSince(2.0) < 0.0 );
+		CPPUNIT_ASSERT( h.blockedSince(2.5) < 0.0 );
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(0.25, h.blockedSince(3.25), 1E-9);
+		CPPUNIT_ASSERT( h.blockedSince(10.0) < 0.0 );
+	}
+
+	void
+	BusyHistoryTest::ongoing()
+	{
+		BusyHistory h(4);
+		h.busy(1.0);
+
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), h.size());
+		CPPUNIT_ASSERT( h.blockedSince(0.5) < 0.0 );
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(9.0, h.blockedSince(10.0), 1E-9);
+	}
+
+	void
+	BusyHistoryTest::horizon()
+	{
+		BusyHistory h(2);
+		h.busy(1.0);
+		h.free(2.0);
+		h.busy(3.0);
+		h.free(4.0);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, h.blockedSince(1.5), 1E-9);
+
+		// forgets [1.0, 2.0)
+		h.busy(5.0);
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), h.size());
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, h.getHorizon(), 1E-9);
+		// forgotten times are reported busy
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, h.blockedSince(1.5), 1E-9);
+		CPPUNIT_ASSERT( h.blockedSince(0.5) >= 0.0 );
+		CPPUNIT_ASSERT( h.isBusyAt(2.5, 1.0) );
+		CPPUNIT_ASSERT( h.blockedSince(2.0) < 0.0 );
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, h.blockedSince(3.5), 1E-9);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, h.blockedSince(6.0), 1E-9);
+	}
+
+	void
+	BusyHistoryTest::perceived()
+	{
+		BusyHistory h(4);
+		h.busy(1.0);
+		h.free(2.0);
+
+		// start and end are both perceived 0.5 later
+		CPPUNIT_ASSERT( !h.isBusyAt(1.0, 0.5) );
+		CPPUNIT_ASSERT( !h.isBusyAt(1.25, 0.5) );
+		CPPUNIT_ASSERT( h.isBusyAt(1.5, 0.5) );
+		CPPUNIT_ASSERT( h.isBusyAt(2.25, 0.5) );
+		CPPUNIT_ASSERT( !h.isBusyAt(2.5, 0.5) );
+
+		// without sensing time the state of the channel itself
+		CPPUNIT_ASSERT( h.isBusyAt(1.0, 0.0) );
+		CPPUNIT_ASSERT( !h.isBusyAt(2.0, 0.0) );
+	}
+
+} // tests
+} // copper
@@ -0,0 +1,175 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include <COPPER/ChromeTrace.hpp>
+#include <COPPER/Wire.hpp>
+#include <COPPER/tests/TransmitterDataSentMock.hpp>
+#include <COPPER/tests/ReceiverMock.hpp>
+
+#include <WNS/pyconfig/helper/Functions.hpp>
+#include <WNS/ldk/helper/FakePDU.hpp>
+#include <WNS/CppUnit.hpp>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace copper { namespace tests {
+
+	/**
+	 * @brief Test for copper::ChromeTrace
+	 */
+	class ChromeTraceTest :
+		public wns::TestFixture
+	{
+		CPPUNIT_TEST_SUITE( ChromeTraceTest );
+		CPPUNIT_TEST( wireActivity );
+		CPPUNIT_TEST( escapedNames );
+		CPPUNIT_TEST_SUITE_END();
+	public:
+		void prepare();
+		void cleanup();
+		void wireActivity();
+		void escapedNames();
+
+	private:
+		/**
+		 * @brief Number of occurrences of the pattern
+		 */
+		static int
+		count(const std::string& text, const std::string& pattern);
+
+		TransmitterDataSentMock* transmitter;
+	};
+
+	CPPUNIT_TEST_SUITE_REGISTRATION( ChromeTraceTest );
+
+	void
+	ChromeTraceTest::prepare()
+	{
+		wns::simulator::getEventScheduler()->reset();
+		transmitter = new TransmitterDataSentMock();
+	}
+
+	void
+	ChromeTraceTest::cleanup()
+	{
+		delete transmitter;
+		std::remove("chromeTraceTest.json");
+	}
+
+	int
+	ChromeTraceTest::count(const std::string& text, const std::string& pattern)
+	{
+		int n = 0;
+		for (
+			std::string::size_type pos = text.find(pattern);
+			pos != std::string::npos;
+			pos = text.find(pattern, pos + pattern.size()))
+		{
+			++n;
+		}
+		return n;
+	}
+
+	void
+	ChromeTraceTest::wireActivity()
+	{
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Wire, ChromeTrace\n"
+				"wire = Wire('tracedWire', chromeTrace = ChromeTrace('chromeTraceTest.json', bufferSize = 64))\n"
+				);
+
+		{
+			Wire wire(config.get<wns::pyconfig::View>("wire"));
+			ReceiverMock receiver1(wns::service::dll::UnicastAddress(1));
+			ReceiverMock receiver2(wns::service::dll::UnicastAddress(2));
+			wire.addReceiver(&receiver1, wns::service::dll::UnicastAddress(1), true);
+			wire.addReceiver(&receiver2, wns::service::dll::UnicastAddress(2), true);
+
+			wns::osi::PDUPtr pdu1(new wns::ldk::helper::FakePDU(100));
+			wns::osi::PDUPtr pdu2(new wns::ldk::helper::FakePDU(200));
+			wire.sendData(
+				UnicastTransmissionPtr(new UnicastTransmission(wns::service::dll::UnicastAddress(1), pdu1, transmitter)),
+				0.1);
+			wire.sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu2, transmitter)), 0.1);
+			wire.stopTransmission(pdu2);
+			wns::simulator::getEventScheduler()->processOneEvent();
+		}
+
+		std::ifstream in("chromeTraceTest.json");
+		std::stringstream ss;
+		ss << in.rdbuf();
+		std::string json = ss.str();
+
+		CPPUNIT_ASSERT_EQUAL(std::string("["), json.substr(0, 1));
+		CPPUNIT_ASSERT_EQUAL(std::string("]\n"), json.substr(json.size() - 2));
+
+		// wire, channel 0, 2 receivers, 1 sender
+		CPPUNIT_ASSERT_EQUAL(1, count(json, "\"process_name\""));
+		CPPUNIT_ASSERT_EQUAL(4, count(json, "\"thread_name\""));
+
+		// cancelled broadcast, completed unicast
+		CPPUNIT_ASSERT_EQUAL(2, count(json, "\"cat\":\"transmission\""));
+		CPPUNIT_ASSERT_EQUAL(1, count(json, "\"name\":\"unicast to 1\""));
+		CPPUNIT_ASSERT_EQUAL(1, count(json, "\"cancelled\":true"));
+		CPPUNIT_ASSERT_EQUAL(2, count(json, "\"cat\":\"collision\""));
+
+		// one busy period from 0 to 0.1s
+		CPPUNIT_ASSERT_EQUAL(1, count(json, "\"cat\":\"channel\""));
+		CPPUNIT_ASSERT_EQUAL(1, count(json, "\"dur\":100000.000}"));
+
+		CPPUNIT_ASSERT_EQUAL(1, count(json, "\"cat\":\"delivery\""));
+	}
+
+	void
+	ChromeTraceTest::escapedNames()
+	{
+		// wire name: a"b\c plus a tab
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Wire, ChromeTrace\n"
+				"wire = Wire('a\"b\\\\c\\t', chromeTrace = ChromeTrace('chromeTraceTest.json'))\n"
+				);
+
+		{
+			Wire wire(config.get<wns::pyconfig::View>("wire"));
+		}
+
+		std::ifstream in("chromeTraceTest.json");
+		std::stringstream ss;
+		ss << in.rdbuf();
+		std::string json = ss.str();
+
+		CPPUNIT_ASSERT_EQUAL(1, count(json, "\"name\":\"a\\\"b\\\\c\\u0009\"}"));
+	}
+
+} // tests
+} // copper
@@ -0,0 +1,142 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#include <COPPER/LatencyHistogram.hpp>
+
+#include <WNS/CppUnit.hpp>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace copper { namespace tests {
+
+	/**
+	 * @brief Test for copper::LatencyHistogram
+	 */
+	class LatencyHistogramTest :
+		public wns::TestFixture
+	{
+		CPPUNIT_TEST_SUITE( LatencyHistogramTest );
+		CPPUNIT_TEST( linearRange );
+		CPPUNIT_TEST( precision );
+		CPPUNIT_TEST( overflow );
+		CPPUNIT_TEST( merge );
+		CPPUNIT_TEST_SUITE_END();
+	public:
+		void prepare();
+		void cleanup();
+		void linearRange();
+		void precision();
+		void overflow();
+		void merge();
+	};
+
+	CPPUNIT_TEST_SUITE_REGISTRATION( LatencyHistogramTest );
+
+	void
+	LatencyHistogramTest::prepare()
+	{
+	}
+
+	void
+	LatencyHistogramTest::cleanup()
+	{
+	}
+
+	void
+	LatencyHistogramTest::linearRange()
+	{
+		// 128 exact buckets of 1us
+		LatencyHistogram h(1E-6, 1.0, 7);
+
+		h.put(1E-6);
+		h.put(2E-6);
+		h.put(3E-6);
+		h.put(4E-6);
+
+		CPPUNIT_ASSERT_EQUAL(4ul, h.getCount());
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(2E-6, h.getPercentile(50.0), 1E-12);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(4E-6, h.getPercentile(100.0), 1E-12);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(2.5E-6, h.getMean(), 1E-12);
+	}
+
+	void
+	LatencyHistogramTest::precision()
+	{
+		LatencyHistogram h(1E-9, 10.0, 7);
+
+		for (int ii = 1; ii <= 1000; ++ii)
+		{
+			h.put(ii * 1E-3);
+		}
+
+		// relative error <= 2^-6
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(0.5), h.getPercentile(50.0), 1.0/64);
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(0.99), h.getPercentile(99.0), 1.0/64);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, h.getPercentile(100.0), 1E-12);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, h.getMax(), 1E-12);
+
+		// fixed memory
+		size_t buckets = h.getNumberOfBuckets();
+		h.put(5.0);
+		CPPUNIT_ASSERT_EQUAL(buckets, h.getNumberOfBuckets());
+	}
+
+	void
+	LatencyHistogramTest::overflow()
+	{
+		LatencyHistogram h(1E-6, 1.0, 4);
+
+		h.put(0.5);
+		h.put(100.0);
+
+		CPPUNIT_ASSERT_EQUAL(2ul, h.getCount());
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(100.0, h.getPercentile(100.0), 1E-12);
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(0.5), h.getPercentile(50.0), 1.0/8);
+	}
+
+	void
+	LatencyHistogramTest::merge()
+	{
+		LatencyHistogram h1(1E-6, 1.0, 7);
+		LatencyHistogram h2(1E-6, 1.0, 7);
+
+		h1.put(1E-6);
+		h2.put(3E-6);
+		h2.put(5E-6);
+		h1.merge(h2);
+
+		CPPUNIT_ASSERT_EQUAL(3ul, h1.getCount());
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(3E-6, h1.getPercentile(50.0), 1E-12);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(5E-6, h1.getMax(), 1E-12);
+
+		LatencyHistogram other(1E-3, 1.0, 7);
+		CPPUNIT_ASSERT_THROW( h1.merge(other), wns::Exception );
+	}
+
+} // tests
+} // copper
@@ -0,0 +1,169 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+// frame messages are compiled in and detail messages are stripped,
+// whatever level the library is built with
+#undef COPPER_LOG_LEVEL
+#define COPPER_LOG_LEVEL 2
+
+#include <COPPER/Logging.hpp>
+#include <COPPER/tests/BenchmarkReport.hpp>
+
+#include <WNS/pyconfig/helper/Functions.hpp>
+#include <WNS/CppUnit.hpp>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace copper { namespace tests {
+
+	/**
+	 * @brief Cost of the copper messages if the logger is disabled at
+	 * run time or the message is stripped at compile time
+	 *
+	 * Each benchmark runs the same loop body (a volatile counter and a
+	 * message with two values), the baseline has no message. The
+	 * disabled logger is measured with COPPER_FRAME_MESSAGE, the
+	 * stripped message with COPPER_DETAIL_MESSAGE on an enabled logger.
+	 * Neither may evaluate the message.
+	 */
+	class LoggingPerformanceTest :
+		public wns::TestFixture
+	{
+		CPPUNIT_TEST_SUITE( LoggingPerformanceTest );
+		CPPUNIT_TEST( baseline );
+		CPPUNIT_TEST( disabledLogger );
+		CPPUNIT_TEST( stripped );
+		CPPUNIT_TEST_SUITE_END();
+	public:
+		void prepare();
+		void cleanup();
+		void baseline();
+		void disabledLogger();
+		void stripped();
+
+	private:
+		static const unsigned long iterations = 100000000;
+
+		/**
+		 * @brief Counts its calls, used in the messages
+		 */
+		unsigned long
+		evaluate(unsigned long value);
+
+		wns::logger::Logger* logger;
+
+		wns::logger::Logger* enabledLogger;
+
+		volatile unsigned long counter;
+
+		unsigned long evaluated;
+	};
+
+	CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( LoggingPerformanceTest, wns::testsuite::Performance() );
+
+	const unsigned long LoggingPerformanceTest::iterations;
+
+	void
+	LoggingPerformanceTest::prepare()
+	{
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Logger\n"
+				"logger = Logger('LoggingPerformanceTest', False)\n"
+				"enabledLogger = Logger('LoggingPerformanceTest', True)\n"
+				);
+		logger = new wns::logger::Logger(config.get("logger"));
+		enabledLogger = new wns::logger::Logger(config.get("enabledLogger"));
+		counter = 0;
+		evaluated = 0;
+	}
+
+	void
+	LoggingPerformanceTest::cleanup()
+	{
+		delete logger;
+		delete enabledLogger;
+	}
+
+	unsigned long
+	LoggingPerformanceTest::evaluate(unsigned long value)
+	{
+		++evaluated;
+		return value;
+	}
+
+	void
+	LoggingPerformanceTest::baseline()
+	{
+		Stopwatch watch;
+		for (unsigned long ii = 0; ii < iterations; ++ii)
+		{
+			++counter;
+		}
+		watch.stop();
+
+		CPPUNIT_ASSERT_EQUAL(iterations, static_cast<unsigned long>(counter));
+		BenchmarkReport::getInstance().add(
+			"logging.baseline", "level", COPPER_LOG_LEVEL, iterations, watch.getSeconds());
+	}
+
+	void
+	LoggingPerformanceTest::disabledLogger()
+	{
+		Stopwatch watch;
+		for (unsigned long ii = 0; ii < iterations; ++ii)
+		{
+			++counter;
+			COPPER_FRAME_MESSAGE(NORMAL, *logger, "iteration " << evaluate(ii) << " counter " << counter);
+		}
+		watch.stop();
+
+		CPPUNIT_ASSERT_EQUAL(iterations, static_cast<unsigned long>(counter));
+		CPPUNIT_ASSERT_EQUAL(0ul, evaluated);
+		BenchmarkReport::getInstance().add(
+			"logging.disabledLogger", "level", COPPER_LOG_LEVEL, iterations, watch.getSeconds());
+	}
+
+	void
+	LoggingPerformanceTest::stripped()
+	{
+		Stopwatch watch;
+		for (unsigned long ii = 0; ii < iterations; ++ii)
+		{
+			++counter;
+			COPPER_DETAIL_MESSAGE(NORMAL, *enabledLogger, "iteration " << evaluate(ii) << " counter " << counter);
+		}
+		watch.stop();
+
+		CPPUNIT_ASSERT_EQUAL(iterations, static_cast<unsigned long>(counter));
+		CPPUNIT_ASSERT_EQUAL(0ul, evaluated);
+		BenchmarkReport::getInstance().add(
+			"logging.stripped", "level", COPPER_LOG_LEVEL, iterations, watch.getSeconds());
+	}
+
+} // tests
+} // copper
@@ -0,0 +1,254 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#include <COPPER/PcapCapture.hpp>
+#include <COPPER/Wire.hpp>
+#include <COPPER/tests/TransmitterDataSentMock.hpp>
+#include <COPPER/tests/ReceiverMock.hpp>
+
+#include <WNS/pyconfig/helper/Functions.hpp>
+#include <WNS/ldk/helper/FakePDU.hpp>
+#include <WNS/CppUnit.hpp>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <cstdio>
+#include <fstream>
+
+namespace copper { namespace tests {
+
+	/**
+	 * @brief Test for copper::PcapCapture
+	 */
+	class PcapCaptureTest :
+		public wns::TestFixture
+	{
+		CPPUNIT_TEST_SUITE( PcapCaptureTest );
+		CPPUNIT_TEST( wireActivity );
+		CPPUNIT_TEST( payload );
+		CPPUNIT_TEST_SUITE_END();
+	public:
+		void prepare();
+		void cleanup();
+		void wireActivity();
+		void payload();
+
+	private:
+		/**
+		 * @brief FakePDU with content
+		 */
+		class BytePDU :
+			public wns::ldk::helper::FakePDU,
+			public PcapSerializable
+		{
+		public:
+			BytePDU(Bit length, uint8_t _value) :
+				wns::ldk::helper::FakePDU(length),
+				value(_value)
+			{
+			}
+
+			virtual void
+			serialize(std::vector<uint8_t>& bytes) const
+			{
+				bytes.insert(bytes.end(), 4, this->value);
+			}
+
+		private:
+			uint8_t value;
+		};
+
+		struct Packet
+		{
+			uint32_t seconds;
+			uint32_t nanoseconds;
+			uint32_t capturedLength;
+			uint32_t originalLength;
+			PcapPacketHeader header;
+		};
+
+		/**
+		 * @brief Reads the next packet, skips the payload
+		 */
+		static bool
+		read(std::ifstream& file, Packet& p, std::vector<uint8_t>& payload);
+
+		TransmitterDataSentMock* transmitter;
+	};
+
+	CPPUNIT_TEST_SUITE_REGISTRATION( PcapCaptureTest );
+
+	void
+	PcapCaptureTest::prepare()
+	{
+		wns::simulator::getEventScheduler()->reset();
+		transmitter = new TransmitterDataSentMock();
+	}
+
+	void
+	PcapCaptureTest::cleanup()
+	{
+		delete transmitter;
+		std::remove("pcapCaptureTest.pcap");
+	}
+
+	bool
+	PcapCaptureTest::read(std::ifstream& file, Packet& p, std::vector<uint8_t>& payload)
+	{
+		if (!file.read(reinterpret_cast<char*>(&p), sizeof(p)))
+		{
+			return false;
+		}
+		payload.resize(p.capturedLength - sizeof(PcapPacketHeader));
+		if (!payload.empty())
+		{
+			file.read(reinterpret_cast<char*>(&payload[0]), payload.size());
+		}
+		return true;
+	}
+
+	void
+	PcapCaptureTest::wireActivity()
+	{
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Wire, PcapCapture\n"
+				"wire = Wire('capturedWire', pcap = PcapCapture('pcapCaptureTest.pcap'))\n"
+				);
+
+		{
+			Wire wire(config.get<wns::pyconfig::View>("wire"));
+			ReceiverMock receiver(wns::service::dll::UnicastAddress(1));
+			wire.addReceiver(&receiver, wns::service::dll::UnicastAddress(1), true);
+
+			wire.sendData(
+				UnicastTransmissionPtr(
+					new UnicastTransmission(
+						wns::service::dll::UnicastAddress(1),
+						wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)),
+						transmitter)),
+				0.1);
+			wns::simulator::getEventScheduler()->processOneEvent();
+
+			// cancelled, not captured
+			wns::osi::PDUPtr cancelled(new wns::ldk::helper::FakePDU(300));
+			wire.sendData(BroadcastTransmissionPtr(new BroadcastTransmission(cancelled, transmitter)), 0.1);
+			wire.stopTransmission(cancelled);
+
+			wire.sendData(
+				BroadcastTransmissionPtr(
+					new BroadcastTransmission(
+						wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(200)),
+						transmitter)),
+				1.25);
+			wns::simulator::getEventScheduler()->processOneEvent();
+
+			CPPUNIT_ASSERT_EQUAL( 2UL, wire.getPcapCapture()->getNumberOfPackets() );
+		}
+
+		std::ifstream file("pcapCaptureTest.pcap", std::ios::binary);
+		uint32_t fileHeader[6];
+		CPPUNIT_ASSERT( file.read(reinterpret_cast<char*>(fileHeader), sizeof(fileHeader)) );
+		CPPUNIT_ASSERT_EQUAL( PcapCapture::magic, fileHeader[0] );
+		CPPUNIT_ASSERT_EQUAL( 65535u, fileHeader[4] );
+		CPPUNIT_ASSERT_EQUAL( PcapCapture::linkType, fileHeader[5] );
+
+		Packet p;
+		std::vector<uint8_t> payload;
+		CPPUNIT_ASSERT( read(file, p, payload) );
+		CPPUNIT_ASSERT_EQUAL( 0u, p.seconds );
+		CPPUNIT_ASSERT_EQUAL( 100000000u, p.nanoseconds );
+		CPPUNIT_ASSERT_EQUAL( static_cast<uint32_t>(sizeof(PcapPacketHeader)), p.capturedLength );
+		CPPUNIT_ASSERT_EQUAL( static_cast<uint32_t>(sizeof(PcapPacketHeader) + 13), p.originalLength );
+		CPPUNIT_ASSERT_EQUAL( 1, p.header.target );
+		CPPUNIT_ASSERT_EQUAL( static_cast<int>(PcapPacketHeader::Unicast), static_cast<int>(p.header.type) );
+		CPPUNIT_ASSERT_EQUAL( 100u, p.header.length );
+		CPPUNIT_ASSERT_EQUAL( 0, static_cast<int>(p.header.collision) );
+		CPPUNIT_ASSERT_EQUAL( 1, static_cast<int>(p.header.pdus) );
+
+		CPPUNIT_ASSERT( read(file, p, payload) );
+		CPPUNIT_ASSERT_EQUAL( 1u, p.seconds );
+		CPPUNIT_ASSERT_EQUAL( 350000000u, p.nanoseconds );
+		CPPUNIT_ASSERT_EQUAL( -1, p.header.target );
+		CPPUNIT_ASSERT_EQUAL( 200u, p.header.length );
+		CPPUNIT_ASSERT_EQUAL( 0u, p.header.sender );
+
+		CPPUNIT_ASSERT( !read(file, p, payload) );
+	}
+
+	void
+	PcapCaptureTest::payload()
+	{
+		{
+			PcapCapture pcap("pcapCaptureTest.pcap", 0, true, sizeof(PcapPacketHeader) + 6, 0);
+
+			BroadcastTransmissionPtr bt(
+				new BroadcastTransmission(wns::osi::PDUPtr(new BytePDU(32, 0xaa)), transmitter));
+			pcap.capture(bt, PcapPacketHeader::Broadcast, -1);
+
+			// burst, truncated to the snap length
+			bt = BroadcastTransmissionPtr(
+				new BroadcastTransmission(wns::osi::PDUPtr(new BytePDU(32, 0x01)), transmitter));
+			bt->burst.push_back(wns::osi::PDUPtr(new BytePDU(32, 0x02)));
+			bt->collision = true;
+			pcap.capture(bt, PcapPacketHeader::Broadcast, -1);
+
+			// 4 Bytes serialized, truncated to the 2 Bytes of the PDU
+			MulticastTransmissionPtr mt(
+				new MulticastTransmission(3, wns::osi::PDUPtr(new BytePDU(16, 0x03)), transmitter));
+			pcap.capture(mt, PcapPacketHeader::Multicast, 3);
+		}
+
+		std::ifstream file("pcapCaptureTest.pcap", std::ios::binary);
+		file.seekg(24);
+
+		Packet p;
+		std::vector<uint8_t> payload;
+		CPPUNIT_ASSERT( read(file, p, payload) );
+		CPPUNIT_ASSERT_EQUAL( static_cast<size_t>(4), payload.size() );
+		CPPUNIT_ASSERT_EQUAL( 0xaa, static_cast<int>(payload[0]) );
+
+		CPPUNIT_ASSERT( read(file, p, payload) );
+		CPPUNIT_ASSERT_EQUAL( static_cast<size_t>(6), payload.size() );
+		CPPUNIT_ASSERT_EQUAL( static_cast<uint32_t>(sizeof(PcapPacketHeader) + 8), p.originalLength );
+		CPPUNIT_ASSERT_EQUAL( 0x01, static_cast<int>(payload[3]) );
+		CPPUNIT_ASSERT_EQUAL( 0x02, static_cast<int>(payload[4]) );
+		CPPUNIT_ASSERT_EQUAL( 1, static_cast<int>(p.header.collision) );
+		CPPUNIT_ASSERT_EQUAL( 2, static_cast<int>(p.header.pdus) );
+
+		CPPUNIT_ASSERT( read(file, p, payload) );
+		CPPUNIT_ASSERT_EQUAL( static_cast<size_t>(2), payload.size() );
+		CPPUNIT_ASSERT_EQUAL( static_cast<uint32_t>(sizeof(PcapPacketHeader) + 2), p.originalLength );
+		CPPUNIT_ASSERT_EQUAL( static_cast<int>(PcapPacketHeader::Multicast), static_cast<int>(p.header.type) );
+		CPPUNIT_ASSERT_EQUAL( 3, p.header.target );
+
+		CPPUNIT_ASSERT( !read(file, p, payload) );
+	}
+
+} // tests
+} // copper
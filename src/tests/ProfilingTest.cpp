@@ -0,0 +1,111 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include <COPPER/Profiling.hpp>
+
+#include <WNS/CppUnit.hpp>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace copper { namespace tests {
+
+	/**
+	 * @brief Test for copper::profiling
+	 */
+	class ProfilingTest :
+		public wns::TestFixture
+	{
+		CPPUNIT_TEST_SUITE( ProfilingTest );
+		CPPUNIT_TEST( registerScope );
+		CPPUNIT_TEST( scope );
+		CPPUNIT_TEST( macro );
+		CPPUNIT_TEST_SUITE_END();
+	public:
+		void prepare();
+		void cleanup();
+		void registerScope();
+		void scope();
+		void macro();
+	};
+
+	CPPUNIT_TEST_SUITE_REGISTRATION( ProfilingTest );
+
+	void
+	ProfilingTest::prepare()
+	{
+		profiling::Profiler::reset();
+	}
+
+	void
+	ProfilingTest::cleanup()
+	{
+		profiling::Profiler::reset();
+	}
+
+	void
+	ProfilingTest::registerScope()
+	{
+		unsigned int a = profiling::Profiler::registerScope("ProfilingTest::a");
+		unsigned int b = profiling::Profiler::registerScope("ProfilingTest::b");
+		CPPUNIT_ASSERT( a != b );
+		CPPUNIT_ASSERT_EQUAL(a, profiling::Profiler::registerScope("ProfilingTest::a"));
+		CPPUNIT_ASSERT_EQUAL(std::string("ProfilingTest::b"), profiling::Profiler::getName(b));
+	}
+
+	void
+	ProfilingTest::scope()
+	{
+		unsigned int id = profiling::Profiler::registerScope("ProfilingTest::scope");
+		for (int ii = 0; ii < 3; ++ii)
+		{
+			profiling::Scope s(id);
+			CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(ii), profiling::Profiler::getCounter(id).calls);
+		}
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(3), profiling::Profiler::getCounter(id).calls);
+
+		profiling::Profiler::reset();
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0), profiling::Profiler::getCounter(id).calls);
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0), profiling::Profiler::getCounter(id).cycles);
+	}
+
+	void
+	ProfilingTest::macro()
+	{
+		{
+			COPPER_PROFILE_SCOPE("ProfilingTest::macro");
+		}
+		unsigned int id = profiling::Profiler::registerScope("ProfilingTest::macro");
+#ifdef COPPER_PROFILING
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(1), profiling::Profiler::getCounter(id).calls);
+#else
+		// compiled to nothing
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0), profiling::Profiler::getCounter(id).calls);
+#endif
+	}
+
+} // tests
+} // copper
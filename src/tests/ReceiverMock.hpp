@@ -47,7 +47,8 @@ namespace copper { namespace tests {
 			pdu(),
 			cOnCollision(0),
 			collision(false),
-			unicastAddress(ua)
+			unicastAddress(ua),
+			lastChannel(0)
 		{}
 
 		bool onData(const UnicastTransmissionPtr& _transmission)
@@ -66,20 +67,29 @@ namespace copper { namespace tests {
 			collision = _transmission->collision;
 			return true;
 		}
+		bool onData(const MulticastTransmissionPtr& _transmission)
+		{
+			pdu = _transmission->pdu;
+			collision = _transmission->collision;
+			return true;
+		}
 
-		void onCopperFree()
+		void onCopperFree(ChannelId channel)
 		{
 			++cOnCopperFree;
+			lastChannel = channel;
 		}
 
-		void onCopperBusy()
+		void onCopperBusy(ChannelId channel)
 		{
 			++cOnCopperBusy;
+			lastChannel = channel;
 		}
 
-		void onCollision()
+		void onCollision(ChannelId channel)
 		{
 			++cOnCollision;
+			lastChannel = channel;
 		}
 
 		int cOnCopperFree;
@@ -88,6 +98,7 @@ namespace copper { namespace tests {
 		int cOnCollision;
 		bool collision;
 		wns::service::dll::UnicastAddress unicastAddress;
+		ChannelId lastChannel;
 	};
 } // tests
 } // copper
@@ -0,0 +1,178 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include <COPPER/Receiver.hpp>
+#include <COPPER/Wire.hpp>
+#include <COPPER/tests/TransmitterDataSentMock.hpp>
+#include <COPPER/tests/BenchmarkReport.hpp>
+
+#include <WNS/pyconfig/helper/Functions.hpp>
+#include <WNS/ldk/helper/FakePDU.hpp>
+#include <WNS/service/phy/copper/Handler.hpp>
+#include <WNS/Observer.hpp>
+#include <WNS/CppUnit.hpp>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace copper { namespace tests {
+
+	/**
+	 * @brief Benchmark of copper::Receiver::onData with different BER
+	 * distributions
+	 */
+	class ReceiverPerformanceTest :
+		public wns::TestFixture
+	{
+		class HandlerMock :
+			public wns::Observer<wns::service::phy::copper::Handler>
+		{
+		public:
+			HandlerMock() :
+				cOnData(0)
+			{}
+
+			virtual void
+			onData(const wns::osi::PDUPtr&, double, bool)
+			{
+				++cOnData;
+			}
+
+			unsigned long cOnData;
+		};
+
+		CPPUNIT_TEST_SUITE( ReceiverPerformanceTest );
+		CPPUNIT_TEST( fixedBER );
+		CPPUNIT_TEST( uniformBER );
+		CPPUNIT_TEST( timeDependentBER );
+		CPPUNIT_TEST_SUITE_END();
+	public:
+		void prepare();
+		void cleanup();
+		void fixedBER();
+		void uniformBER();
+		void timeDependentBER();
+
+	private:
+		/**
+		 * @brief Delivers broadcasts of 1 and 8 PDUs to a receiver
+		 * with the BER distribution created by the Python expression
+		 */
+		void
+		run(const std::string& name, const std::string& ber);
+
+		Wire* wire;
+		TransmitterDataSentMock* transmitter;
+	};
+
+	CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( ReceiverPerformanceTest, wns::testsuite::Performance() );
+
+	void
+	ReceiverPerformanceTest::prepare()
+	{
+		wns::simulator::getEventScheduler()->reset();
+
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Wire\n"
+				"wire = Wire('benchmarkWire')\n"
+				);
+		wire = new Wire(config.get<wns::pyconfig::View>("wire"));
+		transmitter = new TransmitterDataSentMock();
+	}
+
+	void
+	ReceiverPerformanceTest::cleanup()
+	{
+		delete wire;
+		delete transmitter;
+	}
+
+	void
+	ReceiverPerformanceTest::fixedBER()
+	{
+		run("receiver.onData.fixed", "Fixed(1E-5)");
+	}
+
+	void
+	ReceiverPerformanceTest::uniformBER()
+	{
+		run("receiver.onData.uniform", "Uniform(0.6E-5, 1.4E-5)");
+	}
+
+	void
+	ReceiverPerformanceTest::timeDependentBER()
+	{
+		run(
+			"receiver.onData.timeDependent",
+			"TimeDependentDistBER(1E6).getDistribution(10.0, 2, 100, 10, 10)");
+	}
+
+	void
+	ReceiverPerformanceTest::run(const std::string& name, const std::string& ber)
+	{
+		const unsigned long iterations = 1000000;
+
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Receiver\n"
+				"from copper.TimeDependentDistBER import TimeDependentDistBER\n"
+				"from openwns.distribution import Fixed, Uniform\n"
+				"receiver = Receiver(" + ber + ", 0.0, None)\n"
+				);
+		Receiver receiver(config.get("receiver"), wire);
+		HandlerMock handler;
+		handler.startObserving(&receiver);
+		receiver.setDLLUnicastAddress(wns::service::dll::UnicastAddress(1));
+
+		for (unsigned long pdus = 1; pdus <= 8; pdus *= 8)
+		{
+			BroadcastTransmissionPtr bt(
+				new BroadcastTransmission(
+					wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(1000)),
+					transmitter));
+			for (unsigned long ii = 1; ii < pdus; ++ii)
+			{
+				bt->burst.push_back(wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(1000)));
+			}
+
+			handler.cOnData = 0;
+			Stopwatch watch;
+			for (unsigned long ii = 0; ii < iterations; ++ii)
+			{
+				receiver.onData(bt);
+			}
+			watch.stop();
+
+			CPPUNIT_ASSERT_EQUAL(iterations * pdus, handler.cOnData);
+			BenchmarkReport::getInstance().add(name, "pdus", pdus, iterations, watch.getSeconds());
+		}
+
+		handler.stopObserving(&receiver);
+	}
+
+} // tests
+} // copper
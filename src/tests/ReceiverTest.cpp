@@ -34,6 +34,7 @@
 #include <WNS/service/phy/copper/Handler.hpp>
 #include <WNS/service/phy/copper/CarrierSensing.hpp>
 #include <WNS/Observer.hpp>
+#include <WNS/Exception.hpp>
 #include <WNS/CppUnit.hpp>
 #include <WNS/pyconfig/helper/Functions.hpp>
 
@@ -112,7 +113,8 @@ namespace copper { namespace tests {
 			virtual public WireInterface
 		{
 		public:
-			WireMock()
+			WireMock() :
+				carrierSenseInterest(true)
 			{}
 
 			virtual void
@@ -125,37 +127,103 @@ namespace copper { namespace tests {
 			{
 			}
 
+			virtual void
+			sendData(const MulticastTransmissionPtr& /*mt*/, simTimeType /*duration*/)
+			{
+			}
+
 			virtual void
 			stopTransmission(const wns::osi::PDUPtr& /*pdu*/)
 			{
 			}
 
 			virtual simTimeType
-			blockedSince() const
+			blockedSince(ChannelId /*channel*/) const
+			{
+				return -1;
+			}
+
+			virtual simTimeType
+			blockedSinceAt(ChannelId /*channel*/, simTimeType /*t*/) const
 			{
 				return -1;
 			}
 
+			virtual bool
+			isCarrierBusyAt(ChannelId /*channel*/, simTimeType /*t*/, simTimeType /*sensingTime*/) const
+			{
+				return false;
+			}
+
+			virtual ChannelId
+			getNumberOfChannels() const
+			{
+				return 2;
+			}
+
+			virtual TDMAExecutor*
+			getTDMAExecutor() const
+			{
+				return NULL;
+			}
+
+			virtual void
+			wakeupOnIdle(TransmitterDataSentInterface* /*sender*/, ChannelId /*channel*/)
+			{
+			}
+
+			virtual void
+			cancelWakeupOnIdle(TransmitterDataSentInterface* /*sender*/)
+			{
+			}
+
 			virtual void
 			addReceiver(
 				ReceiverInterface* /*r*/,
-				const wns::service::dll::UnicastAddress& /*macAddress*/)
+				const wns::service::dll::UnicastAddress& /*macAddress*/,
+				bool interested)
+			{
+				carrierSenseInterest = interested;
+			}
+
+			virtual void
+			setBroadcastSubscription(ReceiverInterface* /*r*/, bool /*subscribed*/)
 			{}
+
+			virtual void
+			setGroupMembership(GroupId /*group*/, ReceiverInterface* /*r*/, bool /*member*/)
+			{}
+
+			virtual void
+			setCarrierSenseInterest(ReceiverInterface* /*r*/, bool interested)
+			{
+				carrierSenseInterest = interested;
+			}
+
+			bool carrierSenseInterest;
 		};
 
 		CPPUNIT_TEST_SUITE( ReceiverTest );
 		CPPUNIT_TEST( onData );
+		CPPUNIT_TEST( onDataBurst );
 		CPPUNIT_TEST( onCopperFree );
 		CPPUNIT_TEST( onCopperBusy );
 		CPPUNIT_TEST( onCollision );
+		CPPUNIT_TEST( otherChannel );
+		CPPUNIT_TEST( carrierSenseInterest );
+		CPPUNIT_TEST( berPolicy );
 		CPPUNIT_TEST_SUITE_END();
 	public:
 		void prepare();
 		void cleanup();
 		void onData();
+		void onDataBurst();
 		void onCopperFree();
 		void onCopperBusy();
 		void onCollision();
+		void otherChannel();
+		void carrierSenseInterest();
+		void berPolicy();
 
 	private:
 		HandlerMock* handler;
@@ -237,15 +305,31 @@ namespace copper { namespace tests {
 		CPPUNIT_ASSERT( forMe );
 	}
 
+	void
+	ReceiverTest::onDataBurst()
+	{
+		BroadcastTransmissionPtr bt(
+			new BroadcastTransmission(
+				wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)),
+				transmitter));
+		bt->burst.push_back(wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)));
+		bt->burst.push_back(wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)));
+
+		// each PDU of the burst is delivered
+		CPPUNIT_ASSERT( receiver->onData(bt) );
+		CPPUNIT_ASSERT_EQUAL( 3, handler->cOnData );
+		WNS_ASSERT_MAX_REL_ERROR( 0.1, handler->ber, 1E-10);
+	}
+
 	void
 	ReceiverTest::onCopperFree()
 	{
-		receiver->onCopperFree();
+		receiver->onCopperFree(0);
 		wns::events::scheduler::Interface* es = wns::simulator::getEventScheduler();
 		es->processOneEvent();
 		WNS_ASSERT_MAX_REL_ERROR( simTimeType(0.01), es->getTime(), 1E-10);
 		CPPUNIT_ASSERT_EQUAL( 1, carrierSensing->cOnCarrierIdle );
-		receiver->onCopperFree();
+		receiver->onCopperFree(0);
 		es->processOneEvent();
 		WNS_ASSERT_MAX_REL_ERROR( simTimeType(0.02), es->getTime(), 1E-10);
 		CPPUNIT_ASSERT_EQUAL( 2, carrierSensing->cOnCarrierIdle );
@@ -254,12 +338,12 @@ namespace copper { namespace tests {
 	void
 	ReceiverTest::onCopperBusy()
 	{
-		receiver->onCopperBusy();
+		receiver->onCopperBusy(0);
 		wns::events::scheduler::Interface* es = wns::simulator::getEventScheduler();
 		es->processOneEvent();
 		WNS_ASSERT_MAX_REL_ERROR( simTimeType(0.01), es->getTime(), 1E-10);
 		CPPUNIT_ASSERT_EQUAL( 1, carrierSensing->cOnCarrierBusy );
-		receiver->onCopperBusy();
+		receiver->onCopperBusy(0);
 		es->processOneEvent();
 		WNS_ASSERT_MAX_REL_ERROR( simTimeType(0.02), es->getTime(), 1E-10);
 		CPPUNIT_ASSERT_EQUAL( 2, carrierSensing->cOnCarrierBusy );
@@ -268,17 +352,122 @@ namespace copper { namespace tests {
 	void
 	ReceiverTest::onCollision()
 	{
-		receiver->onCollision();
+		receiver->onCollision(0);
 		wns::events::scheduler::Interface* es = wns::simulator::getEventScheduler();
 		es->processOneEvent();
 		WNS_ASSERT_MAX_REL_ERROR( simTimeType(0.01), es->getTime(), 1E-10);
 		CPPUNIT_ASSERT_EQUAL( 1, carrierSensing->cOnCollision );
-		receiver->onCollision();
+		receiver->onCollision(0);
 		es->processOneEvent();
 		WNS_ASSERT_MAX_REL_ERROR( simTimeType(0.02), es->getTime(), 1E-10);
 		CPPUNIT_ASSERT_EQUAL( 2, carrierSensing->cOnCollision );
 	}
 
+	void
+	ReceiverTest::otherChannel()
+	{
+		// receiver listens to channel 0 only
+		BroadcastTransmissionPtr bt(
+			new BroadcastTransmission(
+				wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)),
+				transmitter,
+				1));
+		CPPUNIT_ASSERT( !receiver->onData(bt) );
+
+		UnicastTransmissionPtr ut(
+			new UnicastTransmission(
+				wns::service::dll::UnicastAddress(1),
+				wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)),
+				transmitter,
+				1));
+		CPPUNIT_ASSERT( !receiver->onData(ut) );
+		CPPUNIT_ASSERT_EQUAL( 0, handler->cOnData );
+
+		receiver->onCopperBusy(1);
+		receiver->onCopperFree(1);
+		receiver->onCollision(1);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT_EQUAL( 0, carrierSensing->cOnCarrierBusy );
+		CPPUNIT_ASSERT_EQUAL( 0, carrierSensing->cOnCarrierIdle );
+		CPPUNIT_ASSERT_EQUAL( 0, carrierSensing->cOnCollision );
+
+		// the mock wire has 2 channels
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Receiver\n"
+				"from openwns.distribution import Fixed\n"
+				"receiver = Receiver(Fixed(0.1), 0.01, None, channel = 2)\n"
+				);
+		CPPUNIT_ASSERT_THROW( Receiver(config.get("receiver"), wire), wns::Exception );
+	}
+
+	void
+	ReceiverTest::carrierSenseInterest()
+	{
+		// carrierSensing is attached after the address was set
+		CPPUNIT_ASSERT( wire->carrierSenseInterest );
+
+		carrierSensing->stopObserving(receiver);
+		CPPUNIT_ASSERT( !wire->carrierSenseInterest );
+
+		carrierSensing->startObserving(receiver);
+		CPPUNIT_ASSERT( wire->carrierSenseInterest );
+	}
+
+	void
+	ReceiverTest::berPolicy()
+	{
+		CPPUNIT_ASSERT_EQUAL( Receiver::ConstantPolicy, receiver->getBerPolicy() );
+
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Receiver\n"
+				"from copper.TimeDependentDistBER import TimeDependentDistBER\n"
+				"from openwns.distribution import Uniform\n"
+				"uniform = Receiver(Uniform(1E-4, 2E-4), 0.01, None)\n"
+				"ber = TimeDependentDistBER(1E6)\n"
+				"timeDependent = Receiver(ber.getDistribution(10.0, 2, 100, 10, 10), 0.01, None)\n"
+				"timeDependentLow = 0.6 * ber.getBER(100)\n"
+				"timeDependentHigh = 1.4 * ber.getBER(100)\n"
+				);
+
+		Receiver uniform(config.get("uniform"), wire);
+		CPPUNIT_ASSERT_EQUAL( Receiver::DistributionPolicy, uniform.getBerPolicy() );
+
+		HandlerMock uniformHandler;
+		uniformHandler.startObserving(&uniform);
+		BroadcastTransmissionPtr bt(
+			new BroadcastTransmission(
+				wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)),
+				transmitter));
+		for (int ii = 0; ii < 100; ++ii)
+		{
+			uniform.onData(bt);
+			CPPUNIT_ASSERT( uniformHandler.ber >= 1E-4 );
+			CPPUNIT_ASSERT( uniformHandler.ber <= 2E-4 );
+		}
+		CPPUNIT_ASSERT_EQUAL( 100, uniformHandler.cOnData );
+		uniformHandler.stopObserving(&uniform);
+
+		Receiver timeDependent(config.get("timeDependent"), wire);
+		CPPUNIT_ASSERT_EQUAL( Receiver::DistributionPolicy, timeDependent.getBerPolicy() );
+
+		// the first curve point (distance 100) is drawn at time 0
+		double low = config.get<double>("timeDependentLow");
+		double high = config.get<double>("timeDependentHigh");
+		CPPUNIT_ASSERT( low < high );
+		HandlerMock timeDependentHandler;
+		timeDependentHandler.startObserving(&timeDependent);
+		for (int ii = 0; ii < 100; ++ii)
+		{
+			timeDependent.onData(bt);
+			CPPUNIT_ASSERT( timeDependentHandler.ber >= low );
+			CPPUNIT_ASSERT( timeDependentHandler.ber <= high );
+		}
+		CPPUNIT_ASSERT_EQUAL( 100, timeDependentHandler.cOnData );
+		timeDependentHandler.stopObserving(&timeDependent);
+	}
+
 
 } // tests
 } // copper
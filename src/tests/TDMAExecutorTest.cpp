@@ -0,0 +1,187 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include <COPPER/TDMAExecutor.hpp>
+
+#include <WNS/pyconfig/helper/Functions.hpp>
+#include <WNS/events/NoOp.hpp>
+#include <WNS/CppUnit.hpp>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace copper { namespace tests {
+
+	/**
+	 * @brief Test for copper::TDMAExecutor
+	 */
+	class TDMAExecutorTest :
+		public wns::TestFixture
+	{
+		class StationMock :
+			public TransmitOpportunityInterface
+		{
+		public:
+			StationMock(TDMAExecutor* _executor, int _id) :
+				executor(_executor),
+				id(_id),
+				backlog(0),
+				grants()
+			{}
+
+			virtual void
+			onTransmitOpportunity(simTimeType duration)
+			{
+				WNS_ASSERT_MAX_REL_ERROR( simTimeType(1.0), duration, 1E-10);
+				grants.push_back(wns::simulator::getEventScheduler()->getTime());
+				--backlog;
+				if (backlog == 0)
+				{
+					executor->onIdle(id);
+				}
+			}
+
+			void
+			send(int n)
+			{
+				if (backlog == 0)
+				{
+					executor->onBacklogged(id);
+				}
+				backlog += n;
+			}
+
+			TDMAExecutor* executor;
+			int id;
+			int backlog;
+			std::vector<simTimeType> grants;
+		};
+
+		CPPUNIT_TEST_SUITE( TDMAExecutorTest );
+		CPPUNIT_TEST( grantOwnSlots );
+		CPPUNIT_TEST( noEventsWhenIdle );
+		CPPUNIT_TEST( becomeBackloggedLater );
+		CPPUNIT_TEST( unknownStation );
+		CPPUNIT_TEST_SUITE_END();
+	public:
+		void prepare();
+		void cleanup();
+		void grantOwnSlots();
+		void noEventsWhenIdle();
+		void becomeBackloggedLater();
+		void unknownStation();
+
+	private:
+		TDMAExecutor* executor;
+		StationMock* station1;
+		StationMock* station2;
+	};
+
+	CPPUNIT_TEST_SUITE_REGISTRATION( TDMAExecutorTest );
+
+	void
+	TDMAExecutorTest::prepare()
+	{
+		wns::simulator::getEventScheduler()->reset();
+
+		// frame: station 1, station 2, unused, station 1
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import TDMASchedule\n"
+				"tdma = TDMASchedule(1.0, [1, 2, -1, 1])\n"
+				);
+
+		executor = new TDMAExecutor(config.get("tdma"));
+		station1 = new StationMock(executor, 1);
+		station2 = new StationMock(executor, 2);
+		executor->addStation(1, station1);
+		executor->addStation(2, station2);
+	}
+
+	void
+	TDMAExecutorTest::cleanup()
+	{
+		delete executor;
+		delete station1;
+		delete station2;
+	}
+
+	void
+	TDMAExecutorTest::grantOwnSlots()
+	{
+		station1->send(3);
+		station2->send(1);
+
+		while (station1->backlog > 0 || station2->backlog > 0)
+		{
+			wns::simulator::getEventScheduler()->processOneEvent();
+		}
+
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), station1->grants.size());
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(0.0), station1->grants.at(0), 1E-10);
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(3.0), station1->grants.at(1), 1E-10);
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(4.0), station1->grants.at(2), 1E-10);
+
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), station2->grants.size());
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(1.0), station2->grants.at(0), 1E-10);
+	}
+
+	void
+	TDMAExecutorTest::noEventsWhenIdle()
+	{
+		station2->send(1);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), station2->grants.size());
+
+		// nobody is backlogged, the next event is the NoOp
+		wns::simulator::getEventScheduler()->schedule(wns::events::NoOp(), 100.0);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(100.0), wns::simulator::getEventScheduler()->getTime(), 1E-10);
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), station2->grants.size());
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), station1->grants.size());
+	}
+
+	void
+	TDMAExecutorTest::becomeBackloggedLater()
+	{
+		wns::simulator::getEventScheduler()->schedule(wns::events::NoOp(), 1.5);
+		wns::simulator::getEventScheduler()->processOneEvent();
+
+		// the slot of station 2 in this frame has already started
+		station2->send(1);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(5.0), station2->grants.at(0), 1E-10);
+	}
+
+	void
+	TDMAExecutorTest::unknownStation()
+	{
+		CPPUNIT_ASSERT_THROW( executor->addStation(3, station1), wns::Exception );
+		CPPUNIT_ASSERT_THROW( executor->addStation(1, station1), wns::Exception );
+	}
+
+} // tests
+} // copper
@@ -0,0 +1,143 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include <COPPER/TrafficModel.hpp>
+
+#include <WNS/pyconfig/helper/Functions.hpp>
+#include <WNS/Exception.hpp>
+#include <WNS/CppUnit.hpp>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace copper { namespace tests {
+
+	/**
+	 * @brief Test for copper::TrafficModel
+	 */
+	class TrafficModelTest :
+		public wns::TestFixture
+	{
+		CPPUNIT_TEST_SUITE( TrafficModelTest );
+		CPPUNIT_TEST( cbr );
+		CPPUNIT_TEST( poisson );
+		CPPUNIT_TEST( onOff );
+		CPPUNIT_TEST( config );
+		CPPUNIT_TEST_SUITE_END();
+	public:
+		void prepare();
+		void cleanup();
+		void cbr();
+		void poisson();
+		void onOff();
+		void config();
+	};
+
+	CPPUNIT_TEST_SUITE_REGISTRATION( TrafficModelTest );
+
+	void
+	TrafficModelTest::prepare()
+	{
+	}
+
+	void
+	TrafficModelTest::cleanup()
+	{
+	}
+
+	void
+	TrafficModelTest::cbr()
+	{
+		TrafficModel model(TrafficModel::CBR, 0.1);
+		simTimeType t = model.start(1.0);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, t, 1E-12);
+		t = model.next(t);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(1.1, t, 1E-12);
+		t = model.next(t);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(1.2, t, 1E-12);
+	}
+
+	void
+	TrafficModelTest::poisson()
+	{
+		TrafficModel model(TrafficModel::Poisson, 0.01);
+		const int n = 100000;
+		simTimeType t = model.start(0.0);
+		for (int ii = 0; ii < n; ++ii)
+		{
+			simTimeType next = model.next(t);
+			CPPUNIT_ASSERT( next >= t );
+			t = next;
+		}
+		// mean inter arrival time within 2%
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(0.01, t / n, 0.0002);
+	}
+
+	void
+	TrafficModelTest::onOff()
+	{
+		TrafficModel model(TrafficModel::OnOff, 0.001, 0.1, 0.3);
+		const int n = 100000;
+		int gaps = 0;
+		simTimeType t = model.start(0.0);
+		for (int ii = 0; ii < n; ++ii)
+		{
+			simTimeType next = model.next(t);
+			// inside an on period or a gap (off period)
+			CPPUNIT_ASSERT( next - t > 0.001 - 1E-12 );
+			if (next - t > 0.001 + 1E-12)
+			{
+				++gaps;
+			}
+			t = next;
+		}
+
+		// about 100 PDUs per on period, 25% of the time on
+		CPPUNIT_ASSERT( gaps > 500 );
+		CPPUNIT_ASSERT( gaps < 2000 );
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(n * 0.001 * 4.0, t, n * 0.001 * 0.4);
+	}
+
+	void
+	TrafficModelTest::config()
+	{
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import CBR, OnOff\n"
+				"onOff = OnOff(0.001, 0.1, 0.3)\n"
+				"bogus = CBR(0.1)\n"
+				"bogus.type = 'Bogus'\n"
+				);
+
+		TrafficModel model(config.get("onOff"));
+		CPPUNIT_ASSERT_EQUAL(static_cast<int>(TrafficModel::OnOff), static_cast<int>(model.getType()));
+
+		CPPUNIT_ASSERT_THROW(TrafficModel(config.get("bogus")), wns::Exception);
+		CPPUNIT_ASSERT_THROW(TrafficModel(TrafficModel::CBR, 0.0), wns::Exception);
+	}
+
+} // tests
+} // copper
@@ -0,0 +1,256 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include <COPPER/TrafficSource.hpp>
+#include <COPPER/TrafficSink.hpp>
+#include <COPPER/Wire.hpp>
+#include <COPPER/Transmitter.hpp>
+#include <COPPER/Receiver.hpp>
+
+#include <WNS/node/tests/Stub.hpp>
+#include <WNS/service/phy/copper/Handler.hpp>
+#include <WNS/pyconfig/helper/Functions.hpp>
+#include <WNS/Observer.hpp>
+#include <WNS/CppUnit.hpp>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <vector>
+
+namespace copper { namespace tests {
+
+	/**
+	 * @brief Test for copper::TrafficSource and copper::TrafficSink on
+	 * a Transmitter and a Receiver sharing a wire
+	 */
+	class TrafficSourceTest :
+		public wns::TestFixture
+	{
+		/**
+		 * @brief Records the delivered PDUs (without a reference, the
+		 * source reuses only unreferenced PDUs), keeps a reference to
+		 * the first one if asked to
+		 */
+		class HandlerMock :
+			public wns::Observer<wns::service::phy::copper::Handler>
+		{
+		public:
+			explicit
+			HandlerMock(bool _keepFirst = false) :
+				keepFirst(_keepFirst)
+			{}
+
+			virtual void
+			onData(const wns::osi::PDUPtr& pdu, double, bool)
+			{
+				if (keepFirst && pdus.empty())
+				{
+					first = pdu;
+				}
+				pdus.push_back(pdu.getPtr());
+			}
+
+			bool keepFirst;
+			wns::osi::PDUPtr first;
+			std::vector<const wns::osi::PDU*> pdus;
+		};
+
+		CPPUNIT_TEST_SUITE( TrafficSourceTest );
+		CPPUNIT_TEST( rate );
+		CPPUNIT_TEST( pool );
+		CPPUNIT_TEST( poolInUse );
+		CPPUNIT_TEST( sequence );
+		CPPUNIT_TEST_SUITE_END();
+	public:
+		void prepare();
+		void cleanup();
+		void rate();
+		void pool();
+		void poolInUse();
+		void sequence();
+
+	private:
+		/**
+		 * @brief Runs until the sink received the PDUs
+		 */
+		void
+		runUntilReceived(unsigned long pdus);
+
+		wns::pyconfig::View config;
+		wns::node::tests::Stub* node;
+		Wire* wire;
+		Transmitter* transmitter;
+		Receiver* receiver;
+		TrafficSource* source;
+		TrafficSink* sink;
+	};
+
+	CPPUNIT_TEST_SUITE_REGISTRATION( TrafficSourceTest );
+
+	void
+	TrafficSourceTest::prepare()
+	{
+		wns::simulator::getEventScheduler()->reset();
+
+		// a 1000 Bit PDU every 10ms, 1ms on the wire
+		config =
+			wns::pyconfig::helper::createViewFromString(
+				"from openwns.node import Node\n"
+				"from openwns.distribution import Fixed\n"
+				"from copper.Copper import Wire, Transceiver, TrafficSource, TrafficSink, CBR, TransmitQueue\n"
+				"node = Node('trafficNode')\n"
+				"wire = Wire('trafficWire')\n"
+				"transceiver = Transceiver(node, 'copper', wire, Fixed(0.0), 1E6, queue = TransmitQueue(capacity = 2))\n"
+				"source = TrafficSource(node, 'traffic', transceiver, 1000, CBR(1E-2), target = 1, poolSize = 4)\n"
+				"sink = TrafficSink(node, 'sink', transceiver, address = 1)\n"
+				);
+
+		node = new wns::node::tests::Stub();
+		wire = new Wire(config.get<wns::pyconfig::View>("wire"));
+		transmitter = new Transmitter(config.get("transceiver.transmitter"), wire);
+		receiver = new Receiver(config.get("transceiver.receiver"), wire);
+		node->addService(config.get<std::string>("transceiver.dataTransmission"), transmitter);
+		node->addService(config.get<std::string>("transceiver.notification"), receiver);
+
+		source = new TrafficSource(node, config.get("source"));
+		sink = new TrafficSink(node, config.get("sink"));
+		source->onNodeCreated();
+		sink->onNodeCreated();
+	}
+
+	void
+	TrafficSourceTest::cleanup()
+	{
+		delete sink;
+		delete source;
+		delete receiver;
+		delete transmitter;
+		delete wire;
+		delete node;
+	}
+
+	void
+	TrafficSourceTest::runUntilReceived(unsigned long pdus)
+	{
+		for (int ii = 0; ii < 1000 && sink->getReceived() < pdus; ++ii)
+		{
+			wns::simulator::getEventScheduler()->processOneEvent();
+		}
+	}
+
+	void
+	TrafficSourceTest::rate()
+	{
+		source->onWorldCreated();
+		runUntilReceived(10);
+
+		// the 10th PDU is sent at 90ms and received 1ms later
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(0.091), wns::simulator::getEventScheduler()->getTime(), 1E-9);
+		CPPUNIT_ASSERT_EQUAL(10ul, source->getGenerated());
+		CPPUNIT_ASSERT_EQUAL(0ul, source->getBlocked());
+		CPPUNIT_ASSERT_EQUAL(10ul, sink->getReceived());
+		CPPUNIT_ASSERT_EQUAL(Bit(10000), sink->getReceivedBits());
+		CPPUNIT_ASSERT_EQUAL(0ul, sink->getCollided());
+		CPPUNIT_ASSERT_EQUAL(0ul, sink->getLost());
+		CPPUNIT_ASSERT_EQUAL(0ul, sink->getReordered());
+	}
+
+	void
+	TrafficSourceTest::pool()
+	{
+		HandlerMock handler;
+		handler.startObserving(receiver);
+
+		source->onWorldCreated();
+		runUntilReceived(6);
+
+		// the 4 PDUs of the pool are reused round robin
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(6), handler.pdus.size());
+		CPPUNIT_ASSERT( handler.pdus.at(0) != handler.pdus.at(1) );
+		CPPUNIT_ASSERT( handler.pdus.at(0) == handler.pdus.at(4) );
+		CPPUNIT_ASSERT( handler.pdus.at(1) == handler.pdus.at(5) );
+
+		// the sequence number is set on each reuse
+		const TrafficPDU* tp = dynamic_cast<const TrafficPDU*>(handler.pdus.at(5));
+		CPPUNIT_ASSERT( tp != NULL );
+		CPPUNIT_ASSERT_EQUAL(5ul, tp->sequenceNumber);
+		CPPUNIT_ASSERT( tp->source == source );
+		CPPUNIT_ASSERT_EQUAL(0ul, source->getPoolMisses());
+
+		handler.stopObserving(receiver);
+	}
+
+	void
+	TrafficSourceTest::poolInUse()
+	{
+		HandlerMock handler(true);
+		handler.startObserving(receiver);
+
+		source->onWorldCreated();
+		runUntilReceived(6);
+
+		// the first PDU is still referenced, a new one is sent instead
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(6), handler.pdus.size());
+		CPPUNIT_ASSERT( handler.pdus.at(0) != handler.pdus.at(4) );
+		CPPUNIT_ASSERT( handler.pdus.at(1) == handler.pdus.at(5) );
+		CPPUNIT_ASSERT_EQUAL(1ul, source->getPoolMisses());
+
+		const TrafficPDU* tp = dynamic_cast<const TrafficPDU*>(handler.first.getPtr());
+		CPPUNIT_ASSERT( tp != NULL );
+		CPPUNIT_ASSERT_EQUAL(0ul, tp->sequenceNumber);
+		CPPUNIT_ASSERT_EQUAL(0ul, sink->getLost());
+
+		handler.stopObserving(receiver);
+	}
+
+	void
+	TrafficSourceTest::sequence()
+	{
+		unsigned long sequenceNumbers[] = {0, 1, 3, 2, 6};
+		for (int ii = 0; ii < 5; ++ii)
+		{
+			TrafficPDU* tp = new TrafficPDU(100);
+			tp->source = source;
+			tp->sequenceNumber = sequenceNumbers[ii];
+			sink->onData(wns::osi::PDUPtr(tp), 0.0, false);
+		}
+
+		// 2 arrived after 3, 4 and 5 are missing
+		CPPUNIT_ASSERT_EQUAL(5ul, sink->getReceived());
+		CPPUNIT_ASSERT_EQUAL(1ul, sink->getReordered());
+		CPPUNIT_ASSERT_EQUAL(2ul, sink->getLost());
+
+		// other sources are counted separately
+		TrafficPDU* tp = new TrafficPDU(100);
+		tp->sequenceNumber = 0;
+		sink->onData(wns::osi::PDUPtr(tp), 0.0, false);
+		CPPUNIT_ASSERT_EQUAL(2ul, sink->getLost());
+		CPPUNIT_ASSERT_EQUAL(1ul, sink->getReordered());
+	}
+
+} // tests
+} // copper
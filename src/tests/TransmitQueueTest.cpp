@@ -0,0 +1,170 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#include <COPPER/TransmitQueue.hpp>
+
+#include <WNS/ldk/helper/FakePDU.hpp>
+#include <WNS/CppUnit.hpp>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace copper { namespace tests {
+
+	/**
+	 * @brief Test for copper::TransmitQueue
+	 */
+	class TransmitQueueTest :
+		public wns::TestFixture
+	{
+		CPPUNIT_TEST_SUITE( TransmitQueueTest );
+		CPPUNIT_TEST( fifo );
+		CPPUNIT_TEST( priorities );
+		CPPUNIT_TEST( full );
+		CPPUNIT_TEST( remove );
+		CPPUNIT_TEST_SUITE_END();
+	public:
+		void prepare();
+		void cleanup();
+		void fifo();
+		void priorities();
+		void full();
+		void remove();
+
+	private:
+		PendingTransmission
+		createEntry();
+
+		TransmitQueue* queue;
+	};
+
+	CPPUNIT_TEST_SUITE_REGISTRATION( TransmitQueueTest );
+
+	void
+	TransmitQueueTest::prepare()
+	{
+		queue = new TransmitQueue(2, 3);
+	}
+
+	void
+	TransmitQueueTest::cleanup()
+	{
+		delete queue;
+	}
+
+	PendingTransmission
+	TransmitQueueTest::createEntry()
+	{
+		return PendingTransmission(
+			wns::service::dll::UnicastAddress(1),
+			wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)));
+	}
+
+	void
+	TransmitQueueTest::fifo()
+	{
+		CPPUNIT_ASSERT( queue->empty() );
+
+		// reuse the released slots
+		for (int ii = 0; ii < 5; ++ii)
+		{
+			PendingTransmission first = createEntry();
+			PendingTransmission second = createEntry();
+			CPPUNIT_ASSERT( queue->push(first, 1) );
+			CPPUNIT_ASSERT( queue->push(second, 1) );
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), queue->size());
+
+			CPPUNIT_ASSERT( queue->front().pdu == first.pdu );
+			queue->pop();
+			CPPUNIT_ASSERT( queue->front().pdu == second.pdu );
+			queue->pop();
+			CPPUNIT_ASSERT( queue->empty() );
+		}
+	}
+
+	void
+	TransmitQueueTest::priorities()
+	{
+		PendingTransmission low = createEntry();
+		PendingTransmission high = createEntry();
+
+		queue->push(low, 1);
+		queue->push(high, 0);
+
+		CPPUNIT_ASSERT( queue->front().pdu == high.pdu );
+		queue->pop();
+		CPPUNIT_ASSERT( queue->front().pdu == low.pdu );
+	}
+
+	void
+	TransmitQueueTest::full()
+	{
+		for (int ii = 0; ii < 3; ++ii)
+		{
+			CPPUNIT_ASSERT( queue->push(createEntry(), 0) );
+		}
+
+		CPPUNIT_ASSERT( queue->isFull(0) );
+		CPPUNIT_ASSERT( !queue->push(createEntry(), 0) );
+
+		// the other class is independent
+		CPPUNIT_ASSERT( !queue->isFull(1) );
+		CPPUNIT_ASSERT( queue->push(createEntry(), 1) );
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), queue->size());
+	}
+
+	void
+	TransmitQueueTest::remove()
+	{
+		PendingTransmission first = createEntry();
+		PendingTransmission second = createEntry();
+		PendingTransmission third = createEntry();
+
+		queue->push(first, 0);
+		queue->push(second, 0);
+		queue->push(third, 0);
+
+		CPPUNIT_ASSERT( queue->remove(second.pdu) );
+		CPPUNIT_ASSERT( !queue->remove(second.pdu) );
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), queue->size());
+		CPPUNIT_ASSERT( !queue->isFull(0) );
+
+		// the released slot is reused at the end of the class
+		PendingTransmission fourth = createEntry();
+		CPPUNIT_ASSERT( queue->push(fourth, 0) );
+		CPPUNIT_ASSERT( queue->isFull(0) );
+
+		CPPUNIT_ASSERT( queue->front().pdu == first.pdu );
+		queue->pop();
+		CPPUNIT_ASSERT( queue->front().pdu == third.pdu );
+		CPPUNIT_ASSERT( queue->remove(fourth.pdu) );
+		queue->pop();
+		CPPUNIT_ASSERT( queue->empty() );
+	}
+
+} // tests
+} // copper
@@ -40,17 +40,34 @@ namespace copper { namespace tests {
 	{
 	public:
 		TransmitterDataSentMock() :
-			pdus()
+			pdus(),
+			collisions(0),
+			wireIdle(0)
 		{
 		}
 
 		virtual void
-		onDataSent(wns::osi::PDUPtr pdu)
+		onDataSent(const TransmissionPtr& transmission)
 		{
-			pdus.push_back(pdu);
+			pdus.push_back(transmission->pdu);
+			pdus.insert(pdus.end(), transmission->burst.begin(), transmission->burst.end());
+		}
+
+		virtual void
+		onCollision(const TransmissionPtr& /*transmission*/)
+		{
+			++collisions;
+		}
+
+		virtual void
+		onWireIdle(ChannelId /*channel*/)
+		{
+			++wireIdle;
 		}
 
 		std::vector<wns::osi::PDUPtr> pdus;
+		int collisions;
+		int wireIdle;
 	};
 
 } // tests
@@ -29,6 +29,7 @@
 #include <COPPER/Wire.hpp>
 #include <COPPER/Transmitter.hpp>
 #include <COPPER/tests/ReceiverMock.hpp>
+#include <COPPER/tests/TransmitterDataSentMock.hpp>
 
 #include <WNS/service/phy/copper/Handler.hpp>
 #include <WNS/service/phy/copper/DataTransmissionFeedback.hpp>
@@ -55,7 +56,10 @@ namespace copper { namespace tests {
 				blockedDuration(0.0),
 				cSendUnicast(0),
 				cSendBroadcast(0),
-				cStopTransmission(0)
+				cSendMulticast(0),
+				cStopTransmission(0),
+				cWakeupOnIdle(0),
+				cCancelWakeupOnIdle(0)
 			{}
 
 			virtual void
@@ -70,6 +74,12 @@ namespace copper { namespace tests {
 				++cSendBroadcast;
 			}
 
+			virtual void
+			sendData(const MulticastTransmissionPtr& /*mt*/, simTimeType /*duration*/)
+			{
+				++cSendMulticast;
+			}
+
 			virtual void
 			stopTransmission(const wns::osi::PDUPtr& /*pdu*/)
 			{
@@ -77,21 +87,73 @@ namespace copper { namespace tests {
 			}
 
 			virtual simTimeType
-			blockedSince() const
+			blockedSince(ChannelId /*channel*/) const
+			{
+				return blockedDuration;
+			}
+
+			virtual simTimeType
+			blockedSinceAt(ChannelId /*channel*/, simTimeType /*t*/) const
 			{
 				return blockedDuration;
 			}
 
+			virtual bool
+			isCarrierBusyAt(ChannelId /*channel*/, simTimeType /*t*/, simTimeType /*sensingTime*/) const
+			{
+				return blockedDuration >= 0.0;
+			}
+
+			virtual ChannelId
+			getNumberOfChannels() const
+			{
+				return 1;
+			}
+
+			virtual TDMAExecutor*
+			getTDMAExecutor() const
+			{
+				return NULL;
+			}
+
+			virtual void
+			wakeupOnIdle(TransmitterDataSentInterface* /*sender*/, ChannelId /*channel*/)
+			{
+				++cWakeupOnIdle;
+			}
+
+			virtual void
+			cancelWakeupOnIdle(TransmitterDataSentInterface* /*sender*/)
+			{
+				++cCancelWakeupOnIdle;
+			}
+
 			virtual void
 			addReceiver(
 				ReceiverInterface* /*r*/,
-				const wns::service::dll::UnicastAddress& /*macAddress*/)
+				const wns::service::dll::UnicastAddress& /*macAddress*/,
+				bool /*interested*/)
+			{}
+
+			virtual void
+			setBroadcastSubscription(ReceiverInterface* /*r*/, bool /*subscribed*/)
+			{}
+
+			virtual void
+			setGroupMembership(GroupId /*group*/, ReceiverInterface* /*r*/, bool /*member*/)
+			{}
+
+			virtual void
+			setCarrierSenseInterest(ReceiverInterface* /*r*/, bool /*interested*/)
 			{}
 
 			simTimeType blockedDuration;
 			int cSendUnicast;
 			int cSendBroadcast;
+			int cSendMulticast;
 			int cStopTransmission;
+			int cWakeupOnIdle;
+			int cCancelWakeupOnIdle;
 		};
 
 		class TransmitterFeedbackMock :
@@ -110,24 +172,40 @@ namespace copper { namespace tests {
 		CPPUNIT_TEST_SUITE( TransmitterTest );
 		CPPUNIT_TEST( sendDataUnicast );
 		CPPUNIT_TEST( sendDataBroadcast );
+		CPPUNIT_TEST( sendMulticast );
 		CPPUNIT_TEST( cancelData );
 		CPPUNIT_TEST( sendDataUnicastOnRealWire );
 		CPPUNIT_TEST( sendDataBroadcastOnRealWire );
 		CPPUNIT_TEST( cancelDataOnRealWire );
+		CPPUNIT_TEST( sendBurstOnRealWire );
 		CPPUNIT_TEST( isFree );
 		CPPUNIT_TEST( isFreeDelayedTransmissionDetection );
+		CPPUNIT_TEST( tdma );
+		CPPUNIT_TEST( queue );
+		CPPUNIT_TEST( delayHistogram );
+		CPPUNIT_TEST( csmaQueue );
+		CPPUNIT_TEST( csmaBackoff );
+		CPPUNIT_TEST( deleteWaiting );
 		CPPUNIT_TEST_SUITE_END();
 	public:
 		void prepare();
 		void cleanup();
 		void sendDataUnicast();
 		void sendDataBroadcast();
+		void sendMulticast();
 		void cancelData();
 		void sendDataUnicastOnRealWire();
 		void sendDataBroadcastOnRealWire();
 		void cancelDataOnRealWire();
+		void sendBurstOnRealWire();
 		void isFree();
 		void isFreeDelayedTransmissionDetection();
+		void tdma();
+		void queue();
+		void delayHistogram();
+		void csmaQueue();
+		void csmaBackoff();
+		void deleteWaiting();
 
 	private:
 		WireMock* wire;
@@ -154,7 +232,7 @@ namespace copper { namespace tests {
 
 		realWire = new Wire(config.get<wns::pyconfig::View>("wire"));
 		receiverOnRealWire = new ReceiverMock(wns::service::dll::UnicastAddress(1));
-		realWire->addReceiver(receiverOnRealWire, wns::service::dll::UnicastAddress(1));
+		realWire->addReceiver(receiverOnRealWire, wns::service::dll::UnicastAddress(1), true);
 		transmitterFeedback = new TransmitterFeedbackMock();
 
 		transmitter = new Transmitter(config.get("transmitter"), wire);
@@ -196,6 +274,16 @@ namespace copper { namespace tests {
 		CPPUNIT_ASSERT_EQUAL(1, wire->cSendBroadcast );
 	}
 
+	void
+	TransmitterTest::sendMulticast()
+	{
+		transmitter->sendMulticast(
+			3, wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)));
+
+		CPPUNIT_ASSERT_EQUAL(0, wire->cSendBroadcast );
+		CPPUNIT_ASSERT_EQUAL(1, wire->cSendMulticast );
+	}
+
 	void
 	TransmitterTest::cancelData()
 	{
@@ -234,6 +322,28 @@ namespace copper { namespace tests {
 		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), transmitterFeedback->pdus.size());
 	}
 
+	void
+	TransmitterTest::sendBurstOnRealWire()
+	{
+		wns::simulator::getEventScheduler()->reset();
+
+		PDUContainer pdus;
+		pdus.push_back(wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)));
+		pdus.push_back(wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(200)));
+		pdus.push_back(wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(300)));
+
+		transmitterOnRealWire->sendBurst(wns::service::dll::UnicastAddress(1), pdus);
+
+		// one transmission for the whole burst
+		wns::simulator::getEventScheduler()->processOneEvent();
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(600/1E6), wns::simulator::getEventScheduler()->getTime(), 1E-10);
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), transmitterFeedback->pdus.size());
+		CPPUNIT_ASSERT(transmitterFeedback->pdus.at(0) == pdus.at(0));
+		CPPUNIT_ASSERT(transmitterFeedback->pdus.at(2) == pdus.at(2));
+		CPPUNIT_ASSERT_EQUAL(1, receiverOnRealWire->cOnCopperBusy);
+		CPPUNIT_ASSERT_EQUAL(1, receiverOnRealWire->cOnCopperFree);
+	}
+
 	void
 	TransmitterTest::isFree()
 	{
@@ -275,8 +385,276 @@ namespace copper { namespace tests {
 		CPPUNIT_ASSERT( transmitter->isFree() );
 	}
 
+	void
+	TransmitterTest::tdma()
+	{
+		wns::simulator::getEventScheduler()->reset();
+
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Transmitter, Wire, TDMASchedule\n"
+				"wire = Wire('tdmaWire', tdma = TDMASchedule(1.0, [-1, 1]))\n"
+				"transmitter = Transmitter(1E6, 0.0, None, tdmaStation = 1)\n"
+				);
 
-} // tests
-} // copper
+		Wire tdmaWire(config.get<wns::pyconfig::View>("wire"));
+		ReceiverMock receiver(wns::service::dll::UnicastAddress(1));
+		tdmaWire.addReceiver(&receiver, wns::service::dll::UnicastAddress(1), true);
+
+		Transmitter tdmaTransmitter(config.get("transmitter"), &tdmaWire);
+		TransmitterFeedbackMock feedback;
+		feedback.startObserving(&tdmaTransmitter);
+
+		wns::osi::PDUPtr pdu1(new wns::ldk::helper::FakePDU(100));
+		wns::osi::PDUPtr pdu2(new wns::ldk::helper::FakePDU(100));
+		wns::osi::PDUPtr pdu3(new wns::ldk::helper::FakePDU(100));
+		tdmaTransmitter.sendData(wns::service::dll::UnicastAddress(1), pdu1);
+		tdmaTransmitter.sendData(wns::service::dll::BroadcastAddress(), pdu2);
+		tdmaTransmitter.sendData(wns::service::dll::BroadcastAddress(), pdu3);
+
+		// PDUs are queued, nothing on the wire
+		CPPUNIT_ASSERT( tdmaTransmitter.isFree() );
+		CPPUNIT_ASSERT( tdmaWire.blockedSince() < 0.0 );
 
+		// 2s do not fit into the slot of 1s, dropped when sent
+		tdmaTransmitter.sendData(
+			wns::service::dll::BroadcastAddress(),
+			wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(2000000)));
+		CPPUNIT_ASSERT_EQUAL(1ul, tdmaTransmitter.getDroppedPDUs());
+
+		// queued PDU may be cancelled
+		tdmaTransmitter.cancelData(pdu3);
+
+		// slot 1 starts at 1.0s
+		wns::simulator::getEventScheduler()->processOneEvent();
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(1.0), wns::simulator::getEventScheduler()->getTime(), 1E-10);
+		CPPUNIT_ASSERT( tdmaWire.blockedSince() >= 0.0 );
+
+		// end of transmission
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), feedback.pdus.size());
+		CPPUNIT_ASSERT(receiver.pdu == pdu1);
+
+		// next frame
+		wns::simulator::getEventScheduler()->processOneEvent();
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(3.0), wns::simulator::getEventScheduler()->getTime(), 1E-10);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), feedback.pdus.size());
+		CPPUNIT_ASSERT(receiver.pdu == pdu2);
 
+		feedback.stopObserving(&tdmaTransmitter);
+	}
+
+	void
+	TransmitterTest::queue()
+	{
+		wns::simulator::getEventScheduler()->reset();
+
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Transmitter, TransmitQueue\n"
+				"transmitter = Transmitter(1E6, 0.0, None, queue = TransmitQueue(priorities = 2))\n"
+				);
+
+		Transmitter queueTransmitter(config.get("transmitter"), realWire);
+		TransmitterFeedbackMock feedback;
+		feedback.startObserving(&queueTransmitter);
+
+		wns::osi::PDUPtr pdu1(new wns::ldk::helper::FakePDU(100));
+		wns::osi::PDUPtr pdu2(new wns::ldk::helper::FakePDU(100));
+		wns::osi::PDUPtr pdu3(new wns::ldk::helper::FakePDU(100));
+
+		// wire idle: sent immediately
+		queueTransmitter.setPriority(1);
+		queueTransmitter.sendData(wns::service::dll::UnicastAddress(1), pdu1);
+		queueTransmitter.sendData(wns::service::dll::UnicastAddress(1), pdu2);
+		queueTransmitter.setPriority(0);
+		queueTransmitter.sendData(wns::service::dll::UnicastAddress(1), pdu3);
+		CPPUNIT_ASSERT( queueTransmitter.isFree() );
+
+		// the next PDU is started by the free channel signal, before
+		// the receivers are informed and without an event of its own
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), feedback.pdus.size());
+		CPPUNIT_ASSERT( realWire->blockedSince() >= 0.0 );
+		CPPUNIT_ASSERT_EQUAL(0, receiverOnRealWire->cOnCopperFree);
+
+		// the queue is drained without help of the upper layer, higher
+		// priority first
+		wns::simulator::getEventScheduler()->processOneEvent();
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), feedback.pdus.size());
+		CPPUNIT_ASSERT(feedback.pdus.at(0) == pdu1);
+		CPPUNIT_ASSERT(feedback.pdus.at(1) == pdu3);
+		CPPUNIT_ASSERT(feedback.pdus.at(2) == pdu2);
+		CPPUNIT_ASSERT( realWire->blockedSince() < 0.0 );
+
+		feedback.stopObserving(&queueTransmitter);
+	}
+
+	void
+	TransmitterTest::delayHistogram()
+	{
+		wns::simulator::getEventScheduler()->reset();
+
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Transmitter, TransmitQueue, LatencyHistogram\n"
+				"transmitter = Transmitter(1E6, 0.0, None, queue = TransmitQueue(), delayHistogram = LatencyHistogram())\n"
+				);
+
+		Transmitter histogramTransmitter(config.get("transmitter"), realWire);
+
+		// the second PDU waits for the first one
+		histogramTransmitter.sendData(
+			wns::service::dll::UnicastAddress(1), wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)));
+		histogramTransmitter.sendData(
+			wns::service::dll::UnicastAddress(1), wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)));
+		wns::simulator::getEventScheduler()->processOneEvent();
+		wns::simulator::getEventScheduler()->processOneEvent();
+
+		const LatencyHistogram* accessDelay = histogramTransmitter.getAccessDelayHistogram();
+		const LatencyHistogram* latency = histogramTransmitter.getLatencyHistogram();
+		CPPUNIT_ASSERT_EQUAL(2ul, accessDelay->getCount());
+		CPPUNIT_ASSERT_EQUAL(2ul, latency->getCount());
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(1E-4), accessDelay->getMax(), 1E-9);
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(2E-4), latency->getMax(), 1E-9);
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(1.5E-4), latency->getMean(), 1E-9);
+	}
+
+	void
+	TransmitterTest::csmaQueue()
+	{
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Transmitter, CSMACD, TransmitQueue\n"
+				"transmitter = Transmitter(1E6, 0.0, None, csma = CSMACD(1E-3), queue = TransmitQueue(capacity = 2))\n"
+				);
+		Transmitter csmaTransmitter(config.get("transmitter"), wire);
+
+		// wire busy: the first PDU waits for the wire to get idle
+		wire->blockedDuration = 1.0;
+		wns::osi::PDUPtr pdu1(new wns::ldk::helper::FakePDU(100));
+		csmaTransmitter.sendData(wns::service::dll::UnicastAddress(1), pdu1);
+		CPPUNIT_ASSERT_EQUAL(0, wire->cSendUnicast);
+		CPPUNIT_ASSERT_EQUAL(1, wire->cWakeupOnIdle);
+		CPPUNIT_ASSERT( csmaTransmitter.isFree() );
+
+		// the PDU in contention is not counted
+		csmaTransmitter.sendData(
+			wns::service::dll::UnicastAddress(1), wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)));
+		csmaTransmitter.sendData(
+			wns::service::dll::UnicastAddress(1), wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)));
+		CPPUNIT_ASSERT( !csmaTransmitter.isFree() );
+		CPPUNIT_ASSERT_EQUAL(1, wire->cWakeupOnIdle);
+
+		// queue full
+		csmaTransmitter.sendData(
+			wns::service::dll::UnicastAddress(1), wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)));
+		CPPUNIT_ASSERT_EQUAL(1ul, csmaTransmitter.getDroppedPDUs());
+
+		// wire idle: the head of the queue is transmitted
+		wire->blockedDuration = -1.0;
+		csmaTransmitter.onWireIdle(0);
+		CPPUNIT_ASSERT_EQUAL(1, wire->cSendUnicast);
+
+		// cancelling the PDU in contention stops the transmission, the
+		// next one is started when the wire signals the free channel
+		csmaTransmitter.cancelData(pdu1);
+		CPPUNIT_ASSERT_EQUAL(1, wire->cStopTransmission);
+		CPPUNIT_ASSERT_EQUAL(2, wire->cWakeupOnIdle);
+		CPPUNIT_ASSERT_EQUAL(1, wire->cSendUnicast);
+		csmaTransmitter.onWireIdle(0);
+		CPPUNIT_ASSERT_EQUAL(2, wire->cSendUnicast);
+	}
+
+	void
+	TransmitterTest::csmaBackoff()
+	{
+		wns::simulator::getEventScheduler()->reset();
+
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Transmitter, Wire, CSMACD, LatencyHistogram\n"
+				"wire = Wire('csmaWire')\n"
+				"transmitter = Transmitter(1E6, 1E-5, None, csma = CSMACD(1E-3), delayHistogram = LatencyHistogram())\n"
+				);
+
+		Wire csmaWire(config.get<wns::pyconfig::View>("wire"));
+		ReceiverMock receiver(wns::service::dll::UnicastAddress(1));
+		csmaWire.addReceiver(&receiver, wns::service::dll::UnicastAddress(1), true);
+
+		Transmitter transmitter1(config.get("transmitter"), &csmaWire);
+		Transmitter transmitter2(config.get("transmitter"), &csmaWire);
+		TransmitterFeedbackMock feedback;
+		feedback.startObserving(&transmitter1);
+		feedback.startObserving(&transmitter2);
+
+		// both transmitters sense the wire idle and collide
+		transmitter1.sendData(
+			wns::service::dll::UnicastAddress(1), wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)));
+		transmitter2.sendData(
+			wns::service::dll::UnicastAddress(1), wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)));
+		CPPUNIT_ASSERT_EQUAL(1, receiver.cOnCollision);
+
+		for (int i = 0; i < 1000 && wns::simulator::getEventScheduler()->processOneEvent(); ++i)
+		{
+		}
+
+		// the collided transmissions are aborted after the sensing
+		// time, only the retransmissions are reported
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), feedback.pdus.size());
+		CPPUNIT_ASSERT_EQUAL(0ul, transmitter1.getDroppedPDUs());
+		CPPUNIT_ASSERT_EQUAL(0ul, transmitter2.getDroppedPDUs());
+		CPPUNIT_ASSERT( csmaWire.blockedSince() < 0.0 );
+
+		// the access delay ends with the successful attempt, it
+		// includes at least the sensing time until the abort
+		CPPUNIT_ASSERT_EQUAL(1ul, transmitter1.getAccessDelayHistogram()->getCount());
+		CPPUNIT_ASSERT_EQUAL(1ul, transmitter2.getAccessDelayHistogram()->getCount());
+		CPPUNIT_ASSERT( transmitter1.getAccessDelayHistogram()->getMax() > 0.9E-5 );
+		CPPUNIT_ASSERT( transmitter2.getAccessDelayHistogram()->getMax() > 0.9E-5 );
+
+		feedback.stopObserving(&transmitter1);
+		feedback.stopObserving(&transmitter2);
+	}
+
+	void
+	TransmitterTest::deleteWaiting()
+	{
+		wns::simulator::getEventScheduler()->reset();
+
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Transmitter, Wire, CSMACD, TransmitQueue\n"
+				"wire = Wire('waitingWire')\n"
+				"transmitter = Transmitter(1E6, 0.0, None, csma = CSMACD(1E-3), queue = TransmitQueue())\n"
+				);
+
+		Wire waitingWire(config.get<wns::pyconfig::View>("wire"));
+		ReceiverMock receiver(wns::service::dll::UnicastAddress(1));
+		waitingWire.addReceiver(&receiver, wns::service::dll::UnicastAddress(1), true);
+
+		// wire busy: the transmitter waits for the wire to get idle
+		TransmitterDataSentMock sender;
+		waitingWire.sendData(
+			BroadcastTransmissionPtr(
+				new BroadcastTransmission(wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)), &sender)),
+			0.1);
+		Transmitter* waiting = new Transmitter(config.get("transmitter"), &waitingWire);
+		waiting->sendData(
+			wns::service::dll::UnicastAddress(1), wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)));
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), waitingWire.getNumberOfIdleWaiters(0));
+
+		delete waiting;
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), waitingWire.getNumberOfIdleWaiters(0));
+
+		// the channel gets free, nobody is woken up
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT( waitingWire.blockedSince() < 0.0 );
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), sender.pdus.size());
+		CPPUNIT_ASSERT_EQUAL(1, receiver.cOnCopperFree);
+	}
+
+} // tests
+} // copper
@@ -0,0 +1,389 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#include <COPPER/Wire.hpp>
+#include <COPPER/Transmitter.hpp>
+#include <COPPER/Receiver.hpp>
+#include <COPPER/tests/ReceiverMock.hpp>
+#include <COPPER/tests/BenchmarkReport.hpp>
+
+#include <WNS/pyconfig/helper/Functions.hpp>
+#include <WNS/ldk/helper/FakePDU.hpp>
+#include <WNS/CppUnit.hpp>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <vector>
+
+namespace copper { namespace tests {
+
+	/**
+	 * @brief Benchmarks of the hot paths of copper::Wire
+	 *
+	 * Registered in the performance suite, the results are written by
+	 * the BenchmarkReport.
+	 */
+	class WirePerformanceTest :
+		public wns::TestFixture
+	{
+		/**
+		 * @brief Sender that only counts (does not keep the PDUs)
+		 */
+		class CountingSender :
+			virtual public TransmitterDataSentInterface
+		{
+		public:
+			CountingSender() :
+				sent(0),
+				collisions(0)
+			{}
+
+			virtual void
+			onDataSent(const TransmissionPtr& /*transmission*/)
+			{
+				++sent;
+			}
+
+			virtual void
+			onCollision(const TransmissionPtr& /*transmission*/)
+			{
+				++collisions;
+			}
+
+			virtual void
+			onWireIdle(ChannelId /*channel*/)
+			{}
+
+			unsigned long sent;
+			unsigned long collisions;
+		};
+
+		CPPUNIT_TEST_SUITE( WirePerformanceTest );
+		CPPUNIT_TEST( unicastCancel );
+		CPPUNIT_TEST( unicastComplete );
+		CPPUNIT_TEST( broadcastFanOut );
+		CPPUNIT_TEST( broadcastSubscribers );
+		CPPUNIT_TEST( receiverFanOut );
+		CPPUNIT_TEST( collisionBurst );
+		CPPUNIT_TEST( copperFree );
+		CPPUNIT_TEST_SUITE_END();
+	public:
+		void prepare();
+		void cleanup();
+		void unicastCancel();
+		void unicastComplete();
+		void broadcastFanOut();
+		void broadcastSubscribers();
+		void receiverFanOut();
+		void collisionBurst();
+		void copperFree();
+
+	private:
+		/**
+		 * @brief Creates the wire with the given number of receivers
+		 * (MAC addresses 1 to numberOfReceivers)
+		 */
+		void
+		setUpWire(unsigned long numberOfReceivers);
+
+		void
+		tearDownWire();
+
+		Wire* wire;
+		std::vector<ReceiverMock*> receivers;
+		CountingSender* sender;
+		wns::osi::PDUPtr pdu;
+	};
+
+	CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( WirePerformanceTest, wns::testsuite::Performance() );
+
+	void
+	WirePerformanceTest::prepare()
+	{
+		wns::simulator::getEventScheduler()->reset();
+		wire = NULL;
+		sender = new CountingSender();
+		pdu = wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(1000));
+	}
+
+	void
+	WirePerformanceTest::cleanup()
+	{
+		tearDownWire();
+		delete sender;
+		pdu = wns::osi::PDUPtr();
+	}
+
+	void
+	WirePerformanceTest::setUpWire(unsigned long numberOfReceivers)
+	{
+		tearDownWire();
+		wns::simulator::getEventScheduler()->reset();
+
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Wire\n"
+				"wire = Wire('benchmarkWire')\n"
+				);
+		wire = new Wire(config.get<wns::pyconfig::View>("wire"));
+
+		receivers.reserve(numberOfReceivers);
+		for (unsigned long ii = 1; ii <= numberOfReceivers; ++ii)
+		{
+			receivers.push_back(new ReceiverMock(wns::service::dll::UnicastAddress(ii)));
+			wire->addReceiver(receivers.back(), wns::service::dll::UnicastAddress(ii), true);
+		}
+	}
+
+	void
+	WirePerformanceTest::tearDownWire()
+	{
+		delete wire;
+		wire = NULL;
+		for (size_t ii = 0; ii < receivers.size(); ++ii)
+		{
+			delete receivers[ii];
+		}
+		receivers.clear();
+	}
+
+	void
+	WirePerformanceTest::unicastCancel()
+	{
+		const unsigned long iterations = 1000000;
+		setUpWire(2);
+
+		Stopwatch watch;
+		for (unsigned long ii = 0; ii < iterations; ++ii)
+		{
+			wire->sendData(
+				UnicastTransmissionPtr(new UnicastTransmission(wns::service::dll::UnicastAddress(1), pdu, sender)),
+				1E-3);
+			wire->stopTransmission(pdu);
+		}
+		watch.stop();
+
+		CPPUNIT_ASSERT_EQUAL(iterations, wire->getCounters().framesCancelled);
+		BenchmarkReport::getInstance().add(
+			"wire.unicastCancel", "receivers", 2, iterations, watch.getSeconds());
+	}
+
+	void
+	WirePerformanceTest::unicastComplete()
+	{
+		const unsigned long iterations = 1000000;
+		setUpWire(2);
+
+		Stopwatch watch;
+		for (unsigned long ii = 0; ii < iterations; ++ii)
+		{
+			wire->sendData(
+				UnicastTransmissionPtr(new UnicastTransmission(wns::service::dll::UnicastAddress(1), pdu, sender)),
+				1E-3);
+			wns::simulator::getEventScheduler()->processOneEvent();
+		}
+		watch.stop();
+
+		CPPUNIT_ASSERT_EQUAL(iterations, sender->sent);
+		BenchmarkReport::getInstance().add(
+			"wire.unicastComplete", "receivers", 2, iterations, watch.getSeconds());
+	}
+
+	void
+	WirePerformanceTest::broadcastFanOut()
+	{
+		// about 10^7 receiver calls per run
+		for (unsigned long receiverCount = 10; receiverCount <= 100000; receiverCount *= 10)
+		{
+			const unsigned long iterations = 10000000 / receiverCount;
+			setUpWire(receiverCount);
+
+			Stopwatch send;
+			Stopwatch complete;
+			for (unsigned long ii = 0; ii < iterations; ++ii)
+			{
+				send.start();
+				wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu, sender)), 1E-3);
+				send.stop();
+
+				complete.start();
+				wns::simulator::getEventScheduler()->processOneEvent();
+				complete.stop();
+			}
+
+			CPPUNIT_ASSERT_EQUAL(iterations, sender->sent);
+			sender->sent = 0;
+			BenchmarkReport::getInstance().add(
+				"wire.broadcastFanOut.send", "receivers", receiverCount, iterations, send.getSeconds());
+			BenchmarkReport::getInstance().add(
+				"wire.broadcastFanOut.complete", "receivers", receiverCount, iterations, complete.getSeconds());
+		}
+	}
+
+	void
+	WirePerformanceTest::broadcastSubscribers()
+	{
+		// 10^4 receivers, only every n-th subscribed to broadcasts
+		const unsigned long receiverCount = 10000;
+		const unsigned long iterations = 1000;
+		for (unsigned long every = 100; every >= 1; every /= 10)
+		{
+			setUpWire(receiverCount);
+			for (unsigned long ii = 0; ii < receiverCount; ++ii)
+			{
+				if (ii % every != 0)
+				{
+					wire->setBroadcastSubscription(receivers[ii], false);
+				}
+			}
+
+			Stopwatch complete;
+			for (unsigned long ii = 0; ii < iterations; ++ii)
+			{
+				wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu, sender)), 1E-3);
+
+				complete.start();
+				wns::simulator::getEventScheduler()->processOneEvent();
+				complete.stop();
+			}
+
+			CPPUNIT_ASSERT_EQUAL(receiverCount / every, wire->getNumberOfBroadcastSubscribers());
+			BenchmarkReport::getInstance().add(
+				"wire.broadcastSubscribers.complete", "subscribers", receiverCount / every,
+				iterations, complete.getSeconds());
+		}
+	}
+
+	void
+	WirePerformanceTest::receiverFanOut()
+	{
+		// copper::Receivers instead of mocks, includes the BER draw
+		// and the delivery (compare with broadcastFanOut)
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Receiver\n"
+				"from openwns.distribution import Fixed\n"
+				"receiver = Receiver(Fixed(1E-5), 0.0, None)\n"
+				);
+
+		for (unsigned long receiverCount = 10; receiverCount <= 10000; receiverCount *= 10)
+		{
+			const unsigned long iterations = 10000000 / receiverCount;
+			setUpWire(0);
+
+			std::vector<Receiver*> concrete;
+			for (unsigned long ii = 1; ii <= receiverCount; ++ii)
+			{
+				concrete.push_back(new Receiver(config.get("receiver"), wire));
+				concrete.back()->setDLLUnicastAddress(wns::service::dll::UnicastAddress(ii));
+			}
+
+			Stopwatch complete;
+			for (unsigned long ii = 0; ii < iterations; ++ii)
+			{
+				wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu, sender)), 1E-3);
+
+				complete.start();
+				wns::simulator::getEventScheduler()->processOneEvent();
+				complete.stop();
+			}
+
+			CPPUNIT_ASSERT_EQUAL(iterations, sender->sent);
+			sender->sent = 0;
+			BenchmarkReport::getInstance().add(
+				"wire.receiverFanOut.complete", "receivers", receiverCount, iterations, complete.getSeconds());
+
+			tearDownWire();
+			for (size_t ii = 0; ii < concrete.size(); ++ii)
+			{
+				delete concrete[ii];
+			}
+		}
+	}
+
+	void
+	WirePerformanceTest::collisionBurst()
+	{
+		// all transmissions of a burst start at the same time and
+		// collide, the collision check is done for each new transmission
+		for (unsigned long burstSize = 2; burstSize <= 128; burstSize *= 4)
+		{
+			const unsigned long iterations = 1000000 / burstSize;
+			setUpWire(2);
+
+			std::vector<wns::osi::PDUPtr> pdus;
+			for (unsigned long ii = 0; ii < burstSize; ++ii)
+			{
+				pdus.push_back(wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(1000)));
+			}
+
+			Stopwatch watch;
+			for (unsigned long ii = 0; ii < iterations; ++ii)
+			{
+				for (unsigned long jj = 0; jj < burstSize; ++jj)
+				{
+					wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdus[jj], sender)), 1E-3);
+				}
+				while (wns::simulator::getEventScheduler()->processOneEvent())
+				{}
+			}
+			watch.stop();
+
+			CPPUNIT_ASSERT_EQUAL(iterations * (burstSize - 1), wire->getCounters().collisions);
+			BenchmarkReport::getInstance().add(
+				"wire.collisionBurst", "burstSize", burstSize, iterations, watch.getSeconds());
+		}
+	}
+
+	void
+	WirePerformanceTest::copperFree()
+	{
+		// unicast, so the cost is dominated by onCopperBusy and
+		// signalCopperFreeAgainToReceivers
+		for (unsigned long receiverCount = 10; receiverCount <= 100000; receiverCount *= 10)
+		{
+			const unsigned long iterations = 10000000 / receiverCount;
+			setUpWire(receiverCount);
+
+			Stopwatch watch;
+			for (unsigned long ii = 0; ii < iterations; ++ii)
+			{
+				wire->sendData(
+					UnicastTransmissionPtr(new UnicastTransmission(wns::service::dll::UnicastAddress(1), pdu, sender)),
+					1E-3);
+				wns::simulator::getEventScheduler()->processOneEvent();
+			}
+			watch.stop();
+
+			CPPUNIT_ASSERT_EQUAL(static_cast<int>(iterations), receivers.back()->cOnCopperFree);
+			BenchmarkReport::getInstance().add(
+				"wire.copperFree", "receivers", receiverCount, iterations, watch.getSeconds());
+		}
+	}
+
+} // tests
+} // copper
@@ -0,0 +1,124 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#include <COPPER/WireReplay.hpp>
+#include <COPPER/Wire.hpp>
+#include <COPPER/tests/TransmitterDataSentMock.hpp>
+#include <COPPER/tests/ReceiverMock.hpp>
+
+#include <WNS/pyconfig/helper/Functions.hpp>
+#include <WNS/ldk/helper/FakePDU.hpp>
+#include <WNS/CppUnit.hpp>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <cstdio>
+
+namespace copper { namespace tests {
+
+	/**
+	 * @brief Test for copper::WireReplay
+	 */
+	class WireReplayTest :
+		public wns::TestFixture
+	{
+		CPPUNIT_TEST_SUITE( WireReplayTest );
+		CPPUNIT_TEST( replay );
+		CPPUNIT_TEST_SUITE_END();
+	public:
+		void prepare();
+		void cleanup();
+		void replay();
+	};
+
+	CPPUNIT_TEST_SUITE_REGISTRATION( WireReplayTest );
+
+	void
+	WireReplayTest::prepare()
+	{
+		wns::simulator::getEventScheduler()->reset();
+	}
+
+	void
+	WireReplayTest::cleanup()
+	{
+		std::remove("wireReplayTest.bin");
+	}
+
+	void
+	WireReplayTest::replay()
+	{
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Wire, WireTrace\n"
+				"tracedWire = Wire('tracedWire', trace = WireTrace('wireReplayTest.bin'))\n"
+				"wire = Wire('replayedWire')\n"
+				);
+
+		// record: two collided transmissions, one cancelled and a
+		// third one after the wire got free
+		{
+			Wire tracedWire(config.get<wns::pyconfig::View>("tracedWire"));
+			ReceiverMock receiver(wns::service::dll::UnicastAddress(1));
+			tracedWire.addReceiver(&receiver, wns::service::dll::UnicastAddress(1), true);
+			TransmitterDataSentMock sender1;
+			TransmitterDataSentMock sender2;
+
+			wns::osi::PDUPtr pdu1(new wns::ldk::helper::FakePDU(100));
+			wns::osi::PDUPtr pdu2(new wns::ldk::helper::FakePDU(100));
+			tracedWire.sendData(
+				UnicastTransmissionPtr(new UnicastTransmission(wns::service::dll::UnicastAddress(1), pdu1, &sender1)),
+				0.1);
+			tracedWire.sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu2, &sender2)), 0.2);
+			tracedWire.stopTransmission(pdu2);
+			wns::simulator::getEventScheduler()->processOneEvent();
+
+			tracedWire.sendData(
+				BroadcastTransmissionPtr(
+					new BroadcastTransmission(wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)), &sender2)),
+				0.1);
+			wns::simulator::getEventScheduler()->processOneEvent();
+		}
+
+		wns::simulator::getEventScheduler()->reset();
+
+		WireReplay replay(config.get<wns::pyconfig::View>("wire"), "wireReplayTest.bin");
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), replay.getNumberOfFrames());
+
+		ReplayResult result = replay.run();
+		CPPUNIT_ASSERT_EQUAL(3ul, result.frames);
+		CPPUNIT_ASSERT_EQUAL(1ul, result.cancelled);
+		CPPUNIT_ASSERT_EQUAL(2ul, result.completed);
+		CPPUNIT_ASSERT_EQUAL(2ul, result.collisions);
+		// the 2 ends, the starts and the cancel are driven by the replay
+		CPPUNIT_ASSERT_EQUAL(2ul, result.events);
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(0.2), wns::simulator::getEventScheduler()->getTime(), 1E-9);
+	}
+
+} // tests
+} // copper
@@ -28,6 +28,7 @@
 #include <COPPER/Transmission.hpp>
 #include <COPPER/Transceiver.hpp>
 #include <COPPER/Receiver.hpp>
+#include <COPPER/Transmitter.hpp>
 #include <COPPER/Wire.hpp>
 #include <COPPER/tests/TransmitterDataSentMock.hpp>
 #include <COPPER/tests/ReceiverMock.hpp>
@@ -40,6 +41,8 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <algorithm>
+
 namespace  copper { namespace tests {
 
 	class WireTest :
@@ -50,12 +53,27 @@ namespace  copper { namespace tests {
 		CPPUNIT_TEST( collision );
 		CPPUNIT_TEST( blockedSince );
 		CPPUNIT_TEST( blockedSinceDoubleTransmission );
+		CPPUNIT_TEST( blockedSinceAt );
+		CPPUNIT_TEST( carrierBusyAt );
 		CPPUNIT_TEST( onCopperFree );
 		CPPUNIT_TEST( onCopperBusy );
 		CPPUNIT_TEST( sendBroadcastData );
 		CPPUNIT_TEST( cancelBroadcastData );
 		CPPUNIT_TEST( sendUnicastData );
 		CPPUNIT_TEST( cancelUnicastData );
+		CPPUNIT_TEST( multiChannel );
+		CPPUNIT_TEST( slotted );
+		CPPUNIT_TEST( slottedCancel );
+		CPPUNIT_TEST( slottedCancelWhileCompleting );
+		CPPUNIT_TEST( collisionToSenders );
+		CPPUNIT_TEST( wakeupOnIdle );
+		CPPUNIT_TEST( counters );
+		CPPUNIT_TEST( taps );
+		CPPUNIT_TEST( broadcastSubscription );
+		CPPUNIT_TEST( multicast );
+		CPPUNIT_TEST( carrierSenseInterest );
+		CPPUNIT_TEST( duplicateAddress );
+		CPPUNIT_TEST( derivedReceiver );
 		CPPUNIT_TEST_SUITE_END();
 	public:
 		void prepare();
@@ -63,14 +81,121 @@ namespace  copper { namespace tests {
 		void collision();
 		void blockedSince();
 		void blockedSinceDoubleTransmission();
+		void blockedSinceAt();
+		void carrierBusyAt();
 		void onCopperFree();
 		void onCopperBusy();
 		void sendBroadcastData();
 		void cancelBroadcastData();
 		void sendUnicastData();
 		void cancelUnicastData();
+		void multiChannel();
+		void slotted();
+		void slottedCancel();
+		void slottedCancelWhileCompleting();
+		void collisionToSenders();
+		void wakeupOnIdle();
+		void counters();
+		void taps();
+		void broadcastSubscription();
+		void multicast();
+		void carrierSenseInterest();
+		void duplicateAddress();
+		void derivedReceiver();
 
 	private:
+		/**
+		 * @brief Cancels another PDU when its transmission is
+		 * completed
+		 */
+		class CancellingSender :
+			public TransmitterDataSentMock
+		{
+		public:
+			CancellingSender(WireInterface* _wire, const wns::osi::PDUPtr& _cancel) :
+				wire(_wire),
+				cancel(_cancel)
+			{}
+
+			virtual void
+			onDataSent(const TransmissionPtr& transmission)
+			{
+				TransmitterDataSentMock::onDataSent(transmission);
+				wire->stopTransmission(cancel);
+			}
+
+		private:
+			WireInterface* wire;
+			wns::osi::PDUPtr cancel;
+		};
+
+		/**
+		 * @brief Receiver overriding onData, must not be bound
+		 * statically by the wire
+		 */
+		class DerivedReceiver :
+			public Receiver
+		{
+		public:
+			DerivedReceiver(const wns::pyconfig::View& config, WireInterface* wire) :
+				Receiver(config, wire),
+				broadcasts(0)
+			{}
+
+			virtual bool
+			onData(const BroadcastTransmissionPtr& transmission)
+			{
+				++broadcasts;
+				return Receiver::onData(transmission);
+			}
+
+			int broadcasts;
+		};
+
+		/**
+		 * @brief Counts the transmissions seen by a tap
+		 */
+		class TapMock :
+			public WireTap
+		{
+		public:
+			TapMock() :
+				unicasts(0),
+				broadcasts(0),
+				multicasts(0),
+				collided(0)
+			{}
+
+			void
+			onUnicast(const UnicastTransmissionPtr& transmission)
+			{
+				++unicasts;
+				collided += transmission->collision ? 1 : 0;
+			}
+
+			void
+			onBroadcast(const BroadcastTransmissionPtr& transmission)
+			{
+				++broadcasts;
+				collided += transmission->collision ? 1 : 0;
+			}
+
+			void
+			onMulticast(const MulticastTransmissionPtr& transmission)
+			{
+				++multicasts;
+				collided += transmission->collision ? 1 : 0;
+			}
+
+			int unicasts;
+			int broadcasts;
+			int multicasts;
+			int collided;
+		};
+
+		Wire*
+		createSlottedWire();
+
 		WireInterface* wire;
 		ReceiverMock* receiver1;
 		ReceiverMock* receiver2;
@@ -95,8 +220,8 @@ namespace  copper { namespace tests {
 		receiver2 = new ReceiverMock(wns::service::dll::UnicastAddress(2));
 		transmitter = new TransmitterDataSentMock();
 
-		wire->addReceiver(receiver1, wns::service::dll::UnicastAddress(1));
-		wire->addReceiver(receiver2, wns::service::dll::UnicastAddress(2));
+		wire->addReceiver(receiver1, wns::service::dll::UnicastAddress(1), true);
+		wire->addReceiver(receiver2, wns::service::dll::UnicastAddress(2), true);
 	}
 
 	void
@@ -160,6 +285,67 @@ namespace  copper { namespace tests {
 		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), transmitter->pdus.size());
 	}
 
+	void
+	WireTest::blockedSinceAt()
+	{
+		wns::osi::PDUPtr pdu(new wns::ldk::helper::FakePDU(100));
+		wns::osi::PDUPtr pdu2(new wns::ldk::helper::FakePDU(100));
+		simTimeType start = wns::simulator::getEventScheduler()->getTime();
+
+		// busy in [start, start + 0.3)
+		wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu, transmitter)), 0.2);
+		wns::simulator::getEventScheduler()->scheduleDelay(wns::events::NoOp(), 0.1);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu2, transmitter)), 0.2);
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(0.1), wire->blockedSinceAt(0, start + 0.1), 1E-9);
+
+		wns::simulator::getEventScheduler()->processOneEvent();
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT( wire->blockedSince() < 0);
+
+		// free again in [start + 0.3, now]
+		wns::simulator::getEventScheduler()->scheduleDelay(wns::events::NoOp(), 0.1);
+		wns::simulator::getEventScheduler()->processOneEvent();
+
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, wire->blockedSinceAt(0, start), 1E-9);
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(0.25), wire->blockedSinceAt(0, start + 0.25), 1E-9);
+		CPPUNIT_ASSERT( wire->blockedSinceAt(0, start + 0.35) < 0);
+		CPPUNIT_ASSERT( wire->blockedSinceAt(0, wns::simulator::getEventScheduler()->getTime()) < 0);
+		CPPUNIT_ASSERT( wire->blockedSinceAt(0, start - 0.1) < 0);
+	}
+
+	void
+	WireTest::carrierBusyAt()
+	{
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Transmitter, Receiver\n"
+				"from openwns.distribution import Fixed\n"
+				"transmitter = Transmitter(1E6, 0.125, None)\n"
+				"receiver = Receiver(Fixed(0.0), 0.125, None)\n"
+				);
+		Transmitter sensingTransmitter(config.get("transmitter"), wire);
+		Receiver sensingReceiver(config.get("receiver"), wire);
+
+		// busy in [start, start + 0.25), perceived in [start + 0.125, start + 0.375)
+		simTimeType start = wns::simulator::getEventScheduler()->getTime();
+		wns::osi::PDUPtr pdu(new wns::ldk::helper::FakePDU(100));
+		wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu, transmitter)), 0.25);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		wns::simulator::getEventScheduler()->scheduleDelay(wns::events::NoOp(), 0.5);
+		wns::simulator::getEventScheduler()->processOneEvent();
+
+		const simTimeType offsets[] = {-0.125, 0.0, 0.0625, 0.125, 0.25, 0.3125, 0.375, 0.5};
+		const bool busy[] = {false, false, false, true, true, true, false, false};
+		for (size_t ii = 0; ii < sizeof(offsets) / sizeof(offsets[0]); ++ii)
+		{
+			simTimeType t = start + offsets[ii];
+			CPPUNIT_ASSERT_EQUAL( busy[ii], wire->isCarrierBusyAt(0, t, 0.125) );
+			CPPUNIT_ASSERT_EQUAL( busy[ii], sensingTransmitter.isCarrierBusyAt(t) );
+			CPPUNIT_ASSERT_EQUAL( busy[ii], sensingReceiver.isCarrierBusyAt(t) );
+		}
+	}
+
 	void
 	WireTest::onCopperFree()
 	{
@@ -338,7 +524,457 @@ namespace  copper { namespace tests {
 		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), transmitter->pdus.size());
 	}
 
-} // tests
-} // copper
+	void
+	WireTest::multiChannel()
+	{
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Wire\n"
+				"wire = Wire('multiChannelWire', channels = 2)\n"
+				);
+
+		Wire multiChannelWire(config.get<wns::pyconfig::View>("wire"));
+		ReceiverMock receiver(wns::service::dll::UnicastAddress(1));
+		multiChannelWire.addReceiver(&receiver, wns::service::dll::UnicastAddress(1), true);
+		CPPUNIT_ASSERT_EQUAL(static_cast<ChannelId>(2), multiChannelWire.getNumberOfChannels());
+
+		wns::osi::PDUPtr pdu(new wns::ldk::helper::FakePDU(100));
+		wns::osi::PDUPtr pdu2(new wns::ldk::helper::FakePDU(100));
+
+		multiChannelWire.sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu, transmitter, 0)), 0.1);
+		CPPUNIT_ASSERT( multiChannelWire.blockedSince(0) >= 0.0 );
+		CPPUNIT_ASSERT( multiChannelWire.blockedSince(1) < 0.0 );
+
+		// the second channel is free, no collision
+		multiChannelWire.sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu2, transmitter, 1)), 0.2);
+		CPPUNIT_ASSERT( multiChannelWire.blockedSince(1) >= 0.0 );
+		CPPUNIT_ASSERT_EQUAL(2, receiver.cOnCopperBusy);
+		CPPUNIT_ASSERT_EQUAL(0, receiver.cOnCollision);
 
+		// end of transmission on channel 0
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT( multiChannelWire.blockedSince(0) < 0.0 );
+		CPPUNIT_ASSERT( multiChannelWire.blockedSince(1) >= 0.0 );
+		CPPUNIT_ASSERT_EQUAL(1, receiver.cOnCopperFree);
+		CPPUNIT_ASSERT_EQUAL(static_cast<ChannelId>(0), receiver.lastChannel);
+		CPPUNIT_ASSERT(receiver.pdu == pdu);
+		CPPUNIT_ASSERT(receiver.collision == false);
+
+		// end of transmission on channel 1
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT( multiChannelWire.blockedSince(1) < 0.0 );
+		CPPUNIT_ASSERT_EQUAL(2, receiver.cOnCopperFree);
+		CPPUNIT_ASSERT_EQUAL(static_cast<ChannelId>(1), receiver.lastChannel);
+		CPPUNIT_ASSERT(receiver.pdu == pdu2);
+		CPPUNIT_ASSERT(receiver.collision == false);
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), transmitter->pdus.size());
+	}
 
+	Wire*
+	WireTest::createSlottedWire()
+	{
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Wire\n"
+				"wire = Wire('slottedWire', slotDuration = 1.0)\n"
+				);
+
+		Wire* slottedWire = new Wire(config.get<wns::pyconfig::View>("wire"));
+		slottedWire->addReceiver(receiver1, wns::service::dll::UnicastAddress(1), true);
+		slottedWire->addReceiver(receiver2, wns::service::dll::UnicastAddress(2), true);
+		return slottedWire;
+	}
+
+	void
+	WireTest::slotted()
+	{
+		Wire* slottedWire = createSlottedWire();
+
+		wns::osi::PDUPtr pdu(new wns::ldk::helper::FakePDU(100));
+		wns::osi::PDUPtr pdu2(new wns::ldk::helper::FakePDU(100));
+		wns::osi::PDUPtr pdu3(new wns::ldk::helper::FakePDU(100));
+
+		slottedWire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu, transmitter)), 0.1);
+		slottedWire->sendData(
+			UnicastTransmissionPtr(
+				new UnicastTransmission(
+					wns::service::dll::UnicastAddress(1),
+					pdu2,
+					transmitter)), 0.2);
+
+		// only one busy notification per slot, collisions are
+		// resolved at the end of the slot
+		CPPUNIT_ASSERT_EQUAL(1, receiver1->cOnCopperBusy);
+		CPPUNIT_ASSERT_EQUAL(0, receiver1->cOnCollision);
+
+		// a single event completes the slot
+		wns::simulator::getEventScheduler()->processOneEvent();
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(1.0), wns::simulator::getEventScheduler()->getTime(), 1E-10 );
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), transmitter->pdus.size());
+		CPPUNIT_ASSERT(receiver1->pdu == pdu2);
+		CPPUNIT_ASSERT(receiver1->collision == true);
+		CPPUNIT_ASSERT(receiver2->pdu == pdu);
+		CPPUNIT_ASSERT(receiver2->collision == true);
+		CPPUNIT_ASSERT_EQUAL(1, receiver1->cOnCollision);
+		CPPUNIT_ASSERT_EQUAL(1, receiver1->cOnCopperFree);
+		CPPUNIT_ASSERT(slottedWire->blockedSince() < 0.0);
+
+		// started in the middle of the next slot, ends with the slot
+		wns::simulator::getEventScheduler()->scheduleDelay(wns::events::NoOp(), 0.5);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		slottedWire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu3, transmitter)), 0.1);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(2.0), wns::simulator::getEventScheduler()->getTime(), 1E-10 );
+		CPPUNIT_ASSERT(receiver2->pdu == pdu3);
+		CPPUNIT_ASSERT(receiver2->collision == false);
+		CPPUNIT_ASSERT_EQUAL(1, receiver2->cOnCollision);
+
+		// does not fit into the slot
+		CPPUNIT_ASSERT_THROW(
+			slottedWire->sendData(
+				BroadcastTransmissionPtr(
+					new BroadcastTransmission(
+						wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)),
+						transmitter)), 1.5),
+			wns::Exception);
+
+		delete slottedWire;
+	}
+
+	void
+	WireTest::slottedCancel()
+	{
+		Wire* slottedWire = createSlottedWire();
+
+		wns::osi::PDUPtr pdu(new wns::ldk::helper::FakePDU(100));
+		wns::osi::PDUPtr pdu2(new wns::ldk::helper::FakePDU(100));
+
+		slottedWire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu, transmitter)), 0.1);
+		slottedWire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu2, transmitter)), 0.1);
+
+		slottedWire->stopTransmission(pdu);
+		CPPUNIT_ASSERT(slottedWire->blockedSince() >= 0.0);
+
+		// the remaining transmission does not collide
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), transmitter->pdus.size());
+		CPPUNIT_ASSERT(receiver1->pdu == pdu2);
+		CPPUNIT_ASSERT(receiver1->collision == false);
+
+		// cancelling the only transmission removes the slot event
+		slottedWire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu, transmitter)), 0.1);
+		slottedWire->stopTransmission(pdu);
+		CPPUNIT_ASSERT(slottedWire->blockedSince() < 0.0);
+		wns::simulator::getEventScheduler()->scheduleDelay(wns::events::NoOp(), 5.0);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(6.0), wns::simulator::getEventScheduler()->getTime(), 1E-10 );
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), transmitter->pdus.size());
+
+		delete slottedWire;
+	}
+
+	void
+	WireTest::slottedCancelWhileCompleting()
+	{
+		Wire* slottedWire = createSlottedWire();
+
+		wns::osi::PDUPtr pdu(new wns::ldk::helper::FakePDU(100));
+		wns::osi::PDUPtr pdu2(new wns::ldk::helper::FakePDU(100));
+		CancellingSender sender(slottedWire, pdu2);
+
+		// both end with the same slot, completing the first cancels the
+		// second
+		slottedWire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu, &sender)), 0.1);
+		slottedWire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu2, transmitter)), 0.1);
+		wns::simulator::getEventScheduler()->processOneEvent();
+
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), sender.pdus.size());
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), transmitter->pdus.size());
+		CPPUNIT_ASSERT_EQUAL(1ul, slottedWire->getCounters().framesCompleted);
+		CPPUNIT_ASSERT_EQUAL(1ul, slottedWire->getCounters().framesCancelled);
+		CPPUNIT_ASSERT(slottedWire->blockedSince() < 0.0);
+
+		delete slottedWire;
+	}
+
+	void
+	WireTest::collisionToSenders()
+	{
+		wns::osi::PDUPtr pdu(new wns::ldk::helper::FakePDU(100));
+		wns::osi::PDUPtr pdu2(new wns::ldk::helper::FakePDU(100));
+		TransmitterDataSentMock transmitter2;
+
+		wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu, transmitter)), 0.1);
+		CPPUNIT_ASSERT_EQUAL(0, transmitter->collisions);
+
+		// both senders are informed immediately
+		wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu2, &transmitter2)), 0.1);
+		CPPUNIT_ASSERT_EQUAL(1, transmitter->collisions);
+		CPPUNIT_ASSERT_EQUAL(1, transmitter2.collisions);
+
+		wns::simulator::getEventScheduler()->processOneEvent();
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT_EQUAL(1, transmitter->collisions);
+		CPPUNIT_ASSERT_EQUAL(1, transmitter2.collisions);
+	}
+
+	void
+	WireTest::wakeupOnIdle()
+	{
+		wns::osi::PDUPtr pdu(new wns::ldk::helper::FakePDU(100));
+
+		wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu, transmitter)), 0.1);
+		wire->wakeupOnIdle(transmitter, 0);
+
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT_EQUAL(1, transmitter->wireIdle);
+		CPPUNIT_ASSERT_EQUAL(1, receiver1->cOnCopperFree);
+
+		// one-shot registration
+		wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu, transmitter)), 0.1);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT_EQUAL(1, transmitter->wireIdle);
+	}
+
+	void
+	WireTest::counters()
+	{
+		Wire* w = dynamic_cast<Wire*>(wire);
+		CPPUNIT_ASSERT( w != NULL );
+		CPPUNIT_ASSERT( std::find(Wire::getWires().begin(), Wire::getWires().end(), w) != Wire::getWires().end() );
+
+		wns::osi::PDUPtr pdu(new wns::ldk::helper::FakePDU(100));
+		wns::osi::PDUPtr pdu2(new wns::ldk::helper::FakePDU(200));
+		wns::osi::PDUPtr pdu3(new wns::ldk::helper::FakePDU(300));
+
+		wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu, transmitter)), 0.1);
+		wire->sendData(
+			UnicastTransmissionPtr(new UnicastTransmission(wns::service::dll::UnicastAddress(1), pdu2, transmitter)),
+			0.1);
+		wire->stopTransmission(pdu2);
+
+		// both transmissions end at 0.1
+		wns::simulator::getEventScheduler()->processOneEvent();
+
+		wns::simulator::getEventScheduler()->scheduleDelay(wns::events::NoOp(), 0.1);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu3, transmitter)), 0.1);
+
+		WireCounters c = w->getCounters();
+		CPPUNIT_ASSERT_EQUAL(3ul, c.framesStarted);
+		CPPUNIT_ASSERT_EQUAL(1ul, c.framesCompleted);
+		CPPUNIT_ASSERT_EQUAL(1ul, c.framesCancelled);
+		CPPUNIT_ASSERT_EQUAL(1ul, c.collisions);
+		CPPUNIT_ASSERT_EQUAL(2ul, c.peakConcurrentTransmissions);
+		CPPUNIT_ASSERT_EQUAL(200ul, c.unicastBits);
+		CPPUNIT_ASSERT_EQUAL(400ul, c.broadcastBits);
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(0.1), c.busyTime, 1E-9);
+		WNS_ASSERT_MAX_REL_ERROR( simTimeType(0.1), c.idleTime, 1E-9);
+	}
+
+	void
+	WireTest::taps()
+	{
+		Wire* w = dynamic_cast<Wire*>(wire);
+		TapMock tap;
+		w->addTap(&tap);
+
+		wns::osi::PDUPtr pdu(new wns::ldk::helper::FakePDU(100));
+		wns::osi::PDUPtr pdu2(new wns::ldk::helper::FakePDU(200));
+		wns::osi::PDUPtr pdu3(new wns::ldk::helper::FakePDU(300));
+
+		// unicast to receiver 2 is seen by the tap
+		wire->sendData(
+			UnicastTransmissionPtr(new UnicastTransmission(wns::service::dll::UnicastAddress(2), pdu, transmitter)),
+			0.1);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT_EQUAL(1, tap.unicasts);
+		CPPUNIT_ASSERT( receiver2->pdu == pdu );
+		CPPUNIT_ASSERT( receiver1->pdu == wns::osi::PDUPtr() );
+
+		// collided broadcasts are reported, cancelled ones not
+		wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu2, transmitter)), 0.1);
+		wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu3, transmitter)), 0.2);
+		wire->stopTransmission(pdu3);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT_EQUAL(1, tap.broadcasts);
+		CPPUNIT_ASSERT_EQUAL(1, tap.collided);
+
+		w->removeTap(&tap);
+		wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu, transmitter)), 0.1);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT_EQUAL(1, tap.broadcasts);
+	}
+
+	void
+	WireTest::broadcastSubscription()
+	{
+		Wire* w = dynamic_cast<Wire*>(wire);
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), w->getNumberOfBroadcastSubscribers());
+
+		wns::osi::PDUPtr pdu(new wns::ldk::helper::FakePDU(100));
+		wns::osi::PDUPtr pdu2(new wns::ldk::helper::FakePDU(200));
+
+		wire->setBroadcastSubscription(receiver1, false);
+		wire->setBroadcastSubscription(receiver1, false);
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), w->getNumberOfBroadcastSubscribers());
+
+		wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu, transmitter)), 0.1);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT( receiver1->pdu == wns::osi::PDUPtr() );
+		CPPUNIT_ASSERT( receiver2->pdu == pdu );
+
+		// unicasts are still delivered
+		wire->sendData(
+			UnicastTransmissionPtr(new UnicastTransmission(wns::service::dll::UnicastAddress(1), pdu2, transmitter)),
+			0.1);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT( receiver1->pdu == pdu2 );
+
+		wire->setBroadcastSubscription(receiver1, true);
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), w->getNumberOfBroadcastSubscribers());
+		wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu, transmitter)), 0.1);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT( receiver1->pdu == pdu );
+	}
+
+	void
+	WireTest::multicast()
+	{
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Wire\n"
+				"wire = Wire('multicastWire')\n"
+				);
+		Wire multicastWire(config.get<wns::pyconfig::View>("wire"));
+		TapMock tap;
+		multicastWire.addTap(&tap);
+
+		// more receivers than bits per word
+		std::vector<ReceiverMock*> receivers;
+		for (int ii = 0; ii < 40; ++ii)
+		{
+			receivers.push_back(new ReceiverMock(wns::service::dll::UnicastAddress(ii + 1)));
+			multicastWire.addReceiver(receivers.back(), wns::service::dll::UnicastAddress(ii + 1), true);
+		}
+		multicastWire.setGroupMembership(1, receivers[3], true);
+		multicastWire.setGroupMembership(1, receivers[35], true);
+		multicastWire.setGroupMembership(1, receivers[36], true);
+		multicastWire.setGroupMembership(1, receivers[36], false);
+		multicastWire.setGroupMembership(0, receivers[0], true);
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), multicastWire.getNumberOfGroupMembers(1));
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), multicastWire.getNumberOfGroupMembers(7));
+
+		wns::osi::PDUPtr pdu(new wns::ldk::helper::FakePDU(100));
+		multicastWire.sendData(MulticastTransmissionPtr(new MulticastTransmission(1, pdu, transmitter)), 0.1);
+		wns::simulator::getEventScheduler()->processOneEvent();
+
+		for (int ii = 0; ii < 40; ++ii)
+		{
+			bool member = ii == 3 || ii == 35;
+			CPPUNIT_ASSERT_EQUAL( member, receivers[ii]->pdu == pdu );
+		}
+		CPPUNIT_ASSERT_EQUAL(1, tap.multicasts);
+		CPPUNIT_ASSERT_EQUAL(100ul, multicastWire.getCounters().multicastBits);
+
+		// group without members, the wire is still occupied
+		multicastWire.sendData(MulticastTransmissionPtr(new MulticastTransmission(7, pdu, transmitter)), 0.1);
+		CPPUNIT_ASSERT( multicastWire.blockedSince() >= 0.0 );
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT_EQUAL(2, tap.multicasts);
+
+		for (size_t ii = 0; ii < receivers.size(); ++ii)
+		{
+			delete receivers[ii];
+		}
+	}
+
+	void
+	WireTest::carrierSenseInterest()
+	{
+		Wire* w = dynamic_cast<Wire*>(wire);
+		wire->setCarrierSenseInterest(receiver1, false);
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), w->getNumberOfCarrierSenseReceivers());
+
+		// two transmissions: busy, collision and free
+		wns::osi::PDUPtr pdu(new wns::ldk::helper::FakePDU(100));
+		wns::osi::PDUPtr pdu2(new wns::ldk::helper::FakePDU(100));
+		wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu, transmitter)), 0.1);
+		wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu2, transmitter)), 0.1);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		wns::simulator::getEventScheduler()->processOneEvent();
+
+		CPPUNIT_ASSERT_EQUAL(0, receiver1->cOnCopperBusy);
+		CPPUNIT_ASSERT_EQUAL(0, receiver1->cOnCollision);
+		CPPUNIT_ASSERT_EQUAL(0, receiver1->cOnCopperFree);
+		CPPUNIT_ASSERT_EQUAL(1, receiver2->cOnCopperBusy);
+		CPPUNIT_ASSERT_EQUAL(1, receiver2->cOnCollision);
+		CPPUNIT_ASSERT_EQUAL(1, receiver2->cOnCopperFree);
+
+		// data is still delivered
+		CPPUNIT_ASSERT( receiver1->pdu == pdu2 );
+
+		wire->setCarrierSenseInterest(receiver1, true);
+		wire->setCarrierSenseInterest(receiver1, true);
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), w->getNumberOfCarrierSenseReceivers());
+		wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu, transmitter)), 0.1);
+		CPPUNIT_ASSERT_EQUAL(1, receiver1->cOnCopperBusy);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT_EQUAL(1, receiver1->cOnCopperFree);
+
+		// registered without interest
+		ReceiverMock receiver3(wns::service::dll::UnicastAddress(3));
+		wire->addReceiver(&receiver3, wns::service::dll::UnicastAddress(3), false);
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), w->getNumberOfCarrierSenseReceivers());
+		wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu2, transmitter)), 0.1);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT_EQUAL(0, receiver3.cOnCopperBusy);
+		CPPUNIT_ASSERT_EQUAL(0, receiver3.cOnCopperFree);
+		CPPUNIT_ASSERT( receiver3.pdu == pdu2 );
+
+		wire->setCarrierSenseInterest(&receiver3, true);
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), w->getNumberOfCarrierSenseReceivers());
+	}
+
+	void
+	WireTest::duplicateAddress()
+	{
+		Wire* w = dynamic_cast<Wire*>(wire);
+		ReceiverMock duplicate(wns::service::dll::UnicastAddress(1));
+		CPPUNIT_ASSERT_THROW(
+			wire->addReceiver(&duplicate, wns::service::dll::UnicastAddress(1), true),
+			wns::Exception);
+
+		// the rejected receiver is not registered
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), w->getNumberOfBroadcastSubscribers());
+		CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), w->getNumberOfCarrierSenseReceivers());
+
+		wns::osi::PDUPtr pdu(new wns::ldk::helper::FakePDU(100));
+		wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu, transmitter)), 0.1);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT( receiver1->pdu == pdu );
+		CPPUNIT_ASSERT_EQUAL(0, duplicate.cOnCopperBusy);
+		CPPUNIT_ASSERT_EQUAL(0, duplicate.cOnCopperFree);
+		CPPUNIT_ASSERT( duplicate.pdu == wns::osi::PDUPtr() );
+	}
+
+	void
+	WireTest::derivedReceiver()
+	{
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Receiver\n"
+				"from openwns.distribution import Fixed\n"
+				"receiver = Receiver(Fixed(0.0), 0.0, None)\n"
+				);
+		DerivedReceiver derived(config.get("receiver"), wire);
+		derived.setDLLUnicastAddress(wns::service::dll::UnicastAddress(3));
+
+		wns::osi::PDUPtr pdu(new wns::ldk::helper::FakePDU(100));
+		wire->sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu, transmitter)), 0.1);
+		wns::simulator::getEventScheduler()->processOneEvent();
+		CPPUNIT_ASSERT_EQUAL(1, derived.broadcasts);
+	}
+
+} // tests
+} // copper
@@ -0,0 +1,221 @@
+/*******************************************************************************
+ * This file is part of openWNS (open Wireless Network Simulator)
+ * _____________________________________________________________________________
+ *
+ * Copyright (C) 2004-2009
+ * Chair of Communication Networks (ComNets)
+ * Kopernikusstr. 5, D-52074 Aachen, Germany
+ * phone: ++49-241-80-27910,
+ * fax: ++49-241-80-22242
+ * email: info@openwns.org
+ * www: http://www.openwns.org
+ * _____________________________________________________________________________
+ *
+ * openWNS is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License version 2 as published by the
+ * Free Software Foundation;
+ *
+ * openWNS is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+
+#include <COPPER/WireTrace.hpp>
+#include <COPPER/Wire.hpp>
+#include <COPPER/tests/TransmitterDataSentMock.hpp>
+#include <COPPER/tests/ReceiverMock.hpp>
+
+#include <WNS/pyconfig/helper/Functions.hpp>
+#include <WNS/ldk/helper/FakePDU.hpp>
+#include <WNS/CppUnit.hpp>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <cstdio>
+
+namespace copper { namespace tests {
+
+	/**
+	 * @brief Test for copper::WireTrace and copper::WireTraceReader
+	 */
+	class WireTraceTest :
+		public wns::TestFixture
+	{
+		CPPUNIT_TEST_SUITE( WireTraceTest );
+		CPPUNIT_TEST( wireActivity );
+		CPPUNIT_TEST( ring );
+		CPPUNIT_TEST( segments );
+		CPPUNIT_TEST( disable );
+		CPPUNIT_TEST_SUITE_END();
+	public:
+		void prepare();
+		void cleanup();
+		void wireActivity();
+		void ring();
+		void segments();
+		void disable();
+
+	private:
+		TransmitterDataSentMock* transmitter;
+	};
+
+	CPPUNIT_TEST_SUITE_REGISTRATION( WireTraceTest );
+
+	void
+	WireTraceTest::prepare()
+	{
+		wns::simulator::getEventScheduler()->reset();
+		transmitter = new TransmitterDataSentMock();
+	}
+
+	void
+	WireTraceTest::cleanup()
+	{
+		delete transmitter;
+		std::remove("wireTraceTest.bin");
+		std::remove("wireTraceTest.bin.1");
+	}
+
+	void
+	WireTraceTest::wireActivity()
+	{
+		wns::pyconfig::View config =
+			wns::pyconfig::helper::createViewFromString(
+				"from copper.Copper import Wire, WireTrace\n"
+				"wire = Wire('tracedWire', trace = WireTrace('wireTraceTest.bin', capacity = 16))\n"
+				);
+
+		{
+			Wire wire(config.get<wns::pyconfig::View>("wire"));
+			ReceiverMock receiver(wns::service::dll::UnicastAddress(1));
+			wire.addReceiver(&receiver, wns::service::dll::UnicastAddress(1), true);
+
+			wns::osi::PDUPtr pdu1(new wns::ldk::helper::FakePDU(100));
+			wns::osi::PDUPtr pdu2(new wns::ldk::helper::FakePDU(200));
+			wire.sendData(
+				UnicastTransmissionPtr(new UnicastTransmission(wns::service::dll::UnicastAddress(1), pdu1, transmitter)),
+				0.1);
+			wire.sendData(BroadcastTransmissionPtr(new BroadcastTransmission(pdu2, transmitter)), 0.1);
+			wire.stopTransmission(pdu2);
+
+			// not recorded
+			wire.getTrace()->setEnabled(false);
+			wns::simulator::getEventScheduler()->processOneEvent();
+			CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(5), wire.getTrace()->getNumberOfRecords());
+		}
+
+		WireTraceReader reader("wireTraceTest.bin");
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(5), reader.size());
+
+		// start, start, collision (both), cancel
+		TraceRecord r;
+		CPPUNIT_ASSERT( reader.next(r) );
+		CPPUNIT_ASSERT_EQUAL(static_cast<int>(TraceRecord::UnicastStart), static_cast<int>(r.type));
+		CPPUNIT_ASSERT_EQUAL(0u, r.frame);
+		CPPUNIT_ASSERT_EQUAL(1, r.target);
+		CPPUNIT_ASSERT_EQUAL(100u, r.length);
+
+		CPPUNIT_ASSERT( reader.next(r) );
+		CPPUNIT_ASSERT_EQUAL(static_cast<int>(TraceRecord::BroadcastStart), static_cast<int>(r.type));
+		CPPUNIT_ASSERT_EQUAL(1u, r.frame);
+		CPPUNIT_ASSERT_EQUAL(-1, r.target);
+		CPPUNIT_ASSERT_EQUAL(0u, r.sender);
+
+		CPPUNIT_ASSERT( reader.next(r) );
+		CPPUNIT_ASSERT_EQUAL(static_cast<int>(TraceRecord::Collision), static_cast<int>(r.type));
+		CPPUNIT_ASSERT( reader.next(r) );
+		CPPUNIT_ASSERT_EQUAL(static_cast<int>(TraceRecord::Collision), static_cast<int>(r.type));
+		CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(r.collision));
+
+		CPPUNIT_ASSERT( reader.next(r) );
+		CPPUNIT_ASSERT_EQUAL(static_cast<int>(TraceRecord::Cancel), static_cast<int>(r.type));
+		CPPUNIT_ASSERT_EQUAL(1u, r.frame);
+
+		CPPUNIT_ASSERT( !reader.next(r) );
+	}
+
+	void
+	WireTraceTest::ring()
+	{
+		{
+			WireTrace trace("wireTraceTest.bin", 4, true);
+			for (int ii = 0; ii < 10; ++ii)
+			{
+				TransmissionPtr t(new BroadcastTransmission(
+					wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(ii)), transmitter));
+				trace.record(TraceRecord::BroadcastStart, 0, t, -1);
+			}
+		}
+
+		// the last 4 records remain
+		WireTraceReader reader("wireTraceTest.bin");
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(4), reader.size());
+
+		TraceRecord r;
+		for (uint32_t ii = 6; ii < 10; ++ii)
+		{
+			CPPUNIT_ASSERT( reader.next(r) );
+			CPPUNIT_ASSERT_EQUAL(ii, r.frame);
+		}
+		CPPUNIT_ASSERT( !reader.next(r) );
+	}
+
+	void
+	WireTraceTest::segments()
+	{
+		{
+			WireTrace trace("wireTraceTest.bin", 4, false);
+			for (int ii = 0; ii < 6; ++ii)
+			{
+				TransmissionPtr t(new BroadcastTransmission(
+					wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(ii)), transmitter));
+				trace.record(TraceRecord::BroadcastStart, 0, t, -1);
+			}
+			CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(6), trace.getNumberOfRecords());
+		}
+
+		WireTraceReader first("wireTraceTest.bin");
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(4), first.size());
+
+		WireTraceReader second(WireTrace::getSegmentFileName("wireTraceTest.bin", 1));
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(2), second.size());
+		CPPUNIT_ASSERT_EQUAL(1u, second.getHeader().segment);
+
+		TraceRecord r;
+		CPPUNIT_ASSERT( second.next(r) );
+		CPPUNIT_ASSERT_EQUAL(4u, r.frame);
+	}
+
+	void
+	WireTraceTest::disable()
+	{
+		{
+			WireTrace trace("wireTraceTest.bin", 4, true);
+			TransmissionPtr t(new BroadcastTransmission(
+				wns::osi::PDUPtr(new wns::ldk::helper::FakePDU(100)), transmitter));
+			trace.record(TraceRecord::BroadcastStart, 0, t, -1);
+
+			// the ongoing transmission is forgotten
+			trace.setEnabled(false);
+			trace.setEnabled(true);
+			trace.record(TraceRecord::End, 0, t, -1);
+		}
+
+		WireTraceReader reader("wireTraceTest.bin");
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(2), reader.size());
+
+		TraceRecord r;
+		CPPUNIT_ASSERT( reader.next(r) );
+		CPPUNIT_ASSERT_EQUAL(0u, r.frame);
+		CPPUNIT_ASSERT( reader.next(r) );
+		CPPUNIT_ASSERT_EQUAL(1u, r.frame);
+	}
+
+} // tests
+} // copper